@@ -0,0 +1,37 @@
+#pragma once
+#include <stdint.h>
+
+// ⏱️ Microbenchmarks for the portable hot paths
+//
+// A case runs its body iters times per call; the runner picks iters so one
+// sample takes ~20 ms and reports the median ns per iteration over several
+// samples. Each case checks its own output once before it is timed, so a
+// speedup that breaks the result fails the run instead of looking good.
+// The same cases build for the host ([env:native], bench_main.cpp) and for
+// the board ([env:xiao_esp32c3_bench], bench_device.cpp).
+
+typedef void (*BenchFn)(uint32_t iters);
+
+bool benchRegister(const char* name, BenchFn fn);
+
+// Record a wrong result; the run ends with a failure
+void benchFail(const char* name, const char* what);
+
+// Keep a result alive so the optimizer can't drop the work
+void benchKeep(uint32_t v);
+
+// Extra detail printed after the case's timing (memory, sizes)
+void benchNote(const char* name, const char* fmt, ...);
+
+#define BENCH(name)                                                        \
+  static void bench_##name(uint32_t iters);                                \
+  static bool benchRegistered_##name = benchRegister(#name, bench_##name); \
+  static void bench_##name(uint32_t iters)
+
+#define BENCH_CHECK(name, cond) \
+  do { if (!(cond)) benchFail(#name, #cond); } while (0)
+
+// 🏃 Entry points: time every case whose name contains filter (all when
+// null), in name order; returns the number of failed checks
+typedef void (*BenchReport)(const char* name, double ns, const char* note);
+uint32_t benchRunAll(const char* filter, BenchReport report);
@@ -0,0 +1,457 @@
+#include "bench.h"
+#include "corpus.h"
+#include "weather_parse.h"
+#include "json_stream.h"
+#include "forecast.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+// 📼 Every recorded response through every way of decoding it
+//
+//   dom      whole document, then readTempest/readLondon (what ships today
+//            for observations) or readForecast below
+//   filter   same, but deserializeJson drops every field we don't read
+//   stream   json_stream tokens straight into the result, no document:
+//            StreamDecoder for observations, forecast.cpp (what ships
+//            today) for the forecast
+//
+// The note has the bytes each decode needed. For the document strategies
+// that is the allocator's peak (ArduinoJson's blocks without the arena's
+// 8-byte headers, so add 8 per allocation before comparing with
+// JSON_ARENA_SIZE). For streaming it is the decoder struct, which lives on
+// the stack. Every strategy has to produce the same result as dom. A
+// document that doesn't fit the heap (the forecast on the board, say) is
+// noted as such rather than failed: that is the measurement.
+
+enum ParseStrategy : uint8_t {
+  PARSE_DOM = 0,
+  PARSE_FILTERED,
+  PARSE_STREAM,
+  PARSE_STRATEGY_COUNT
+};
+
+// 🧮 Heap-backed allocator that tracks live bytes, peak and heap calls
+class CountingAllocator : public ArduinoJson::Allocator {
+ public:
+  void reset() {
+    live = peak = 0;
+    calls = 0;
+  }
+
+  void* allocate(size_t size) override {
+    Header* h = (Header*)malloc(sizeof(Header) + size);
+    if (!h) return nullptr;
+    h->size = size;
+    track(0, size);
+    return h + 1;
+  }
+
+  void deallocate(void* ptr) override {
+    if (!ptr) return;
+    Header* h = (Header*)ptr - 1;
+    live -= h->size;
+    free(h);
+  }
+
+  void* reallocate(void* ptr, size_t newSize) override {
+    if (!ptr) return allocate(newSize);
+    Header* h = (Header*)ptr - 1;
+    size_t oldSize = h->size;
+    h = (Header*)realloc(h, sizeof(Header) + newSize);
+    if (!h) return nullptr;
+    h->size = newSize;
+    track(oldSize, newSize);
+    return h + 1;
+  }
+
+  size_t live = 0;
+  size_t peak = 0;
+  uint32_t calls = 0;
+
+ private:
+  union Header {
+    size_t size;
+    double align;
+  };
+
+  void track(size_t oldSize, size_t newSize) {
+    live = live - oldSize + newSize;
+    if (live > peak) peak = live;
+    calls++;
+  }
+};
+
+// 🗝️ The fields we read, per provider. Builds the filters and drives the
+// streaming decoder, so all three strategies agree on what matters
+enum ObsField : uint8_t {
+  FIELD_NONE = 0,
+  FIELD_TIMESTAMP,
+  FIELD_TEMP,
+  FIELD_PRESSURE,
+  FIELD_STATION_PRESSURE,
+  FIELD_HUMIDITY,
+  FIELD_WIND_AVG,
+  FIELD_WIND_GUST,
+  FIELD_WIND_DIR,
+  FIELD_RAIN,
+  FIELD_UV
+};
+
+struct KeyField {
+  const char* key;
+  uint8_t field;
+};
+
+static const KeyField TEMPEST_KEYS[] = {   // Inside obs[0]
+  { "timestamp", FIELD_TIMESTAMP },
+  { "air_temperature", FIELD_TEMP },
+  { "sea_level_pressure", FIELD_PRESSURE },
+  { "station_pressure", FIELD_STATION_PRESSURE },
+  { "relative_humidity", FIELD_HUMIDITY },
+  { "wind_avg", FIELD_WIND_AVG },
+  { "wind_gust", FIELD_WIND_GUST },
+  { "wind_direction", FIELD_WIND_DIR },
+  { "precip", FIELD_RAIN },
+  { "uv", FIELD_UV },
+};
+
+static const KeyField LONDON_MAIN[] = {
+  { "temp", FIELD_TEMP },
+  { "pressure", FIELD_PRESSURE },
+  { "humidity", FIELD_HUMIDITY },
+};
+static const KeyField LONDON_WIND[] = {
+  { "speed", FIELD_WIND_AVG },
+  { "gust", FIELD_WIND_GUST },
+  { "deg", FIELD_WIND_DIR },
+};
+static const KeyField LONDON_RAIN[] = {
+  { "1h", FIELD_RAIN },
+};
+
+struct KeySection {
+  const char* key;        // Top-level object holding the fields
+  const KeyField* fields;
+  uint8_t count;
+};
+
+#define SECTION(key, table) { key, table, sizeof(table) / sizeof(table[0]) }
+
+static const KeySection LONDON_SECTIONS[] = {
+  SECTION("main", LONDON_MAIN),
+  SECTION("wind", LONDON_WIND),
+  SECTION("rain", LONDON_RAIN),
+};
+static const uint8_t TEMPEST_KEY_COUNT = sizeof(TEMPEST_KEYS) / sizeof(TEMPEST_KEYS[0]);
+static const uint8_t LONDON_SECTION_COUNT = sizeof(LONDON_SECTIONS) / sizeof(LONDON_SECTIONS[0]);
+
+static uint8_t lookupField(const KeyField* fields, uint8_t count, const char* key) {
+  for (uint8_t i = 0; i < count; i++) {
+    if (strcmp(fields[i].key, key) == 0) return fields[i].field;
+  }
+  return FIELD_NONE;
+}
+
+// 🗓️ The better_forecast fields forecast.cpp keeps
+static const char* const FORECAST_HOUR_KEYS[] = {
+  "time", "air_temperature", "wind_avg", "precip_probability", "local_hour", "icon"
+};
+static const char* const FORECAST_DAY_KEYS[] = {
+  "day_start_local", "air_temp_high", "air_temp_low", "precip_probability", "icon"
+};
+
+// 🔍 Filter documents, built once from the key tables
+static JsonDocument tempestFilter;
+static JsonDocument londonFilter;
+static JsonDocument forecastFilter;
+
+static const JsonDocument& filterFor(CorpusProvider provider) {
+  if (tempestFilter.isNull()) {
+    for (const char* key : FORECAST_HOUR_KEYS) forecastFilter["forecast"]["hourly"][0][key] = true;
+    for (const char* key : FORECAST_DAY_KEYS) forecastFilter["forecast"]["daily"][0][key] = true;
+    for (uint8_t i = 0; i < TEMPEST_KEY_COUNT; i++) {
+      tempestFilter["obs"][0][TEMPEST_KEYS[i].key] = true;
+    }
+    londonFilter["dt"] = true;
+    for (uint8_t s = 0; s < LONDON_SECTION_COUNT; s++) {
+      const KeySection& sec = LONDON_SECTIONS[s];
+      for (uint8_t i = 0; i < sec.count; i++) londonFilter[sec.key][sec.fields[i].key] = true;
+    }
+  }
+  if (provider == CORPUS_FORECAST) return forecastFilter;
+  return provider == CORPUS_TEMPEST ? tempestFilter : londonFilter;
+}
+
+// Same clamping as forecast.cpp
+static uint8_t percent(float v) {
+  if (v < 0) return 0;
+  if (v > 100) return 100;
+  return (uint8_t)v;
+}
+
+// 🗓️ The document version of forecast.cpp: the first FORECAST_HOURS hours
+// and FORECAST_DAYS days
+static void readForecast(JsonVariantConst root, Forecast& out) {
+  out = {};
+  for (JsonVariantConst h : root["forecast"]["hourly"].as<JsonArrayConst>()) {
+    if (out.hourCount == FORECAST_HOURS) break;
+    ForecastHour& hour = out.hours[out.hourCount++];
+    hour.time = h["time"].as<uint32_t>();
+    hour.temp_f = h["air_temperature"].as<float>();
+    hour.wind_avg = h["wind_avg"].as<float>();
+    hour.precipPct = percent(h["precip_probability"].as<float>());
+    hour.localHour = h["local_hour"].as<uint8_t>();
+    hour.icon = forecastIconFromName(h["icon"] | "");
+  }
+  for (JsonVariantConst d : root["forecast"]["daily"].as<JsonArrayConst>()) {
+    if (out.dayCount == FORECAST_DAYS) break;
+    ForecastDay& day = out.days[out.dayCount++];
+    day.dayStart = d["day_start_local"].as<uint32_t>();
+    day.high_f = d["air_temp_high"].as<float>();
+    day.low_f = d["air_temp_low"].as<float>();
+    day.precipPct = percent(d["precip_probability"].as<float>());
+    day.icon = forecastIconFromName(d["icon"] | "");
+  }
+}
+
+// 🌊 Streaming decoder: the tokenizer plus which field the next number fills
+struct StreamDecoder {
+  JsonStream js;
+  WeatherObs* out;
+  CorpusProvider provider;
+  const KeySection* section;  // OpenWeather object we're inside
+  uint8_t field;              // ObsField for the value after the last key
+  uint8_t fieldDepth;
+  bool armed;                 // Tempest: saw the top-level "obs" key
+  bool inObs;                 // Tempest: inside obs[0]
+};
+
+// Same conversions as readTempest/readLondon, so the results compare exactly
+static void setField(StreamDecoder& d, double v) {
+  WeatherObs& o = *d.out;
+  bool tempest = d.provider == CORPUS_TEMPEST;
+  float f = (float)v;
+  switch (d.field) {
+    case FIELD_TIMESTAMP: o.timestamp = (uint32_t)v; break;
+    case FIELD_TEMP: o.temp_f = tempest ? (f * 9.0 / 5.0) + 32.0 : f; break;
+    case FIELD_PRESSURE: o.pressure_mb = f; break;
+    case FIELD_STATION_PRESSURE: o.station_pressure_mb = f; break;
+    case FIELD_HUMIDITY: o.humidity = f; break;
+    case FIELD_WIND_AVG: o.wind_avg = tempest ? f : f * 0.44704f; break;
+    case FIELD_WIND_GUST: o.wind_gust = tempest ? f : f * 0.44704f; break;
+    case FIELD_WIND_DIR: o.wind_dir = f; break;
+    case FIELD_RAIN: o.rain_mm = f; break;
+    case FIELD_UV: o.uv = f; break;
+  }
+}
+
+// {"obs": [{"timestamp": ..., ...}], ...}: obs at depth 1, its first
+// element at depth 2, fields at depth 3
+static bool onTempestToken(const JsonToken& tok, StreamDecoder& d) {
+  switch (tok.event) {
+    case JSON_KEY:
+      d.field = FIELD_NONE;
+      if (tok.depth == 1) d.armed = strcmp(tok.text, "obs") == 0;
+      if (tok.depth == 3 && d.inObs) {
+        d.field = lookupField(TEMPEST_KEYS, TEMPEST_KEY_COUNT, tok.text);
+        d.fieldDepth = 3;
+      }
+      return true;
+    case JSON_OBJECT_START:
+      if (tok.depth == 2 && d.armed) d.inObs = true;
+      return true;
+    case JSON_OBJECT_END:
+      return !(tok.depth == 2 && d.inObs);  // 🏁 Only the first obs matters
+    default:
+      return true;
+  }
+}
+
+// {"main": {"temp": ...}, "wind": {...}, "rain": {...}, "dt": ...}
+static bool onLondonToken(const JsonToken& tok, StreamDecoder& d) {
+  if (tok.event != JSON_KEY) return true;
+  d.field = FIELD_NONE;
+  if (tok.depth == 1) {
+    d.section = nullptr;
+    for (uint8_t s = 0; s < LONDON_SECTION_COUNT; s++) {
+      if (strcmp(LONDON_SECTIONS[s].key, tok.text) == 0) d.section = &LONDON_SECTIONS[s];
+    }
+    if (strcmp(tok.text, "dt") == 0) d.field = FIELD_TIMESTAMP;
+    d.fieldDepth = 1;
+  } else if (tok.depth == 2 && d.section) {
+    d.field = lookupField(d.section->fields, d.section->count, tok.text);
+    d.fieldDepth = 2;
+  }
+  return true;
+}
+
+static bool onStreamToken(const JsonToken& tok, void* ctx) {
+  StreamDecoder& d = *(StreamDecoder*)ctx;
+  if (tok.event == JSON_NUMBER && d.field != FIELD_NONE && tok.depth == d.fieldDepth) {
+    setField(d, tok.number);
+    d.field = FIELD_NONE;
+    return true;
+  }
+  return d.provider == CORPUS_TEMPEST ? onTempestToken(tok, d) : onLondonToken(tok, d);
+}
+
+static bool decodeStream(const CorpusPayload& p, WeatherObs& out) {
+  StreamDecoder d;
+  memset(&d, 0, sizeof(d));
+  d.out = &out;
+  d.provider = p.provider;
+  out.temp_f = out.pressure_mb = out.station_pressure_mb = out.humidity = 0;
+  out.wind_avg = out.wind_gust = out.wind_dir = out.rain_mm = out.uv = 0;
+  out.timestamp = 0;
+
+  jsonStreamBegin(d.js, onStreamToken, &d);
+  jsonStreamFeed(d.js, (const uint8_t*)p.json, p.len);
+  bool ok = !jsonStreamFailed(d.js) && (d.js.stopped || jsonStreamDone(d.js));
+  out.status = ok ? FETCH_OK : FETCH_JSON_ERROR;
+  return ok;
+}
+
+// 🎯 What one decode produced: an observation, or a forecast
+struct Decoded {
+  bool ok;
+  bool outOfMemory;     // deserializeJson() ran out of heap
+  WeatherObs obs;
+  Forecast forecast;
+};
+
+static void decode(ParseStrategy strategy, const CorpusPayload& p, Decoded& out,
+                   CountingAllocator& alloc) {
+  out.ok = out.outOfMemory = false;
+  if (strategy == PARSE_STREAM) {
+    if (p.provider == CORPUS_FORECAST) {
+      ForecastParser parser;
+      forecastParseBegin(parser, out.forecast);
+      forecastParseFeed(parser, (const uint8_t*)p.json, p.len);
+      out.ok = forecastParseOk(parser);
+    } else {
+      out.ok = decodeStream(p, out.obs);
+    }
+    return;
+  }
+
+  JsonDocument doc(&alloc);
+  DeserializationError error;
+  if (strategy == PARSE_FILTERED) {
+    JsonVariantConst filter = filterFor(p.provider).as<JsonVariantConst>();
+    error = deserializeJson(doc, p.json, p.len, DeserializationOption::Filter(filter));
+  } else {
+    error = deserializeJson(doc, p.json, p.len);
+  }
+  if (error) {
+    out.outOfMemory = error == DeserializationError::NoMemory;
+    return;
+  }
+  JsonVariantConst root = doc.as<JsonVariantConst>();
+  out.obs = {};
+  if (p.provider == CORPUS_FORECAST) readForecast(root, out.forecast);
+  else if (p.provider == CORPUS_TEMPEST) readTempest(root, out.obs);
+  else readLondon(root, out.obs);
+  out.ok = true;
+}
+
+static bool same(float a, float b) {
+  return fabsf(a - b) <= 1e-4f * fmaxf(1.0f, fabsf(a));
+}
+
+static bool sameObs(const WeatherObs& a, const WeatherObs& b) {
+  return a.status == b.status && a.timestamp == b.timestamp && same(a.temp_f, b.temp_f) &&
+         same(a.pressure_mb, b.pressure_mb) && same(a.station_pressure_mb, b.station_pressure_mb) &&
+         same(a.humidity, b.humidity) && same(a.wind_avg, b.wind_avg) &&
+         same(a.wind_gust, b.wind_gust) && same(a.wind_dir, b.wind_dir) &&
+         same(a.rain_mm, b.rain_mm) && same(a.uv, b.uv);
+}
+
+static bool sameForecast(const Forecast& a, const Forecast& b) {
+  if (a.hourCount != b.hourCount || a.dayCount != b.dayCount) return false;
+  for (uint8_t i = 0; i < a.hourCount; i++) {
+    const ForecastHour& x = a.hours[i];
+    const ForecastHour& y = b.hours[i];
+    if (x.time != y.time || !same(x.temp_f, y.temp_f) || !same(x.wind_avg, y.wind_avg) ||
+        x.precipPct != y.precipPct || x.localHour != y.localHour || x.icon != y.icon) return false;
+  }
+  for (uint8_t i = 0; i < a.dayCount; i++) {
+    const ForecastDay& x = a.days[i];
+    const ForecastDay& y = b.days[i];
+    if (x.dayStart != y.dayStart || !same(x.high_f, y.high_f) || !same(x.low_f, y.low_f) ||
+        x.precipPct != y.precipPct || x.icon != y.icon) return false;
+  }
+  return true;
+}
+
+// Plausible enough to be the reference the other strategies must match
+static bool plausible(CorpusProvider provider, const Decoded& d) {
+  if (!d.ok) return false;
+  if (provider == CORPUS_FORECAST) {
+    return d.forecast.hourCount == FORECAST_HOURS && d.forecast.dayCount == FORECAST_DAYS &&
+           d.forecast.hours[0].time && d.forecast.days[0].dayStart;
+  }
+  return d.obs.status == FETCH_OK && d.obs.timestamp >= 1700000000;
+}
+
+static CountingAllocator counting;
+static Decoded result;
+static Decoded expected;
+static uint32_t checked = 0;   // Bit per payload x strategy
+
+static void corpusBench(const char* name, const char* payload, ParseStrategy strategy,
+                        uint32_t iters) {
+  const CorpusPayload* p = corpusFind(payload);
+  if (!p) {
+    benchFail(name, "recording missing from the corpus");
+    return;
+  }
+
+  for (uint32_t i = 0; i < iters; i++) {
+    counting.reset();
+    decode(strategy, *p, result, counting);
+    benchKeep(result.obs.timestamp + result.forecast.hourCount);
+  }
+
+  uint32_t bit = 1u << ((p - &corpusAt(0)) * PARSE_STRATEGY_COUNT + strategy);
+  if (checked & bit) return;
+  checked |= bit;
+
+  if (result.outOfMemory) {
+    benchNote(name, "%6u B in, doesn't fit: out of memory at %u B, %u allocs", (unsigned)p->len,
+              (unsigned)counting.peak, (unsigned)counting.calls);
+    return;
+  }
+  size_t peak = strategy != PARSE_STREAM            ? counting.peak
+                : p->provider == CORPUS_FORECAST    ? sizeof(ForecastParser)
+                                                    : sizeof(StreamDecoder);
+  benchNote(name, "%6u B in, %6u B peak, %4u allocs", (unsigned)p->len, (unsigned)peak,
+            (unsigned)counting.calls);
+
+  // The dom decode is the reference; the stream one where dom doesn't fit
+  CountingAllocator scratch;
+  decode(PARSE_DOM, *p, expected, scratch);
+  if (expected.outOfMemory) decode(PARSE_STREAM, *p, expected, scratch);
+  if (!plausible(p->provider, expected)) {
+    benchFail(name, "reference decode of the recording failed");
+    return;
+  }
+  bool match = p->provider == CORPUS_FORECAST ? sameForecast(result.forecast, expected.forecast)
+                                              : sameObs(result.obs, expected.obs);
+  if (!result.ok || !match) benchFail(name, "result differs from the reference decode");
+}
+
+#define CORPUS_BENCHES(payload)                                                   \
+  BENCH(corpus_##payload##_dom) {                                                 \
+    corpusBench("corpus_" #payload "_dom", #payload, PARSE_DOM, iters);           \
+  }                                                                               \
+  BENCH(corpus_##payload##_filter) {                                              \
+    corpusBench("corpus_" #payload "_filter", #payload, PARSE_FILTERED, iters);   \
+  }                                                                               \
+  BENCH(corpus_##payload##_stream) {                                              \
+    corpusBench("corpus_" #payload "_stream", #payload, PARSE_STREAM, iters);     \
+  }
+
+CORPUS_BENCHES(tempest_obs)
+CORPUS_BENCHES(openweather)
+CORPUS_BENCHES(better_forecast)
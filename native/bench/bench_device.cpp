@@ -0,0 +1,27 @@
+#include "bench.h"
+#include <Arduino.h>
+
+// 📟 Board entry point: run every case once after boot and print the table
+// over serial. Same cases and checks as the host run; no baseline files,
+// so keep the host's --compare for regressions and read these for the
+// device's absolute numbers.
+
+static void printCase(const char* name, double ns, const char* note) {
+  Serial.printf("%-32s %12.1f %14.0f   %s\n", name, ns, 1e9 / ns, note);
+  delay(1);  // Let the idle task run between cases (task watchdog)
+}
+
+void setup() {
+  Serial.begin(115200);
+  delay(2000);  // USB CDC needs a moment before the first lines show up
+
+  Serial.printf("⏱️ %u MHz, %u bytes free heap\n", (unsigned)getCpuFrequencyMhz(),
+                (unsigned)ESP.getFreeHeap());
+  Serial.printf("%-32s %12s %14s\n", "case", "ns/op", "ops/s");
+  uint32_t failures = benchRunAll(nullptr, printCase);
+  Serial.printf(failures ? "❌ %u failed checks\n" : "✅ All checks passed\n", (unsigned)failures);
+}
+
+void loop() {
+  delay(1000);
+}
@@ -0,0 +1,47 @@
+#include "bench.h"
+#include "text_format.h"
+#include <Arduino.h>
+
+// 🔤 Display strings: the allocation-free formatters against the String
+// expressions they replaced
+
+static float temps[64];
+
+static void fillTemps() {
+  for (uint8_t i = 0; i < 64; i++) temps[i] = 40.0f + i * 0.731f;
+}
+
+BENCH(format_temperature) {
+  fillTemps();
+  char text[16];
+  for (uint32_t i = 0; i < iters; i++) benchKeep(formatTemperature(text, sizeof(text), temps[i & 63]));
+  formatTemperature(text, sizeof(text), 72.45f);
+  BENCH_CHECK(format_temperature, strcmp(text, "72.5 F") == 0 || strcmp(text, "72.4 F") == 0);
+  formatTemperature(text, sizeof(text), -0.04f);
+  BENCH_CHECK(format_temperature, strcmp(text, "0.0 F") == 0);
+}
+
+BENCH(format_temperature_string_legacy) {
+  fillTemps();
+  for (uint32_t i = 0; i < iters; i++) {
+    String text = String(temps[i & 63], 1) + " F";
+    benchKeep(text.length());
+  }
+}
+
+BENCH(format_wind_direction) {
+  char text[16];
+  for (uint32_t i = 0; i < iters; i++) {
+    size_t n = formatText(text, sizeof(text), "m/s ");
+    benchKeep(n + formatText(text + n, sizeof(text) - n, windDirFromDegrees(i % 360)));
+  }
+  BENCH_CHECK(format_wind_direction, strcmp(windDirFromDegrees(-10), "N") == 0);
+  BENCH_CHECK(format_wind_direction, strcmp(windDirFromDegrees(202.5f), "SSW") == 0);
+}
+
+BENCH(format_clock) {
+  char text[12];
+  for (uint32_t i = 0; i < iters; i++) benchKeep(formatClock(text, sizeof(text), 1700000000 + i * 61, -28800));
+  formatClock(text, sizeof(text), 1700000000, -28800);
+  BENCH_CHECK(format_clock, strcmp(text, "2:13p") == 0);
+}
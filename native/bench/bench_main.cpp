@@ -0,0 +1,75 @@
+#include "bench.h"
+#include <Arduino.h>
+
+// 🖥️ Host entry point: print every case, optionally save or compare a baseline
+//
+//   program [--filter text] [--save file | --compare file] [--tolerance pct]
+//
+// A baseline is "name ns" per line. --compare fails the run when a case is
+// more than tolerance percent slower than its baseline (default 25), so a
+// regression shows up on the same box that recorded the baseline.
+
+// `pio test -e native` builds src (and so this runner) into each Unity
+// suite, which brings its own main()
+#ifndef PIO_UNIT_TESTING
+
+static const char* comparePath = nullptr;
+static double tolerance = 25;
+static FILE* save = nullptr;
+static uint32_t regressions = 0;
+
+static bool loadBaseline(const char* path, const char* name, double& ns) {
+  FILE* f = fopen(path, "r");
+  if (!f) return false;
+  char line[160];
+  bool found = false;
+  while (!found && fgets(line, sizeof(line), f)) {
+    char key[128];
+    double v;
+    if (sscanf(line, "%127s %lf", key, &v) == 2 && strcmp(key, name) == 0) {
+      ns = v;
+      found = true;
+    }
+  }
+  fclose(f);
+  return found;
+}
+
+static void printCase(const char* name, double ns, const char* note) {
+  printf("%-32s %12.1f %14.0f", name, ns, 1e9 / ns);
+
+  double base;
+  if (comparePath && loadBaseline(comparePath, name, base)) {
+    double change = (ns - base) * 100.0 / base;
+    bool slower = change > tolerance;
+    if (slower) regressions++;
+    printf("   %+6.1f%%%s", change, slower ? "  ⚠️ regression" : "");
+  }
+  if (*note) printf("   %s", note);
+  printf("\n");
+  if (save) fprintf(save, "%s %.1f\n", name, ns);
+}
+
+int main(int argc, char** argv) {
+  const char* filter = nullptr;
+  const char* savePath = nullptr;
+  for (int i = 1; i + 1 < argc; i += 2) {
+    if (!strcmp(argv[i], "--filter")) filter = argv[i + 1];
+    else if (!strcmp(argv[i], "--save")) savePath = argv[i + 1];
+    else if (!strcmp(argv[i], "--compare")) comparePath = argv[i + 1];
+    else if (!strcmp(argv[i], "--tolerance")) tolerance = atof(argv[i + 1]);
+  }
+
+  save = savePath ? fopen(savePath, "w") : nullptr;
+  printf("%-32s %12s %14s\n", "case", "ns/op", "ops/s");
+  uint32_t failures = benchRunAll(filter, printCase);
+  if (save) fclose(save);
+
+  if (failures || regressions) {
+    printf("\n%u failed checks, %u regressions\n", (unsigned)failures, (unsigned)regressions);
+    return 1;
+  }
+  return 0;
+}
+
+#endif  // PIO_UNIT_TESTING
@@ -0,0 +1,25 @@
+#include "bench.h"
+#include "metrics.h"
+
+// 📈 One whole /metrics body through the cursor, a socket buffer at a time,
+// with every stage populated so each histogram is written out
+
+BENCH(metrics_render) {
+  perfReset();
+  for (uint8_t s = 0; s < PERF_STAGE_COUNT; s++) {
+    for (uint32_t us = 100; us < 5000000; us += us / 3) perfRecord(s, us);
+  }
+  perfCount(PERF_COUNT_REQUESTS, 12);
+
+  static char buf[1024];
+  size_t total = 0;
+  for (uint32_t i = 0; i < iters; i++) {
+    MetricsCursor c;
+    metricsRenderBegin(c, nullptr);
+    total = 0;
+    while (size_t n = metricsRender(c, buf, sizeof(buf))) total += n;
+  }
+  benchKeep(total);
+  BENCH_CHECK(metrics_render, total > 8000 && total < 20000);
+  perfReset();
+}
@@ -0,0 +1,89 @@
+#include "bench.h"
+#include "obs_log.h"
+#include <Arduino.h>
+#include <LittleFS.h>
+
+// 📜 The observation log through LittleFS: a file-backed shim on the host
+// (native/shims/LittleFS.h), the real flash partition on the board. One
+// reading a minute, so 1440 records make the 24 h the history screen reads.
+
+static bool logOpen = false;
+static uint32_t nextTs = 1700000000;
+
+// Starts from an empty log so the checks know what's in it; on the board
+// that wipes the bench unit's own log
+static bool openLog() {
+  if (logOpen) return true;
+  if (!LittleFS.begin(true)) return false;
+  File dir = LittleFS.open("/obslog");
+  File f;
+  while ((f = dir.openNextFile())) {
+    char path[64];
+    snprintf(path, sizeof(path), "%s", f.path());
+    f.close();
+    LittleFS.remove(path);
+  }
+  dir.close();
+  logOpen = obsLogBegin();
+  return logOpen;
+}
+
+static WeatherObs obsAt(uint32_t ts) {
+  WeatherObs obs = {};
+  obs.status = FETCH_OK;
+  obs.timestamp = ts;
+  obs.temp_f = 60.0f + (ts / 60 % 97) * 0.1f;
+  return obs;
+}
+
+static void appendMinutes(uint32_t n) {
+  for (uint32_t i = 0; i < n; i++) {
+    obsLogAppend(obsAt(nextTs));
+    nextTs += 60;
+  }
+}
+
+static bool countRecord(const ObsRecord& rec, void* ctx) {
+  (*(uint32_t*)ctx)++;
+  return rec.timestamp != 0;
+}
+
+// Batches of BATCH_RECORDS reach the file in one append; segments roll
+// over and the oldest is dropped once the log is full
+BENCH(obs_log_append) {
+  if (!openLog()) {
+    benchFail("obs_log_append", "obsLogBegin()");
+    return;
+  }
+  unsigned long start = micros();
+  appendMinutes(iters);
+  unsigned long took = micros() - start;
+  obsLogFlush();
+
+  ObsRecord last;
+  BENCH_CHECK(obs_log_append, obsLogLatest(0, last) && last.timestamp == nextTs - 60);
+  if (took > 0) benchNote("obs_log_append", "%8.0f records/s", iters * 1e6 / took);
+}
+
+BENCH(obs_log_range_24h) {
+  if (!openLog()) {
+    benchFail("obs_log_range_24h", "obsLogBegin()");
+    return;
+  }
+  static bool filled = false;
+  if (!filled) {
+    appendMinutes(1440);
+    obsLogFlush();
+    filled = true;
+  }
+  uint32_t to = nextTs - 60;
+  uint32_t from = to - 86400 + 60;
+
+  uint32_t visited = 0;
+  unsigned long start = micros();
+  for (uint32_t i = 0; i < iters; i++) obsLogRange(from, to, 0, countRecord, &visited);
+  unsigned long took = micros() - start;
+
+  BENCH_CHECK(obs_log_range_24h, visited == iters * 1440);
+  if (took > 0) benchNote("obs_log_range_24h", "%8.0f records/s", visited * 1e6 / took);
+}
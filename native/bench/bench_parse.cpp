@@ -0,0 +1,53 @@
+#include "bench.h"
+#include "backfill.h"
+#include "tempest_udp.h"
+#include <stdio.h>
+#include <string.h>
+
+// 📡 Tempest UDP broadcast
+static const char strikeUdp[] =
+  "{\"serial_number\":\"ST-00000512\",\"type\":\"evt_strike\",\"hub_sn\":\"HB-00013030\","
+  "\"evt\":[1493322445,27,3848]}";
+
+BENCH(parse_udp_strike) {
+  TempestEvent ev = {};
+  for (uint32_t i = 0; i < iters; i++) {
+    parseTempestUdp((const uint8_t*)strikeUdp, sizeof(strikeUdp) - 1, ev);
+    benchKeep(ev.energy);
+  }
+  BENCH_CHECK(parse_udp_strike, ev.type == EVENT_STRIKE && ev.distanceKm == 27 && ev.energy == 3848);
+}
+
+// ⏮️ 60 obs_st rows through the streaming backfill decoder, 512-byte chunks
+static char rowsJson[8192];
+static size_t rowsLen = 0;
+
+static bool countRow(const HistorySample&, void* ctx) {
+  (*(uint32_t*)ctx)++;
+  return true;
+}
+
+BENCH(parse_backfill_60_rows) {
+  if (!rowsLen) {
+    size_t n = snprintf(rowsJson, sizeof(rowsJson), "{\"status\":{\"status_code\":0},\"obs\":[");
+    for (int r = 0; r < 60; r++) {
+      n += snprintf(rowsJson + n, sizeof(rowsJson) - n,
+                    "%s[%d,0.4,2.1,3.4,265,3,1003.2,21.3,64,49432,3.1,412,0.0,0,0,0,2.6,1]",
+                    r ? "," : "", 1700000000 + r * 60);
+    }
+    rowsLen = n + snprintf(rowsJson + n, sizeof(rowsJson) - n, "]}");
+  }
+
+  uint32_t rows = 0;
+  for (uint32_t i = 0; i < iters; i++) {
+    ObsRowParser p;
+    rows = 0;
+    obsRowsBegin(p, 14.4f, countRow, &rows);
+    for (size_t at = 0; at < rowsLen; at += 512) {
+      size_t len = rowsLen - at < 512 ? rowsLen - at : 512;
+      if (!obsRowsFeed(p, (const uint8_t*)rowsJson + at, len)) break;
+    }
+    benchKeep(rows);
+  }
+  BENCH_CHECK(parse_backfill_60_rows, rows == 60);
+}
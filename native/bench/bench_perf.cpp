@@ -0,0 +1,27 @@
+#include "bench.h"
+#include "perf.h"
+
+// ⏱️ Tracepoint cost: a record sits on every stage of every refresh, a
+// percentile query behind the hourly report (and anything scraping it)
+
+BENCH(perf_record) {
+  perfReset();
+  for (uint32_t i = 0; i < iters; i++) perfRecord(PERF_PARSE, (i * 2654435761u) >> 12);
+  PerfSummary s;
+  BENCH_CHECK(perf_record, perfSummary(PERF_PARSE, s) && s.count == iters);
+  perfReset();
+}
+
+BENCH(perf_percentile) {
+  perfReset();
+  for (uint32_t us = 1; us <= 1000; us++) perfRecord(PERF_FETCH, us);
+  for (uint32_t i = 0; i < iters; i++) benchKeep(perfPercentile(PERF_FETCH, 99));
+
+  // The answer is the top of the bucket holding the rank: at most 25% high
+  uint32_t p50 = perfPercentile(PERF_FETCH, 50);
+  uint32_t p99 = perfPercentile(PERF_FETCH, 99);
+  BENCH_CHECK(perf_percentile, p50 >= 500 && p50 <= 625);
+  BENCH_CHECK(perf_percentile, p99 >= 990 && p99 <= 1000);   // Clamped to the max
+  BENCH_CHECK(perf_percentile, perfPercentile(PERF_FETCH, 0) == 1);
+  perfReset();
+}
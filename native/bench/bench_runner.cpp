@@ -0,0 +1,82 @@
+#include "bench.h"
+#include <Arduino.h>
+#include <stdarg.h>
+#include <algorithm>
+
+struct BenchCase {
+  const char* name;
+  BenchFn fn;
+  char note[64];
+};
+
+static const uint8_t MAX_CASES = 64;
+static const uint8_t SAMPLES = 7;
+static const unsigned long SAMPLE_TARGET_US = 20000;
+
+static BenchCase cases[MAX_CASES];
+static uint8_t caseCount = 0;
+static uint32_t failures = 0;
+static volatile uint32_t keepSink = 0;
+
+bool benchRegister(const char* name, BenchFn fn) {
+  if (caseCount == MAX_CASES) return false;
+  cases[caseCount++] = { name, fn, "" };
+  return true;
+}
+
+void benchFail(const char* name, const char* what) {
+  Serial.printf("❌ %s: check failed: %s\n", name, what);
+  failures++;
+}
+
+void benchKeep(uint32_t v) {
+  keepSink += v;
+}
+
+void benchNote(const char* name, const char* fmt, ...) {
+  for (uint8_t i = 0; i < caseCount; i++) {
+    if (strcmp(cases[i].name, name) != 0) continue;
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(cases[i].note, sizeof(cases[i].note), fmt, args);
+    va_end(args);
+    return;
+  }
+}
+
+static double timeCase(BenchFn fn) {
+  fn(1);  // Warm caches and run the case's own checks
+  uint32_t iters = 1;
+  for (;;) {
+    unsigned long start = micros();
+    fn(iters);
+    unsigned long took = micros() - start;
+    if (took >= SAMPLE_TARGET_US / 4 || iters >= (1u << 30)) {
+      if (took > 0) iters = std::max<uint64_t>(1, (uint64_t)iters * SAMPLE_TARGET_US / took);
+      break;
+    }
+    iters *= 4;
+  }
+
+  double samples[SAMPLES];
+  for (uint8_t i = 0; i < SAMPLES; i++) {
+    unsigned long start = micros();
+    fn(iters);
+    samples[i] = (micros() - start) * 1000.0 / iters;
+  }
+  std::sort(samples, samples + SAMPLES);
+  return samples[SAMPLES / 2];
+}
+
+uint32_t benchRunAll(const char* filter, BenchReport report) {
+  std::sort(cases, cases + caseCount,
+            [](const BenchCase& a, const BenchCase& b) { return strcmp(a.name, b.name) < 0; });
+  failures = 0;
+  for (uint8_t i = 0; i < caseCount; i++) {
+    BenchCase& c = cases[i];
+    if (filter && !strstr(c.name, filter)) continue;
+    double ns = timeCase(c.fn);
+    report(c.name, ns, c.note);
+  }
+  return failures;
+}
@@ -0,0 +1,75 @@
+#include "bench.h"
+#include "sleep_cycle.h"
+#include "history.h"
+#include "stats.h"
+#include "rotate_blit.h"
+#include <string.h>
+
+// 🗓️ Per-reading bookkeeping and per-frame work: what runs every minute or
+// every gauge frame on the device
+
+static HistorySample sampleAt(uint32_t i) {
+  HistorySample s;
+  s.timestamp = 1700000000 + i * 60;
+  s.temp_f = 60.0f + (i % 97) * 0.1f;
+  s.pressure_mb = 1013.0f + (i % 13) * 0.1f;
+  s.humidity = 60 + i % 7;
+  s.wind_avg = 2.0f + (i % 11) * 0.1f;
+  s.wind_gust = 3.0f + (i % 17) * 0.1f;
+  s.wind_dir = (i * 7) % 360;
+  s.rain_mm = i % 50 ? 0 : 0.2f;
+  s.uv = 3.1f;
+  return s;
+}
+
+BENCH(schedule_sleep_cycle) {
+  static const SleepCycleConfig cfg = { 3, 60000, 15000, 15 * 60000 };
+  SleepCycle c = {};
+  cycleWake(c, WAKE_COLD);
+  uint32_t sleepMs = 0;
+  for (uint32_t i = 0; i < iters; i++) {
+    cycleWake(c, WAKE_TIMER);
+    CycleOutcome outcome = i % 5 == 4 ? OUTCOME_FAILED : OUTCOME_FRESH;
+    sleepMs = cycleFinish(c, outcome, cycleShouldRender(c, outcome), cfg);
+    benchKeep(sleepMs);
+  }
+  BENCH_CHECK(schedule_sleep_cycle, sleepMs > 0);
+}
+
+BENCH(history_append) {
+  historyClear();
+  for (uint32_t i = 0; i < iters; i++) benchKeep(historyAppend(sampleAt(i)));
+  BENCH_CHECK(history_append, historyCount() > 0);
+}
+
+BENCH(stats_add_and_query) {
+  statsClear();
+  StatSummary s = {};
+  for (uint32_t i = 0; i < iters; i++) {
+    HistorySample sample = sampleAt(i);
+    statsAdd(sample);
+    statsQuery(STAT_TEMP, WINDOW_24H, sample.timestamp, s);
+    benchKeep(s.samples);
+  }
+  BENCH_CHECK(stats_add_and_query, s.samples > 0 && s.min <= s.max);
+}
+
+// 🧭 One gauge frame: the needle blitted into a dial-sized tile
+BENCH(rotate_blit_needle) {
+  static uint16_t needle[16 * 58];
+  static uint16_t tile[96 * 96];
+  for (uint16_t i = 0; i < 16 * 58; i++) needle[i] = (i % 16 >= 6 && i % 16 <= 9) ? 0x001F : 0xF81F;
+  BlitSource src = { needle, 16, 58, 8, 100, 0xF81F };
+
+  uint32_t drawn = 0;
+  for (uint32_t i = 0; i < iters; i++) {
+    uint16_t angle = (uint16_t)(i * 2731);
+    BlitRect box = rotatedBounds(src, 120, 120, angle);
+    BlitRect area = { box.x, box.y, (int16_t)(box.w < 96 ? box.w : 96), (int16_t)(box.h < 96 ? box.h : 96) };
+    memset(tile, 0xFF, area.w * area.h * sizeof(uint16_t));
+    rotateBlit(tile, area, src, 120, 120, angle);
+    drawn = tile[(area.h / 2) * area.w + area.w / 2];
+    benchKeep(drawn);
+  }
+  BENCH_CHECK(rotate_blit_needle, rotatedBounds(src, 120, 120, 0).w > 0);
+}
@@ -0,0 +1,32 @@
+#include "bench.h"
+#include "trace.h"
+
+// 🧵 A tracepoint sits on every network stage and frame; the dump runs on
+// demand but walks the whole ring
+
+BENCH(trace_record) {
+  traceClear();
+  for (uint32_t i = 0; i < iters; i++) traceRecord(TRACE_ASYNC_BEGIN, TRACE_WAIT, i & 3);
+  BENCH_CHECK(trace_record, traceCount() == (iters < TRACE_EVENTS ? iters : TRACE_EVENTS));
+  traceClear();
+}
+
+BENCH(trace_dump) {
+  traceClear();
+  for (uint16_t i = 1; i < TRACE_EVENTS; i++) traceRecord(i & 1 ? TRACE_BEGIN : TRACE_END, TRACE_FRAME);
+
+  static char buf[1024];
+  size_t total = 0;
+  for (uint32_t i = 0; i < iters; i++) {
+    TraceCursor c;
+    traceDumpBegin(c);
+    total = 0;
+    while (size_t n = traceDump(c, buf, sizeof(buf))) total += n;
+  }
+  benchKeep(total);
+  // 16 hex digits an event, 8 to a line, plus the tables
+  BENCH_CHECK(trace_dump, total > TRACE_EVENTS * 16u && total < TRACE_EVENTS * 18u + 1024);
+  traceRecord(TRACE_END, TRACE_FRAME);   // Recording resumed once the dump ended
+  BENCH_CHECK(trace_dump, traceCount() == TRACE_EVENTS && traceDropped() == 0);
+  traceClear();
+}
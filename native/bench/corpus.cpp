@@ -0,0 +1,126 @@
+#include "corpus.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// 🗂️ The recordings, in the order the cases list them
+static const struct {
+  const char* file;
+  CorpusProvider provider;
+} RECORDINGS[] = {
+  { "tempest_obs.json", CORPUS_TEMPEST },
+  { "openweather.json", CORPUS_OPENWEATHER },
+  { "better_forecast.json", CORPUS_FORECAST },
+};
+static const uint8_t RECORDING_COUNT = sizeof(RECORDINGS) / sizeof(RECORDINGS[0]);
+
+static CorpusPayload payloads[RECORDING_COUNT];
+static char names[RECORDING_COUNT][32];
+static bool loaded = false;
+
+#ifdef ARDUINO
+// 📟 Linked into the bench firmware; embed_txtfiles adds a trailing NUL
+#define EMBEDDED(sym)                                                   \
+  extern const char sym##_start[] asm("_binary_native_mock_api_responses_" #sym "_start"); \
+  extern const char sym##_end[] asm("_binary_native_mock_api_responses_" #sym "_end");
+EMBEDDED(tempest_obs_json)
+EMBEDDED(openweather_json)
+EMBEDDED(better_forecast_json)
+
+static const char* const embeddedStart[RECORDING_COUNT] = {
+  tempest_obs_json_start, openweather_json_start, better_forecast_json_start
+};
+static const char* const embeddedEnd[RECORDING_COUNT] = {
+  tempest_obs_json_end, openweather_json_end, better_forecast_json_end
+};
+#endif
+
+// Drops whitespace outside strings in place; returns the new length
+static size_t compact(char* json, size_t len) {
+  size_t out = 0;
+  bool inString = false;
+  for (size_t i = 0; i < len; i++) {
+    char c = json[i];
+    if (inString) {
+      if (c == '\\' && i + 1 < len) {
+        json[out++] = c;
+        c = json[++i];
+      } else if (c == '"') {
+        inString = false;
+      }
+    } else if (c == '"') {
+      inString = true;
+    } else if (c == ' ' || c == '\n' || c == '\r' || c == '\t') {
+      continue;
+    }
+    json[out++] = c;
+  }
+  json[out] = '\0';
+  return out;
+}
+
+// Whole recording into a malloc()ed buffer with room for the NUL
+static char* readRecording(uint8_t i, size_t& len) {
+#ifdef ARDUINO
+  len = embeddedEnd[i] - embeddedStart[i] - 1;
+  char* buf = (char*)malloc(len + 1);
+  if (buf) memcpy(buf, embeddedStart[i], len);
+  return buf;
+#else
+  const char* dir = getenv("CORPUS_DIR");
+  char path[256];
+  snprintf(path, sizeof(path), "%s/%s", dir && *dir ? dir : "native/mock_api/responses", RECORDINGS[i].file);
+  FILE* f = fopen(path, "rb");
+  if (!f) {
+    printf("❌ Can't open %s\n", path);
+    return nullptr;
+  }
+  fseek(f, 0, SEEK_END);
+  len = ftell(f);
+  fseek(f, 0, SEEK_SET);
+  char* buf = (char*)malloc(len + 1);
+  if (buf && fread(buf, 1, len, f) != len) {
+    free(buf);
+    buf = nullptr;
+  }
+  fclose(f);
+  return buf;
+#endif
+}
+
+static void load() {
+  if (loaded) return;
+  loaded = true;
+  for (uint8_t i = 0; i < RECORDING_COUNT; i++) {
+    CorpusPayload& p = payloads[i];
+    snprintf(names[i], sizeof(names[i]), "%s", RECORDINGS[i].file);
+    char* dot = strrchr(names[i], '.');
+    if (dot) *dot = '\0';
+    p.name = names[i];
+    p.provider = RECORDINGS[i].provider;
+
+    size_t len = 0;
+    char* json = readRecording(i, len);
+    if (!json) continue;
+    p.len = compact(json, len);
+    p.json = json;
+  }
+}
+
+uint8_t corpusCount() {
+  load();
+  return RECORDING_COUNT;
+}
+
+const CorpusPayload& corpusAt(uint8_t i) {
+  load();
+  return payloads[i];
+}
+
+const CorpusPayload* corpusFind(const char* name) {
+  load();
+  for (uint8_t i = 0; i < RECORDING_COUNT; i++) {
+    if (strcmp(payloads[i].name, name) == 0) return payloads[i].json ? &payloads[i] : nullptr;
+  }
+  return nullptr;
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+// 📼 Recorded provider responses for the parse benchmarks and the soak
+//
+// The corpus is the mock API's recorded responses (native/mock_api/responses),
+// so the benchmarks parse what the firmware actually receives. Whitespace
+// outside strings is dropped on load, as mock_api.py serves them. On the
+// host the files are read from CORPUS_DIR (that directory, relative to the
+// project root, unless the environment says otherwise); the bench firmware
+// links them in with board_build.embed_txtfiles. A new recording needs a
+// file there, a line in corpus.cpp's table (and platformio.ini's embed
+// list) and a CORPUS_BENCHES line in bench_corpus.cpp.
+
+enum CorpusProvider : uint8_t {
+  CORPUS_TEMPEST = 0,     // /observations/station/<id>
+  CORPUS_OPENWEATHER,     // /data/2.5/weather, imperial units
+  CORPUS_FORECAST         // /better_forecast
+};
+
+struct CorpusPayload {
+  const char* name;       // File name without .json; the bench case's middle part
+  CorpusProvider provider;
+  const char* json;       // Null when the recording couldn't be loaded
+  size_t len;
+};
+
+// Loaded on first call
+uint8_t corpusCount();
+const CorpusPayload& corpusAt(uint8_t i);
+const CorpusPayload* corpusFind(const char* name);   // Null if missing or not loaded
@@ -0,0 +1,412 @@
+#include <Arduino.h>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <string>
+#include <map>
+#include <set>
+#include <ctype.h>
+#include <sys/socket.h>
+#include <sys/select.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include "dns_cache.h"
+#include "async_http.h"
+
+// 🧭 The DNS cache against a stub resolver on this machine
+//
+//   program [--verbose]
+//
+// A resolver on 127.0.0.1 answers from a table the checks rewrite as they
+// go: an A record with a given TTL, a CNAME chain, SERVFAIL, NXDOMAIN,
+// NODATA, a dropped query, or forged replies (wrong ID, wrong question)
+// ahead of the real one. The checks walk dns_cache.cpp through hits,
+// misses, TTL expiry, serve-stale, eviction and the stats, counting what
+// actually reached the resolver and from which ID and port, then fetch
+// from a local HTTP listener by name through async_http. Runs
+// in under ten seconds of real time (TTLs are whole seconds); exits
+// non-zero if any check failed.
+
+enum StubMode : uint8_t {
+  STUB_ANSWER = 0,
+  STUB_CNAME,        // CNAME with cnameTtl, then the A record
+  STUB_SERVFAIL,
+  STUB_NXDOMAIN,
+  STUB_DROP,         // Never answers
+  STUB_WRONG_ID,     // A reply with another ID first, then the answer
+  STUB_NODATA,       // No error, no answers: the name has no A record
+  STUB_WRONG_QUESTION  // Replies for another name, type and class first, then
+                       // the answer with the name in upper case
+};
+
+struct StubRecord {
+  StubMode mode;
+  uint32_t addr;     // Host byte order
+  uint32_t ttl;
+  uint32_t cnameTtl;
+};
+
+static std::mutex stubLock;
+static std::map<std::string, StubRecord> stubTable;
+static std::atomic<uint32_t> stubQueries(0);
+static std::set<uint16_t> stubIds;       // Under stubLock
+static std::set<uint16_t> stubPorts;
+static std::atomic<bool> stopping(false);
+static bool verbose = false;
+
+static void setRecord(const char* host, StubMode mode, const char* ip = "10.0.0.1",
+                      uint32_t ttl = 60, uint32_t cnameTtl = 0) {
+  std::lock_guard<std::mutex> lock(stubLock);
+  stubTable[host] = { mode, ntohl(inet_addr(ip)), ttl, cnameTtl };
+}
+
+static void put16(uint8_t* p, uint16_t v) { p[0] = v >> 8; p[1] = v & 0xFF; }
+static void put32(uint8_t* p, uint32_t v) { put16(p, v >> 16); put16(p + 2, v & 0xFFFF); }
+
+// Question name as dotted text; 0 if malformed
+static size_t readName(const uint8_t* q, size_t len, size_t pos, std::string& name) {
+  while (pos < len && q[pos]) {
+    uint8_t n = q[pos++];
+    if (pos + n > len) return 0;
+    if (!name.empty()) name += '.';
+    name.append((const char*)q + pos, n);
+    pos += n;
+  }
+  return pos < len ? pos + 1 : 0;
+}
+
+static size_t buildReply(const uint8_t* q, size_t questionEnd, const StubRecord& r, uint8_t* out) {
+  memcpy(out, q, questionEnd);
+  out[2] = 0x81;                        // QR, RD
+  out[3] = 0x80;                        // RA
+  put16(out + 6, 0);
+  put16(out + 8, 0);
+  put16(out + 10, 0);
+  size_t n = questionEnd;
+  if (r.mode == STUB_SERVFAIL) {
+    out[3] |= 2;
+    return n;
+  }
+  if (r.mode == STUB_NXDOMAIN) {
+    out[3] |= 3;
+    return n;
+  }
+  if (r.mode == STUB_NODATA) return n;
+
+  uint16_t aOwner = 0xC00C;             // The question's name
+  uint16_t answers = 0;
+  if (r.mode == STUB_CNAME) {
+    static const uint8_t alias[] = { 5, 'e', 'd', 'g', 'e', 's', 4, 't', 'e', 's', 't', 0 };
+    put16(out + n, 0xC00C);
+    put16(out + n + 2, 5);              // CNAME
+    put16(out + n + 4, 1);
+    put32(out + n + 6, r.cnameTtl);
+    put16(out + n + 10, sizeof(alias));
+    n += 12;
+    aOwner = 0xC000 | n;
+    memcpy(out + n, alias, sizeof(alias));
+    n += sizeof(alias);
+    answers++;
+  }
+  put16(out + n, aOwner);
+  put16(out + n + 2, 1);                // A
+  put16(out + n + 4, 1);                // IN
+  put32(out + n + 6, r.ttl);
+  put16(out + n + 10, 4);
+  put32(out + n + 12, r.addr);
+  n += 16;
+  answers++;
+  put16(out + 6, answers);
+  return n;
+}
+
+static void runResolver(int fd) {
+  uint8_t q[512];
+  uint8_t out[600];
+  while (!stopping) {
+    fd_set rd;
+    FD_ZERO(&rd);
+    FD_SET(fd, &rd);
+    timeval tv = { 0, 50000 };
+    if (select(fd + 1, &rd, nullptr, nullptr, &tv) <= 0) continue;
+    sockaddr_in from;
+    socklen_t fromLen = sizeof(from);
+    ssize_t len = recvfrom(fd, q, sizeof(q), 0, (sockaddr*)&from, &fromLen);
+    if (len < 12) continue;
+    std::string name;
+    size_t end = readName(q, len, 12, name);
+    if (!end || end + 4 > (size_t)len) continue;
+    end += 4;
+    stubQueries++;
+
+    StubRecord r = { STUB_NXDOMAIN, 0, 0, 0 };
+    {
+      std::lock_guard<std::mutex> lock(stubLock);
+      stubIds.insert((q[0] << 8) | q[1]);
+      stubPorts.insert(ntohs(from.sin_port));
+      auto it = stubTable.find(name);
+      if (it != stubTable.end()) r = it->second;
+    }
+    if (verbose) printf("   stub: %s mode %u\n", name.c_str(), r.mode);
+    if (r.mode == STUB_DROP) continue;
+    if (r.mode == STUB_WRONG_ID) {
+      StubRecord bogus = { STUB_ANSWER, 0x0A0A0A0A, 3600, 0 };
+      size_t n = buildReply(q, end, bogus, out);
+      out[0] ^= 0x5A;
+      sendto(fd, out, n, 0, (sockaddr*)&from, fromLen);
+    }
+    if (r.mode == STUB_WRONG_QUESTION) {
+      StubRecord bogus = { STUB_ANSWER, 0x0A0A0A0A, 3600, 0 };
+      for (uint8_t forge = 0; forge < 3; forge++) {
+        size_t n = buildReply(q, end, bogus, out);
+        if (forge == 0) out[13] ^= 0x01;           // First letter of the name
+        if (forge == 1) put16(out + end - 4, 28);  // AAAA
+        if (forge == 2) put16(out + end - 2, 3);   // CHAOS
+        sendto(fd, out, n, 0, (sockaddr*)&from, fromLen);
+      }
+      for (size_t i = 12; i < end - 4; i++) q[i] = toupper(q[i]);
+    }
+    size_t n = buildReply(q, end, r, out);
+    sendto(fd, out, n, 0, (sockaddr*)&from, fromLen);
+  }
+}
+
+// 🌐 A bare HTTP/1.1 listener that answers every request "ok"
+static void runHttp(int fd) {
+  while (!stopping) {
+    fd_set rd;
+    FD_ZERO(&rd);
+    FD_SET(fd, &rd);
+    timeval tv = { 0, 50000 };
+    if (select(fd + 1, &rd, nullptr, nullptr, &tv) <= 0) continue;
+    int c = accept(fd, nullptr, nullptr);
+    if (c < 0) continue;
+    char req[1024];
+    size_t got = 0;
+    while (got < sizeof(req) - 1) {
+      ssize_t n = recv(c, req + got, sizeof(req) - 1 - got, 0);
+      if (n <= 0) break;
+      got += n;
+      req[got] = '\0';
+      if (strstr(req, "\r\n\r\n")) break;
+    }
+    static const char reply[] = "HTTP/1.1 200 OK\r\nContent-Length: 2\r\nConnection: close\r\n\r\nok";
+    send(c, reply, sizeof(reply) - 1, 0);
+    close(c);
+  }
+}
+
+static int bindLoopback(int type, uint16_t& port) {
+  int fd = socket(AF_INET, type, 0);
+  sockaddr_in a = {};
+  a.sin_family = AF_INET;
+  a.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  if (fd < 0 || bind(fd, (sockaddr*)&a, sizeof(a)) != 0) return -1;
+  if (type == SOCK_STREAM && listen(fd, 4) != 0) return -1;
+  socklen_t len = sizeof(a);
+  getsockname(fd, (sockaddr*)&a, &len);
+  port = ntohs(a.sin_port);
+  return fd;
+}
+
+// ✔️ Checks
+
+static uint32_t failures = 0;
+
+static void check(bool ok, const char* what) {
+  printf("%s %s\n", ok ? "✅" : "❌", what);
+  if (!ok) failures++;
+}
+
+static bool resolvesTo(const char* host, DnsSource want, const char* ip) {
+  uint32_t addr = 0;
+  DnsSource got = dnsResolve(host, addr);
+  bool ok = got == want && (!ip || addr == inet_addr(ip));
+  if (!ok) {
+    in_addr a;
+    a.s_addr = addr;
+    printf("   %s: %s %s, wanted %s %s\n", host, dnsSourceName(got), inet_ntoa(a),
+           dnsSourceName(want), ip ? ip : "");
+  }
+  return ok;
+}
+
+static bool statsAre(uint32_t hits, uint32_t misses, uint32_t stale, uint32_t failed) {
+  DnsCacheStats s = dnsCacheStats();
+  bool ok = s.hits == hits && s.misses == misses && s.stale == stale && s.failures == failed;
+  if (!ok) {
+    printf("   stats: %lu hits, %lu misses, %lu stale, %lu failures\n", (unsigned long)s.hits,
+           (unsigned long)s.misses, (unsigned long)s.stale, (unsigned long)s.failures);
+  }
+  return ok;
+}
+
+static void onDone(const AsyncHttpResponse& res, void* ctx) {
+  *(AsyncHttpResponse*)ctx = res;
+}
+
+static AsyncHttpResponse fetch(const char* url) {
+  AsyncHttpResponse res = {};
+  res.error = 1;  // Not an AsyncHttpError: still running
+  uint8_t body[64];
+  AsyncHttpRequest req = {};
+  req.url = url;
+  req.bodyBuf = body;
+  req.bodyCap = sizeof(body);
+  req.onDone = onDone;
+  req.ctx = &res;
+  req.timeoutMs = 5000;
+  if (!asyncHttpStart(req)) {
+    res.error = ASYNC_HTTP_ERR_URL;
+    return res;
+  }
+  while (res.error == 1) asyncHttpPoll(50);
+  return res;
+}
+
+int main(int argc, char** argv) {
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--verbose")) verbose = true;
+  }
+
+  uint16_t dnsPort = 0, httpPort = 0;
+  int dnsFd = bindLoopback(SOCK_DGRAM, dnsPort);
+  int httpFd = bindLoopback(SOCK_STREAM, httpPort);
+  if (dnsFd < 0 || httpFd < 0) {
+    printf("❌ Can't bind on 127.0.0.1\n");
+    return 1;
+  }
+  std::thread resolver(runResolver, dnsFd);
+  std::thread http(runHttp, httpFd);
+  dnsCacheSetServer(inet_addr("127.0.0.1"), dnsPort);
+  printf("🧭 Stub resolver on 127.0.0.1:%u, HTTP on :%u\n", dnsPort, httpPort);
+
+  // Hit after a miss, and only the miss reaches the resolver
+  setRecord("swd.weatherflow.test", STUB_ANSWER, "10.0.0.1", 2);
+  bool first = resolvesTo("swd.weatherflow.test", DNS_RESOLVED, "10.0.0.1");
+  bool second = resolvesTo("SWD.weatherflow.test", DNS_CACHED, "10.0.0.1");
+  check(first && second && stubQueries == 1 && statsAre(1, 1, 0, 0),
+        "Miss goes to the resolver, the repeat is a hit (names case-insensitive)");
+
+  check(resolvesTo("127.0.0.1", DNS_LITERAL, "127.0.0.1") && stubQueries == 1 && statsAre(1, 1, 0, 0),
+        "Address literals skip the cache and the stats");
+
+  // TTL: a 2 s record is asked again once it's past
+  setRecord("swd.weatherflow.test", STUB_ANSWER, "10.0.0.2", 1);
+  delay(1100);
+  bool stillCached = resolvesTo("swd.weatherflow.test", DNS_CACHED, "10.0.0.1");
+  delay(1000);
+  bool refreshed = resolvesTo("swd.weatherflow.test", DNS_RESOLVED, "10.0.0.2");
+  check(stillCached && refreshed && stubQueries == 2, "Entry kept for its TTL, asked again after");
+
+  // Serve-stale on SERVFAIL and on silence; the entry survives both
+  delay(1100);
+  setRecord("swd.weatherflow.test", STUB_SERVFAIL);
+  bool servfail = resolvesTo("swd.weatherflow.test", DNS_STALE, "10.0.0.2");
+  setRecord("swd.weatherflow.test", STUB_DROP);
+  uint32_t start = millis();
+  bool dropped = resolvesTo("swd.weatherflow.test", DNS_STALE, "10.0.0.2");
+  uint32_t waited = millis() - start;
+  check(servfail && dropped && statsAre(2, 4, 2, 2), "Expired entry served while the resolver fails");
+  check(waited >= DNS_TIMEOUT_MS * DNS_TRIES && waited < DNS_TIMEOUT_MS * DNS_TRIES + 500,
+        "A silent resolver costs DNS_TRIES timeouts, no more");
+  uint32_t before = stubQueries;
+  setRecord("swd.weatherflow.test", STUB_ANSWER, "10.0.0.3", 60);
+  check(resolvesTo("swd.weatherflow.test", DNS_RESOLVED, "10.0.0.3") && stubQueries == before + 1,
+        "A recovered resolver refreshes the stale entry");
+
+  // NXDOMAIN is an answer: nothing stale, the entry is gone
+  setRecord("gone.test", STUB_ANSWER, "10.0.1.1", 1);
+  resolvesTo("gone.test", DNS_RESOLVED, "10.0.1.1");
+  delay(1100);
+  setRecord("gone.test", STUB_NXDOMAIN);
+  bool nx = resolvesTo("gone.test", DNS_NONE, nullptr);
+  setRecord("gone.test", STUB_SERVFAIL);
+  check(nx && resolvesTo("gone.test", DNS_NONE, nullptr), "NXDOMAIN drops the entry instead of serving it");
+
+  // A CNAME's shorter TTL bounds the address's
+  setRecord("api.openweathermap.test", STUB_CNAME, "10.0.2.1", 300, 1);
+  resolvesTo("api.openweathermap.test", DNS_RESOLVED, "10.0.2.1");
+  delay(1100);
+  check(resolvesTo("api.openweathermap.test", DNS_RESOLVED, "10.0.2.1"), "CNAME chain cached for its shortest TTL");
+
+  setRecord("zero.test", STUB_ANSWER, "10.0.3.1", 0);
+  resolvesTo("zero.test", DNS_RESOLVED, "10.0.3.1");
+  check(resolvesTo("zero.test", DNS_RESOLVED, "10.0.3.1"), "TTL 0 is used once, never cached");
+
+  setRecord("spoof.test", STUB_WRONG_ID, "10.0.4.1", 60);
+  check(resolvesTo("spoof.test", DNS_RESOLVED, "10.0.4.1"), "Replies with the wrong ID are ignored");
+
+  setRecord("forged.test", STUB_WRONG_QUESTION, "10.0.4.2", 60);
+  check(resolvesTo("forged.test", DNS_RESOLVED, "10.0.4.2"),
+        "Replies to another name, type or class are ignored; the name's case isn't");
+
+  // NODATA: the name exists without an A record, so unlike NXDOMAIN the
+  // entry stays and is served stale
+  setRecord("v6.test", STUB_ANSWER, "10.0.4.3", 1);
+  resolvesTo("v6.test", DNS_RESOLVED, "10.0.4.3");
+  delay(1100);
+  setRecord("v6.test", STUB_NODATA);
+  bool staleV6 = resolvesTo("v6.test", DNS_STALE, "10.0.4.3");
+  bool keptV6 = resolvesTo("v6.test", DNS_STALE, "10.0.4.3");
+  setRecord("v6only.test", STUB_NODATA);
+  check(staleV6 && keptV6 && resolvesTo("v6only.test", DNS_NONE, nullptr),
+        "NODATA keeps the entry and serves it stale; with no entry the lookup fails");
+
+  // Every query so far came from its own ID and port (retries reuse both)
+  {
+    std::lock_guard<std::mutex> lock(stubLock);
+    bool portsInRange = *stubPorts.begin() >= 49152;
+    if (verbose || stubIds.size() < stubQueries - 3 || stubPorts.size() < stubQueries - 3) {
+      printf("   %lu queries from %u IDs and %u ports\n", (unsigned long)stubQueries.load(),
+             (unsigned)stubIds.size(), (unsigned)stubPorts.size());
+    }
+    check(portsInRange && stubIds.size() >= stubQueries - 3 && stubPorts.size() >= stubQueries - 3,
+          "Random query IDs and source ports");
+  }
+
+  // Eviction: the least recently used entry goes
+  for (uint8_t i = 0; i <= DNS_CACHE_ENTRIES; i++) {
+    char host[16], ip[16];
+    snprintf(host, sizeof(host), "h%u.test", i);
+    snprintf(ip, sizeof(ip), "10.0.5.%u", i);
+    setRecord(host, STUB_ANSWER, ip, 60);
+    resolvesTo(host, DNS_RESOLVED, ip);
+    delay(2);
+    if (i == 0) continue;
+    resolvesTo("h0.test", DNS_CACHED, "10.0.5.0");  // Keep h0 the most recent
+    delay(2);
+  }
+  check(resolvesTo("h0.test", DNS_CACHED, "10.0.5.0") && resolvesTo("h1.test", DNS_RESOLVED, "10.0.5.1"),
+        "A full cache evicts the least recently used entry");
+
+  // Through async_http: the connection's lookup is reported per response
+  dnsCacheClear();
+  setRecord("station.test", STUB_ANSWER, "127.0.0.1", 60);
+  char url[64];
+  snprintf(url, sizeof(url), "http://station.test:%u/obs", httpPort);
+  AsyncHttpResponse a = fetch(url);
+  AsyncHttpResponse b = fetch(url);
+  check(a.status == 200 && a.dnsSource == DNS_RESOLVED && b.status == 200 && b.dnsSource == DNS_CACHED,
+        "async_http resolves through the cache");
+  setRecord("station.test", STUB_DROP);
+  AsyncHttpResponse c = fetch(url);
+  check(c.status == 200 && c.dnsUs < 10000, "A hit costs no resolver round trip");
+
+  stopping = true;
+  resolver.join();
+  http.join();
+  close(dnsFd);
+  close(httpFd);
+
+  DnsCacheStats s = dnsCacheStats();
+  printf("\n🧭 %lu hits, %lu misses, %lu stale, %lu failures; %lu queries reached the stub\n",
+         (unsigned long)s.hits, (unsigned long)s.misses, (unsigned long)s.stale,
+         (unsigned long)s.failures, (unsigned long)stubQueries.load());
+  if (failures) {
+    printf("❌ %lu checks failed\n", (unsigned long)failures);
+    return 1;
+  }
+  printf("✅ DNS cache behaves\n");
+  return 0;
+}
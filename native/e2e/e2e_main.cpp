@@ -0,0 +1,318 @@
+#include <Arduino.h>
+#include <algorithm>
+#include "async_http.h"
+#include "api_routes.h"
+#include "weather_parse.h"
+#include "backfill.h"
+#include "forecast.h"
+#include "perf.h"
+#include "trace.h"
+
+// 🔁 End-to-end: the firmware's fetch path against the mock API
+//
+//   program [--tempest http://127.0.0.1:8080] [--openweather http://127.0.0.1:8081]
+//           [--refreshes 100] [--interval-ms 0] [--backfill minutes]
+//           [--trace refresh.trace]
+//
+// Each refresh does what the network task does for a full rotation. The
+// Tempest observation goes out conditional and kept alive, then the
+// forecast follows on the same connection. London runs in parallel on its
+// own host. Bodies go through the firmware's decoders: the arena DOM for
+// observations and the streaming parsers for the forecast and backfill.
+// The report gives per-route latency percentiles and outcome counts, plus
+// the time each whole refresh took, then the firmware's per-stage
+// histograms (perf.h) across every request. The run fails when a 200 body
+// didn't decode, since no injected fault should get that far. --trace saves
+// the timeline of the last refreshes for native/trace/trace2chrome.py.
+
+enum Route : uint8_t {
+  ROUTE_TEMPEST_OBS = 0,
+  ROUTE_FORECAST,
+  ROUTE_OPENWEATHER,
+  ROUTE_STATION_META,
+  ROUTE_DEVICE_OBS,
+  ROUTE_COUNT
+};
+
+static const char* const routeNames[ROUTE_COUNT] = {
+  "tempest_obs", "forecast", "openweather", "station_meta", "device_obs"
+};
+
+static const uint32_t MAX_SAMPLES = 4096;
+
+struct RouteStats {
+  uint32_t ms[MAX_SAMPLES];
+  uint32_t samples;
+  uint32_t ok;
+  uint32_t notModified;
+  uint32_t status429;
+  uint32_t status5xx;
+  uint32_t otherStatus;
+  uint32_t transport;    // async_http error before a usable response
+  uint32_t decode;       // 200 but the body didn't decode
+  uint32_t reused;
+  uint64_t bytes;
+};
+
+static RouteStats stats[ROUTE_COUNT];
+static RouteStats refreshStats;   // Only ms/samples used
+static char etags[ROUTE_COUNT][64];
+
+static void addSample(RouteStats& r, uint32_t ms) {
+  if (r.samples < MAX_SAMPLES) r.ms[r.samples] = ms;
+  r.samples++;
+}
+
+// 📥 One request of the refresh; the buffers outlive it like the firmware's
+struct Job {
+  uint8_t route;
+  bool started;
+  bool done;
+  char url[256];
+  char headers[160];
+  uint8_t body[4096];
+  ForecastParser forecast;
+  Forecast forecastData;
+  DeviceLookup lookup;
+  ObsRowParser rows;
+  long deviceId;
+};
+
+static Job jobs[ROUTE_COUNT];
+static const char* tempestBase = "http://127.0.0.1:8080";
+static const char* openweatherBase = "http://127.0.0.1:8081";
+static const long STATION_ID = 170405;
+
+static bool countRow(const HistorySample&, void*) {
+  return true;
+}
+
+static bool onBody(const uint8_t* data, size_t len, void* ctx) {
+  Job& j = *(Job*)ctx;
+  switch (j.route) {
+    case ROUTE_FORECAST: return forecastParseFeed(j.forecast, data, len);
+    case ROUTE_STATION_META: return deviceLookupFeed(j.lookup, data, len);
+    default: return obsRowsFeed(j.rows, data, len);
+  }
+}
+
+static bool decodeBody(Job& j, const AsyncHttpResponse& res) {
+  WeatherObs obs = {};
+  switch (j.route) {
+    case ROUTE_TEMPEST_OBS: return parseTempest((const char*)res.body, res.bodyLen, obs);
+    case ROUTE_OPENWEATHER: return parseLondon((const char*)res.body, res.bodyLen, obs);
+    case ROUTE_FORECAST: return forecastParseOk(j.forecast);
+    case ROUTE_STATION_META:
+      j.deviceId = j.lookup.deviceId;
+      return j.deviceId != 0;
+    default: return !jsonStreamFailed(j.rows.js) && j.rows.rows > 0;
+  }
+}
+
+static bool decoded(Job& j, const AsyncHttpResponse& res) {
+  traceBegin(TRACE_PARSE);
+  bool ok = decodeBody(j, res);
+  traceEnd(TRACE_PARSE);
+  return ok;
+}
+
+static void onDone(const AsyncHttpResponse& res, void* ctx) {
+  Job& j = *(Job*)ctx;
+  RouteStats& r = stats[j.route];
+  j.done = true;
+  addSample(r, res.elapsedMs);
+  perfRecordHttp(res);
+  r.bytes += res.bytesReceived;
+  if (res.reused) r.reused++;
+
+  // Streaming decoders stop early on purpose; that's not a transport error
+  bool streamed = j.route != ROUTE_TEMPEST_OBS && j.route != ROUTE_OPENWEATHER;
+  bool transportOk = res.error == ASYNC_HTTP_OK || (streamed && res.error == ASYNC_HTTP_ERR_ABORTED);
+  if (!transportOk) {
+    r.transport++;
+  } else if (res.status == 304) {
+    r.notModified++;
+  } else if (res.status == 429) {
+    r.status429++;
+  } else if (res.status >= 500) {
+    r.status5xx++;
+  } else if (res.status != 200) {
+    r.otherStatus++;
+  } else if (!decoded(j, res)) {
+    r.decode++;
+  } else {
+    r.ok++;
+    if (!streamed) snprintf(etags[j.route], sizeof(etags[j.route]), "%s", res.etag);
+  }
+}
+
+static void prepare(Job& j, uint8_t route, uint32_t backfillMinutes) {
+  long deviceId = j.deviceId;
+  memset(&j, 0, sizeof(j));
+  traceInstant(TRACE_FETCH_QUEUED, route);
+  j.route = route;
+  j.deviceId = deviceId;
+  int n = 0;
+  if (route != ROUTE_OPENWEATHER) {
+    n = snprintf(j.headers, sizeof(j.headers), "Authorization: Bearer Tempest_API_KEY\r\n");
+  }
+  if (etags[route][0]) snprintf(j.headers + n, sizeof(j.headers) - n, "If-None-Match: %s\r\n", etags[route]);
+
+  uint32_t now = (uint32_t)time(nullptr);
+  switch (route) {
+    case ROUTE_TEMPEST_OBS:
+      snprintf(j.url, sizeof(j.url), "%s" TEMPEST_OBS_PATH "%ld", tempestBase, STATION_ID);
+      break;
+    case ROUTE_FORECAST:
+      snprintf(j.url, sizeof(j.url), "%s" TEMPEST_FORECAST_PATH "%ld", tempestBase, STATION_ID);
+      forecastParseBegin(j.forecast, j.forecastData);
+      break;
+    case ROUTE_OPENWEATHER:
+      snprintf(j.url, sizeof(j.url), "%s" OPENWEATHER_LONDON_PATH "OPEN_WEATHER_API_KEY", openweatherBase);
+      break;
+    case ROUTE_STATION_META:
+      snprintf(j.url, sizeof(j.url), "%s" TEMPEST_STATION_META_PATH "%ld", tempestBase, STATION_ID);
+      deviceLookupBegin(j.lookup);
+      break;
+    case ROUTE_DEVICE_OBS:
+      snprintf(j.url, sizeof(j.url), "%s" TEMPEST_DEVICE_OBS_PATH "%ld?time_start=%lu&time_end=%lu",
+               tempestBase, j.deviceId, (unsigned long)(now - backfillMinutes * 60),
+               (unsigned long)now);
+      obsRowsBegin(j.rows, 14.4f, countRow, nullptr);
+      break;
+  }
+}
+
+static bool start(Job& j) {
+  AsyncHttpRequest req = {};
+  req.url = j.url;
+  req.headers = j.headers;
+  if (j.route == ROUTE_TEMPEST_OBS || j.route == ROUTE_OPENWEATHER) {
+    req.bodyBuf = j.body;
+    req.bodyCap = sizeof(j.body);
+  } else {
+    req.onBody = onBody;
+  }
+  req.onDone = onDone;
+  req.ctx = &j;
+  req.timeoutMs = j.route == ROUTE_DEVICE_OBS ? 60000 : 15000;
+  req.keepAlive = j.route != ROUTE_OPENWEATHER;  // As api.cpp: one London request a cycle
+  j.started = asyncHttpStart(req);
+  return j.started;
+}
+
+// 🚦 Run the jobs in order; a job whose host is busy waits for the next poll
+static void runJobs(Job** list, uint8_t count) {
+  for (;;) {
+    bool pending = false;
+    for (uint8_t i = 0; i < count; i++) {
+      if (!list[i]->started) start(*list[i]);
+      if (!list[i]->done) pending = true;
+    }
+    if (!pending) return;
+    asyncHttpPoll(50);
+  }
+}
+
+// 🧵 The ring as the firmware dumps it over serial or GET /trace
+static void saveTrace(const char* path) {
+  FILE* f = fopen(path, "w");
+  if (!f) {
+    printf("❌ Can't write %s\n", path);
+    return;
+  }
+  static char buf[1024];
+  TraceCursor c;
+  traceDumpBegin(c);
+  while (size_t n = traceDump(c, buf, sizeof(buf))) fwrite(buf, 1, n, f);
+  fclose(f);
+  printf("🧵 %lu trace events saved to %s\n", (unsigned long)traceCount(), path);
+}
+
+static uint32_t percentile(RouteStats& r, uint8_t pct) {
+  uint32_t n = std::min(r.samples, MAX_SAMPLES);
+  if (!n) return 0;
+  std::sort(r.ms, r.ms + n);
+  return r.ms[std::min(n - 1, (uint32_t)((uint64_t)n * pct / 100))];
+}
+
+static void printRow(const char* name, RouteStats& r, bool outcomes) {
+  printf("%-13s %5u", name, (unsigned)r.samples);
+  if (outcomes) {
+    printf(" %5u %5u %5u %5u %5u %5u %6u %7u", (unsigned)r.ok, (unsigned)r.notModified,
+           (unsigned)r.status429, (unsigned)r.status5xx, (unsigned)(r.transport + r.otherStatus),
+           (unsigned)r.decode, (unsigned)r.reused, (unsigned)(r.bytes / 1024));
+  } else {
+    printf("%*s", 48, "");
+  }
+  printf(" %6u %6u %6u %6u\n", (unsigned)percentile(r, 50), (unsigned)percentile(r, 90),
+         (unsigned)percentile(r, 99), (unsigned)percentile(r, 100));
+}
+
+int main(int argc, char** argv) {
+  uint32_t refreshes = 100;
+  uint32_t intervalMs = 0;
+  uint32_t backfillMinutes = 0;
+  const char* tracePath = nullptr;
+  for (int i = 1; i + 1 < argc; i += 2) {
+    if (!strcmp(argv[i], "--tempest")) tempestBase = argv[i + 1];
+    else if (!strcmp(argv[i], "--openweather")) openweatherBase = argv[i + 1];
+    else if (!strcmp(argv[i], "--refreshes")) refreshes = atoi(argv[i + 1]);
+    else if (!strcmp(argv[i], "--interval-ms")) intervalMs = atoi(argv[i + 1]);
+    else if (!strcmp(argv[i], "--backfill")) backfillMinutes = atoi(argv[i + 1]);
+    else if (!strcmp(argv[i], "--trace")) tracePath = argv[i + 1];
+  }
+
+  // ⏮️ Backfill first, as after boot: metadata for the device id, then rows
+  if (backfillMinutes) {
+    Job* meta[] = { &jobs[ROUTE_STATION_META] };
+    prepare(jobs[ROUTE_STATION_META], ROUTE_STATION_META, 0);
+    runJobs(meta, 1);
+    if (jobs[ROUTE_STATION_META].deviceId) {
+      jobs[ROUTE_DEVICE_OBS].deviceId = jobs[ROUTE_STATION_META].deviceId;
+      Job* rows[] = { &jobs[ROUTE_DEVICE_OBS] };
+      prepare(jobs[ROUTE_DEVICE_OBS], ROUTE_DEVICE_OBS, backfillMinutes);
+      runJobs(rows, 1);
+      printf("⏮️ Backfill: %u rows\n", (unsigned)jobs[ROUTE_DEVICE_OBS].rows.rows);
+    }
+  }
+
+  Job* cycle[] = { &jobs[ROUTE_TEMPEST_OBS], &jobs[ROUTE_OPENWEATHER], &jobs[ROUTE_FORECAST] };
+  for (uint32_t n = 0; n < refreshes; n++) {
+    unsigned long startMs = millis();
+    prepare(jobs[ROUTE_TEMPEST_OBS], ROUTE_TEMPEST_OBS, 0);
+    prepare(jobs[ROUTE_OPENWEATHER], ROUTE_OPENWEATHER, 0);
+    prepare(jobs[ROUTE_FORECAST], ROUTE_FORECAST, 0);
+    runJobs(cycle, 3);
+    addSample(refreshStats, millis() - startMs);
+    if (intervalMs) delay(intervalMs);
+  }
+  asyncHttpCloseIdle();
+  if (tracePath) saveTrace(tracePath);
+
+  printf("\n%-13s %5s %5s %5s %5s %5s %5s %5s %6s %7s %6s %6s %6s %6s\n", "route", "n", "ok",
+         "304", "429", "5xx", "io", "bad", "reused", "KB", "p50", "p90", "p99", "max");
+  uint32_t bad = 0;
+  for (uint8_t r = 0; r < ROUTE_COUNT; r++) {
+    if (!stats[r].samples) continue;
+    printRow(routeNames[r], stats[r], true);
+    bad += stats[r].decode;
+  }
+  printRow("refresh", refreshStats, false);
+  printf("(latencies in ms; io = transport errors and unexpected statuses)\n");
+
+  printf("\n%-13s %5s %8s %8s %8s %8s\n", "stage", "n", "p50", "p90", "p99", "max");
+  for (uint8_t s = 0; s < PERF_STAGE_COUNT; s++) {
+    PerfSummary p;
+    if (!perfSummary(s, p)) continue;
+    printf("%-13s %5u %8u %8u %8u %8u\n", perfStageName(s), (unsigned)p.count, (unsigned)p.p50Us,
+           (unsigned)p.p90Us, (unsigned)p.p99Us, (unsigned)p.maxUs);
+  }
+  printf("(stage times in us)\n");
+
+  if (bad) {
+    printf("\n❌ %u responses answered 200 but didn't decode\n", (unsigned)bad);
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,209 @@
+#include <Arduino.h>
+#include <vector>
+#include "forecast.h"
+
+// 🗓️ forecast.cpp against a recorded better_forecast response
+//
+//   program [payload.json] [--verbose]
+//
+// The payload (native/mock_api/responses/better_forecast.json by default,
+// San Diego, 14 Nov 2023) runs ten days daily and 240 hours hourly. The
+// checks compare the first FORECAST_HOURS hours and FORECAST_DAYS days with
+// the values below, field by field and icon by icon, check that the parser
+// stops on the closing brace of the twelfth hour instead of reading the
+// rest, and then split the payload at every byte offset to make sure a
+// token cut between two socket reads parses the same. Exits non-zero if any
+// check failed.
+
+struct WantHour {
+  uint32_t time;
+  float temp_f;
+  float wind_avg;
+  uint8_t precipPct;
+  uint8_t localHour;
+  uint8_t icon;
+};
+
+struct WantDay {
+  uint32_t dayStart;
+  float high_f;
+  float low_f;
+  uint8_t precipPct;
+  uint8_t icon;
+};
+
+static const WantHour WANT_HOURS[FORECAST_HOURS] = {
+  { 1699999200, 66.8f, 1.5f, 20, 14, ICON_PARTLY_CLOUDY },  // partly-cloudy-day
+  { 1700002800, 67.1f, 1.9f, 30, 15, ICON_CLOUDY },         // cloudy
+  { 1700006400, 67.0f, 2.4f, 40, 16, ICON_CLOUDY },         // cloudy
+  { 1700010000, 66.5f, 2.9f, 50, 17, ICON_RAIN },           // possibly-rainy-day
+  { 1700013600, 65.6f, 3.3f, 60, 18, ICON_RAIN },           // possibly-rainy-night
+  { 1700017200, 64.5f, 6.8f, 80, 19, ICON_RAIN },           // rainy
+  { 1700020800, 63.2f, 7.2f, 90, 20, ICON_RAIN },           // rainy
+  { 1700024400, 61.0f, 7.7f, 70, 21, ICON_STORM },          // possibly-thunderstorm-night
+  { 1700028000, 59.5f, 8.1f, 80, 22, ICON_STORM },          // thunderstorm
+  { 1700031600, 58.2f, 4.5f, 90, 23, ICON_RAIN },           // rainy
+  { 1700035200, 57.1f, 1.9f, 60, 0, ICON_RAIN },            // possibly-rainy-night
+  { 1700038800, 56.2f, 2.4f, 40, 1, ICON_CLOUDY },          // cloudy
+};
+
+static const WantDay WANT_DAYS[FORECAST_DAYS] = {
+  { 1699948800, 66, 57, 60, ICON_RAIN },                    // possibly-rainy-day
+  { 1700035200, 61, 54, 90, ICON_RAIN },                    // rainy
+  { 1700121600, 63, 51, 20, ICON_WINDY },                   // windy
+  { 1700208000, 68, 52, 10, ICON_PARTLY_CLOUDY },           // partly-cloudy-day
+  { 1700294400, 71, 55, 0, ICON_CLEAR },                    // clear-day
+};
+
+static uint32_t failures = 0;
+static bool verbose = false;
+
+static void check(bool ok, const char* what) {
+  printf("%s %s\n", ok ? "✅" : "❌", what);
+  if (!ok) failures++;
+}
+
+static bool near(float got, float want) {
+  return fabs(got - want) < 0.01f;
+}
+
+// Field-by-field against the tables; prints the first difference
+static bool matches(const Forecast& f, bool report) {
+  if (f.hourCount != FORECAST_HOURS || f.dayCount != FORECAST_DAYS) {
+    if (report) printf("   %u hours, %u days\n", f.hourCount, f.dayCount);
+    return false;
+  }
+  for (uint8_t i = 0; i < FORECAST_HOURS; i++) {
+    const ForecastHour& h = f.hours[i];
+    const WantHour& w = WANT_HOURS[i];
+    if (h.time != w.time || !near(h.temp_f, w.temp_f) || !near(h.wind_avg, w.wind_avg) ||
+        h.precipPct != w.precipPct || h.localHour != w.localHour || h.icon != w.icon) {
+      if (report) {
+        printf("   hour %u: %lu %.1f F %.1f m/s %u%% %u:00 %s, wanted %lu %.1f F %.1f m/s %u%% %u:00 %s\n", i,
+               (unsigned long)h.time, h.temp_f, h.wind_avg, h.precipPct, h.localHour, forecastIconLabel(h.icon),
+               (unsigned long)w.time, w.temp_f, w.wind_avg, w.precipPct, w.localHour, forecastIconLabel(w.icon));
+      }
+      return false;
+    }
+  }
+  for (uint8_t i = 0; i < FORECAST_DAYS; i++) {
+    const ForecastDay& d = f.days[i];
+    const WantDay& w = WANT_DAYS[i];
+    if (d.dayStart != w.dayStart || !near(d.high_f, w.high_f) || !near(d.low_f, w.low_f) ||
+        d.precipPct != w.precipPct || d.icon != w.icon) {
+      if (report) {
+        printf("   day %u: %lu %.0f/%.0f F %u%% %s, wanted %lu %.0f/%.0f F %u%% %s\n", i,
+               (unsigned long)d.dayStart, d.high_f, d.low_f, d.precipPct, forecastIconLabel(d.icon),
+               (unsigned long)w.dayStart, w.high_f, w.low_f, w.precipPct, forecastIconLabel(w.icon));
+      }
+      return false;
+    }
+  }
+  return true;
+}
+
+// Offset just past the closing brace of the n-th entry in "hourly"; 0 if
+// the payload doesn't have one
+static size_t hourEnd(const std::vector<uint8_t>& data, uint8_t n) {
+  const char* text = (const char*)data.data();
+  const char* key = strstr(text, "\"hourly\"");
+  if (!key) return 0;
+  size_t pos = strchr(key, '[') - text + 1;
+  int depth = 0;
+  bool inString = false;
+  for (; pos < data.size(); pos++) {
+    char c = text[pos];
+    if (inString) {
+      if (c == '\\') pos++;
+      else if (c == '"') inString = false;
+    } else if (c == '"') {
+      inString = true;
+    } else if (c == '{' || c == '[') {
+      depth++;
+    } else if (c == '}' || c == ']') {
+      if (--depth == 0 && c == '}' && --n == 0) return pos + 1;
+      if (depth < 0) return 0;
+    }
+  }
+  return 0;
+}
+
+int main(int argc, char** argv) {
+  const char* path = "native/mock_api/responses/better_forecast.json";
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--verbose")) verbose = true;
+    else path = argv[i];
+  }
+
+  FILE* f = fopen(path, "rb");
+  if (!f) {
+    printf("❌ Can't open %s\n", path);
+    return 1;
+  }
+  std::vector<uint8_t> data;
+  uint8_t chunk[4096];
+  size_t n;
+  while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0) data.insert(data.end(), chunk, chunk + n);
+  fclose(f);
+  data.push_back('\0');  // For strstr(); never fed
+  size_t len = data.size() - 1;
+  printf("🗓️ %s: %u bytes\n", path, (unsigned)len);
+
+  static ForecastParser parser;
+  static Forecast out;
+
+  // Whole payload in one feed
+  forecastParseBegin(parser, out);
+  bool more = forecastParseFeed(parser, data.data(), len);
+  check(!more && forecastParseOk(parser) && matches(out, true),
+        "One feed: 12 hours and 5 days with the recorded values and icons");
+
+  // Byte at a time: the stop lands on the twelfth hour's closing brace
+  size_t want = hourEnd(data, FORECAST_HOURS);
+  forecastParseBegin(parser, out);
+  size_t stoppedAt = 0;
+  for (size_t i = 0; i < len && !stoppedAt; i++) {
+    if (!forecastParseFeed(parser, data.data() + i, 1)) stoppedAt = i + 1;
+  }
+  if (verbose || stoppedAt != want) {
+    printf("   stopped after %u of %u bytes, twelfth hour ends at %u\n", (unsigned)stoppedAt, (unsigned)len,
+           (unsigned)want);
+  }
+  check(want > 0 && stoppedAt == want && matches(out, true),
+        "Stops on the twelfth hour's closing brace, the other 228 hours unread");
+
+  // Once stopped, more input changes nothing
+  Forecast before = out;
+  bool ignored = !forecastParseFeed(parser, data.data() + stoppedAt, len - stoppedAt);
+  check(ignored && memcmp(&before, &out, sizeof(out)) == 0 && forecastParseOk(parser),
+        "Feeds after the stop are ignored");
+
+  // Two reads split at every offset
+  uint32_t bad = 0;
+  for (size_t split = 0; split <= len; split++) {
+    forecastParseBegin(parser, out);
+    if (forecastParseFeed(parser, data.data(), split)) {
+      forecastParseFeed(parser, data.data() + split, len - split);
+    }
+    if (!forecastParseOk(parser) || !matches(out, bad == 0)) {
+      if (bad == 0 || verbose) printf("   split at %u\n", (unsigned)split);
+      bad++;
+    }
+  }
+  check(bad == 0, "Split into two reads at every byte offset: same forecast");
+
+  // A payload that ends before the lists fill: what arrived is kept
+  size_t sixth = hourEnd(data, 6);
+  forecastParseBegin(parser, out);
+  more = forecastParseFeed(parser, data.data(), sixth);
+  check(more && forecastParseOk(parser) && out.hourCount == 6 && out.dayCount == FORECAST_DAYS &&
+          out.hours[5].time == WANT_HOURS[5].time,
+        "Cut off after six hours: six hours kept, still waiting for more");
+
+  if (failures) {
+    printf("❌ %lu checks failed\n", (unsigned long)failures);
+    return 1;
+  }
+  printf("✅ Forecast parses the recorded payload\n");
+  return 0;
+}
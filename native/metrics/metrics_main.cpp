@@ -0,0 +1,110 @@
+#include <Arduino.h>
+#include "metrics.h"
+#include "perf.h"
+#include "async_http.h"
+#include "dns_cache.h"
+
+// 📈 The /metrics endpoint on this machine
+//
+//   program [--port 9100] [--scrapes 0] [--record-every-ms 20]
+//   python3 native/metrics/scrape.py --url http://127.0.0.1:9100/metrics [--slow]
+//
+// Serves the firmware's exposition while feeding perf the stage times and
+// request outcomes of simulated refreshes, so scrape.py (or a local
+// Prometheus) can check the format and that a scraper never holds the
+// loop up. The loop polls the server without waiting, as a render loop
+// would; the longest single poll is reported at the end. With --scrapes N
+// it exits once N scrapes have been served, 0 runs until killed.
+
+static uint32_t rng = 0x2545F491;
+
+static uint32_t nextRandom() {
+  rng ^= rng << 13;
+  rng ^= rng >> 17;
+  rng ^= rng << 5;
+  return rng;
+}
+
+// Roughly log-uniform between lo and hi, like real stage times
+static uint32_t spread(uint32_t lo, uint32_t hi) {
+  uint32_t us = lo;
+  while (us < hi && nextRandom() % 3) us += us / 2 + 1;
+  return us < hi ? us : hi;
+}
+
+static void recordRefresh() {
+  AsyncHttpResponse res = {};
+  uint32_t roll = nextRandom() % 100;
+  res.error = roll < 3 ? ASYNC_HTTP_ERR_TIMEOUT : ASYNC_HTTP_OK;
+  res.status = roll < 3 ? 0 : roll < 6 ? 503 : roll < 60 ? 304 : 200;
+  res.reused = nextRandom() % 4 != 0;
+  if (!res.reused) {
+    res.dnsSource = nextRandom() % 5 ? DNS_CACHED : DNS_RESOLVED;
+    res.dnsUs = res.dnsSource == DNS_CACHED ? spread(5, 40) : spread(2000, 200000);
+    res.tlsResumed = nextRandom() % 3 != 0;
+    res.tlsUs = res.tlsResumed ? spread(80000, 600000) : spread(400000, 4000000);
+  }
+  res.waitUs = spread(30000, 900000);
+  res.transferUs = res.status == 200 ? spread(1000, 300000) : 200;
+  res.elapsedMs = (res.dnsUs + res.tlsUs + res.waitUs + res.transferUs) / 1000;
+  res.bytesSent = 180;
+  res.bytesReceived = res.status == 200 ? 1400 + nextRandom() % 800 : 220;
+  perfRecordHttp(res);
+
+  if (res.status == 200) perfRecord(PERF_PARSE, spread(300, 4000));
+  perfRecord(PERF_RENDER, spread(20000, 90000));
+  perfRecord(PERF_PUSH_IMAGE, spread(14000, 20000));
+  for (uint8_t i = 0; i < 40; i++) perfRecord(PERF_FRAME, spread(3000, 30000));
+  if (nextRandom() % 10 == 0) perfCount(PERF_COUNT_FRAMES_DROPPED);
+}
+
+static void readGauges(MetricsGauges& g) {
+  g.uptimeMs = millis();
+  g.wifi = true;
+  g.rssi = -55 - (int8_t)(nextRandom() % 20);
+}
+
+int main(int argc, char** argv) {
+  uint16_t port = METRICS_PORT;
+  uint32_t maxScrapes = 0;
+  uint32_t recordEveryMs = 20;
+  for (int i = 1; i + 1 < argc; i += 2) {
+    if (!strcmp(argv[i], "--port")) port = atoi(argv[i + 1]);
+    else if (!strcmp(argv[i], "--scrapes")) maxScrapes = atoi(argv[i + 1]);
+    else if (!strcmp(argv[i], "--record-every-ms")) recordEveryMs = atoi(argv[i + 1]);
+  }
+
+  if (!metricsServerBegin(port, readGauges)) {
+    printf("❌ Can't listen on %u\n", port);
+    return 1;
+  }
+
+  uint32_t lastRecordMs = 0;
+  uint32_t doneAtMs = 0;
+  uint32_t longestPollUs = 0;
+  uint64_t polls = 0;
+  for (;;) {
+    uint32_t now = millis();
+    if (now - lastRecordMs >= recordEveryMs) {
+      lastRecordMs = now;
+      recordRefresh();
+    }
+
+    uint32_t start = micros();
+    metricsServerPoll(0);
+    uint32_t took = micros() - start;
+    if (took > longestPollUs) longestPollUs = took;
+    polls++;
+
+    // Give the last scrape a moment to drain before leaving
+    if (maxScrapes && !doneAtMs && metricsServerScrapes() >= maxScrapes) doneAtMs = now;
+    if (doneAtMs && now - doneAtMs > 500) break;
+    delay(1);  // The rest of a frame
+  }
+  metricsServerEnd();
+
+  printf("📈 %lu scrapes served over %llu polls, longest poll %lu us\n",
+         (unsigned long)metricsServerScrapes(), (unsigned long long)polls,
+         (unsigned long)longestPollUs);
+  return 0;
+}
@@ -0,0 +1,189 @@
+#!/usr/bin/env python3
+"""📈 Scrapes /metrics and checks it the way Prometheus would read it
+
+  python3 scrape.py [--url http://127.0.0.1:9100/metrics] [--count 10]
+                    [--interval 0.5] [--slow]
+
+Each scrape is parsed as text exposition 0.0.4:
+
+  - every sample belongs to a family with one HELP and one TYPE before it
+  - counters end in _total and never go backwards between scrapes
+  - histogram buckets rise with le, +Inf equals _count, _sum is present
+
+--slow also opens a scraper that sends its request and then stops
+reading, holding a server slot. The other scrapes must still finish
+quickly, and an unknown path must get a 404.
+
+Exits non-zero on the first violation. Works against the native build
+(native/metrics) or a display on the LAN.
+"""
+
+import argparse
+import math
+import re
+import socket
+import sys
+import time
+import urllib.error
+import urllib.parse
+import urllib.request
+
+SAMPLE = re.compile(r'^([a-zA-Z_:][a-zA-Z0-9_:]*)(\{[^}]*\})? (\S+)$')
+LABEL = re.compile(r'([a-zA-Z_][a-zA-Z0-9_]*)="([^"]*)"')
+SUFFIXES = ("_bucket", "_sum", "_count")
+
+
+def fail(msg):
+    print(f"❌ {msg}")
+    sys.exit(1)
+
+
+def family_of(name, types):
+    if name in types:
+        return name
+    for suffix in SUFFIXES:
+        if name.endswith(suffix) and types.get(name[: -len(suffix)]) == "histogram":
+            return name[: -len(suffix)]
+    return None
+
+
+def parse(text):
+    helps, types, samples = {}, {}, {}
+    for n, line in enumerate(text.splitlines(), 1):
+        if not line:
+            continue
+        if line.startswith("# HELP "):
+            name = line.split(" ", 3)[2]
+            if name in helps:
+                fail(f"line {n}: second HELP for {name}")
+            helps[name] = True
+            continue
+        if line.startswith("# TYPE "):
+            _, _, name, kind = line.split(" ", 3)
+            if name in types:
+                fail(f"line {n}: second TYPE for {name}")
+            types[name] = kind
+            continue
+        if line.startswith("#"):
+            continue
+
+        m = SAMPLE.match(line)
+        if not m:
+            fail(f"line {n}: not a sample: {line!r}")
+        name, labels, value = m.group(1), m.group(2) or "", m.group(3)
+        family = family_of(name, types)
+        if not family:
+            fail(f"line {n}: {name} has no TYPE before it")
+        if family not in helps:
+            fail(f"line {n}: {family} has no HELP")
+        try:
+            v = float(value)
+        except ValueError:
+            fail(f"line {n}: bad value {value!r}")
+        key = (name, tuple(sorted(LABEL.findall(labels))))
+        if key in samples:
+            fail(f"line {n}: duplicate sample {line!r}")
+        samples[key] = v
+
+    for family, kind in types.items():
+        if kind == "counter" and not family.endswith("_total"):
+            fail(f"counter {family} should end in _total")
+    check_histograms(types, samples)
+    return types, samples
+
+
+def check_histograms(types, samples):
+    for family, kind in types.items():
+        if kind != "histogram":
+            continue
+        series = {}
+        for (name, labels), v in samples.items():
+            if name != family + "_bucket":
+                continue
+            rest = tuple(l for l in labels if l[0] != "le")
+            le = dict(labels)["le"]
+            series.setdefault(rest, []).append((math.inf if le == "+Inf" else float(le), v))
+        for rest, buckets in series.items():
+            buckets.sort()
+            what = f"{family}{dict(rest)}"
+            if buckets[-1][0] != math.inf:
+                fail(f"{what} has no +Inf bucket")
+            counts = [v for _, v in buckets]
+            if counts != sorted(counts):
+                fail(f"{what} buckets go down: {counts}")
+            if samples.get((family + "_count", rest)) != counts[-1]:
+                fail(f"{what} +Inf bucket != _count")
+            if (family + "_sum", rest) not in samples:
+                fail(f"{what} has no _sum")
+
+
+def scrape(url, timeout):
+    start = time.monotonic()
+    with urllib.request.urlopen(url, timeout=timeout) as res:
+        if res.status != 200:
+            fail(f"HTTP {res.status}")
+        ctype = res.headers.get("Content-Type", "")
+        if not ctype.startswith("text/plain"):
+            fail(f"Content-Type {ctype!r}")
+        body = res.read().decode()
+    return body, time.monotonic() - start
+
+
+def hold_slot(url):
+    """A scraper that asks and then never reads"""
+    u = urllib.parse.urlsplit(url)
+    s = socket.create_connection((u.hostname, u.port or 80), timeout=5)
+    s.setsockopt(socket.SOL_SOCKET, socket.SO_RCVBUF, 1024)
+    s.sendall(f"GET {u.path} HTTP/1.1\r\nHost: {u.hostname}\r\n\r\n".encode())
+    return s
+
+
+def check_404(url):
+    u = urllib.parse.urlsplit(url)
+    try:
+        urllib.request.urlopen(f"{u.scheme}://{u.netloc}/nope", timeout=5)
+    except urllib.error.HTTPError as e:
+        if e.code == 404:
+            return
+        fail(f"/nope answered {e.code}")
+    fail("/nope answered 200")
+
+
+def main():
+    ap = argparse.ArgumentParser(description="Scrape and validate a /metrics endpoint")
+    ap.add_argument("--url", default="http://127.0.0.1:9100/metrics")
+    ap.add_argument("--count", type=int, default=10)
+    ap.add_argument("--interval", type=float, default=0.5)
+    ap.add_argument("--slow", action="store_true", help="Hold a slot with a scraper that never reads")
+    ap.add_argument("--timeout", type=float, default=2.0, help="Per-scrape limit in seconds")
+    args = ap.parse_args()
+
+    slow = hold_slot(args.url) if args.slow else None
+    if slow:
+        check_404(args.url)
+
+    previous = {}
+    worst = 0.0
+    for i in range(args.count):
+        body, took = scrape(args.url, args.timeout)
+        worst = max(worst, took)
+        if took > args.timeout:
+            fail(f"scrape {i} took {took:.3f} s")
+        types, samples = parse(body)
+        for key, v in samples.items():
+            name = key[0]
+            if types.get(name) == "counter" and v < previous.get(key, 0):
+                fail(f"{name}{dict(key[1])} went from {previous[key]} to {v}")
+        previous = samples
+        if i + 1 < args.count:
+            time.sleep(args.interval)
+
+    if slow:
+        slow.close()
+    stages = sum(1 for (name, _) in samples if name == "tempest_stage_seconds_count")
+    print(f"✅ {args.count} scrapes, {len(types)} families, {len(samples)} samples, "
+          f"{stages} stages, {len(body)} bytes, slowest {worst * 1000:.1f} ms")
+
+
+if __name__ == "__main__":
+    main()
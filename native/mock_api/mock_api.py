@@ -0,0 +1,388 @@
+#!/usr/bin/env python3
+"""🧪 Local stand-in for swd.weatherflow.com and api.openweathermap.org
+
+Serves the firmware's routes (src/api_routes.h) from recorded responses,
+with per-route fault injection:
+
+  latency_ms / jitter_ms   delay before the status line
+  bytes_per_sec            body throttle, 0 = as fast as the socket takes it
+  chunked / chunk_size     Transfer-Encoding: chunked instead of Content-Length
+  truncate_rate            fraction of bodies cut short (connection closed)
+  truncate_at              body bytes sent before the cut, -1 = half the body
+  rate_429 / retry_after   fraction answered 429 Too Many Requests
+  rate_5xx / status_5xx    fraction answered with a server error
+  keep_alive               false closes the connection after every response
+
+Slow TLS is per listener, since the path isn't known until after the
+handshake: --tls-port serves the same routes over TLS and waits
+tls_delay_ms before starting the handshake.
+
+  python3 mock_api.py [--port 8080 --port 8081] [--config faults.json]
+                      [--tls-port 8443 --cert cert.pem --key key.pem]
+
+Every port serves every route. The firmware opens one connection per
+host, so give OpenWeather its own port to keep its fetches in parallel
+with the Tempest ones, as they are against the real services.
+
+Settings can be changed while running:
+
+  curl localhost:8080/__mock/config                       current settings
+  curl -d '{"routes":{"forecast":{"rate_5xx":0.2}}}' localhost:8080/__mock/config
+  curl localhost:8080/__mock/stats                        per-route counters
+  curl -X POST localhost:8080/__mock/reset                defaults, counters cleared
+
+Tempest observations advance once a minute and OpenWeather every ten, each
+with an ETag, so conditional requests get 304s like the real services.
+"""
+
+import argparse
+import asyncio
+import copy
+import hashlib
+import json
+import math
+import os
+import random
+import ssl
+import sys
+import time
+import urllib.parse
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+
+# (route name, path prefix), first match wins
+ROUTES = [
+    ("tempest_obs", "/swd/rest/observations/station/"),
+    ("device_obs", "/swd/rest/observations/device/"),
+    ("station_meta", "/swd/rest/stations/"),
+    ("forecast", "/swd/rest/better_forecast"),
+    ("openweather", "/data/2.5/weather"),
+]
+
+DEFAULTS = {
+    "latency_ms": 0,
+    "jitter_ms": 0,
+    "bytes_per_sec": 0,
+    "chunked": False,
+    "chunk_size": 512,
+    "truncate_rate": 0.0,
+    "truncate_at": -1,
+    "rate_429": 0.0,
+    "retry_after": 30,
+    "rate_5xx": 0.0,
+    "status_5xx": 503,
+    "keep_alive": True,
+}
+
+REASONS = {200: "OK", 304: "Not Modified", 400: "Bad Request", 404: "Not Found",
+           429: "Too Many Requests", 500: "Internal Server Error", 502: "Bad Gateway",
+           503: "Service Unavailable", 504: "Gateway Timeout"}
+
+
+def load(name):
+    with open(os.path.join(HERE, "responses", name)) as f:
+        return json.load(f)
+
+
+def compact(obj):
+    return json.dumps(obj, separators=(",", ":")).encode()
+
+
+class Mock:
+    def __init__(self, config):
+        self.tempest_obs = load("tempest_obs.json")
+        self.openweather = load("openweather.json")
+        self.station_meta = load("station_meta.json")
+        self.reset()
+        self.apply(config)
+
+    def reset(self):
+        self.tls_delay_ms = 0
+        self.routes = {name: dict(DEFAULTS) for name, _ in ROUTES}
+        self.stats = {name: {} for name, _ in ROUTES}
+
+    def apply(self, config):
+        if "tls_delay_ms" in config:
+            self.tls_delay_ms = config["tls_delay_ms"]
+        routes = config.get("routes", {})
+        for name, settings in self.routes.items():
+            settings.update(routes.get("*", {}))
+            settings.update(routes.get(name, {}))
+
+    def config(self):
+        return {"tls_delay_ms": self.tls_delay_ms, "routes": self.routes}
+
+    def count(self, route, what):
+        self.stats[route][what] = self.stats[route].get(what, 0) + 1
+
+    # 📦 Bodies
+
+    def tempest_body(self, station_id, now):
+        minute = now // 60 * 60
+        doc = copy.deepcopy(self.tempest_obs)
+        doc["station_id"] = station_id
+        obs = doc["obs"][0]
+        obs["timestamp"] = minute
+        obs["air_temperature"] = round(18 + 6 * math.sin(minute / 43200 * math.pi), 1)
+        obs["wind_avg"] = round(2 + 1.5 * math.sin(minute / 600), 1)
+        obs["wind_gust"] = round(obs["wind_avg"] * 1.6, 1)
+        obs["wind_direction"] = (minute // 60 * 7) % 360
+        return compact(doc)
+
+    def openweather_body(self, now):
+        doc = copy.deepcopy(self.openweather)
+        doc["dt"] = now // 600 * 600
+        doc["main"]["temp"] = round(50 + 4 * math.sin(doc["dt"] / 43200 * math.pi), 2)
+        return compact(doc)
+
+    def device_obs_body(self, device_id, query, now):
+        end = int(query.get("time_end", [now])[0])
+        start = int(query.get("time_start", [end - 3600])[0])
+        rows = []
+        for t in range(start - start % 60, end + 1, 60):
+            temp = round(18 + 6 * math.sin(t / 43200 * math.pi), 1)
+            rows.append([t, 0.4, 2.1, 3.4, (t // 60 * 7) % 360, 3, 1003.2, temp, 64,
+                         49432, 3.1, 412, 0.0, 0, 0, 0, 2.6, 1])
+        doc = {"status": {"status_code": 0, "status_message": "SUCCESS"},
+               "device_id": device_id, "type": "obs_st", "source": "db",
+               "obs": rows, "summary": {"pressure_trend": "steady"}}
+        return compact(doc)
+
+    def forecast_body(self, station_id, now):
+        hour0 = now // 3600 * 3600
+        icons = ["clear-day", "partly-cloudy-day", "cloudy", "possibly-rainy-day", "rainy",
+                 "clear-night", "partly-cloudy-night", "foggy", "windy", "thunderstorm"]
+        daily = []
+        for d in range(10):
+            start = hour0 - hour0 % 86400 + d * 86400
+            daily.append({"day_start_local": start, "day_num": d + 1, "month_num": 11,
+                          "conditions": "Partly Cloudy", "icon": icons[d % len(icons)],
+                          "sunrise": start + 23000, "sunset": start + 61000,
+                          "air_temp_high": 72 - d % 3, "air_temp_low": 55 + d % 2,
+                          "precip_probability": (d * 10) % 60, "precip_icon": "chance-rain",
+                          "precip_type": "rain"})
+        hourly = []
+        for h in range(240):
+            t = hour0 + h * 3600
+            hourly.append({"time": t, "conditions": "Partly Cloudy", "icon": icons[h % len(icons)],
+                           "air_temperature": round(62 + 8 * math.sin(h / 24 * 2 * math.pi), 1),
+                           "sea_level_pressure": 1017.2, "relative_humidity": 70,
+                           "precip": 0, "precip_probability": (h * 5) % 70,
+                           "wind_avg": round(2 + (h % 5) * 0.5, 1), "wind_direction": (h * 15) % 360,
+                           "wind_direction_cardinal": "W", "wind_gust": 4.2, "uv": h % 9,
+                           "feels_like": 61.0, "local_hour": (h + 16) % 24, "local_day": 14})
+        doc = {"latitude": 32.7, "longitude": -117.1, "timezone": "America/Los_Angeles",
+               "timezone_offset_minutes": -480, "station": {"station_id": station_id},
+               "current_conditions": {"time": now, "conditions": "Clear", "icon": "clear-day",
+                                      "air_temperature": 64.0},
+               "forecast": {"daily": daily, "hourly": hourly},
+               "status": {"status_code": 0, "status_message": "SUCCESS"},
+               "units": {"units_temp": "f", "units_wind": "mps", "units_precip": "mm"}}
+        return compact(doc)
+
+    def body_for(self, route, path, query, now):
+        tail = path.rstrip("/").rsplit("/", 1)[-1]
+        if route == "tempest_obs":
+            return self.tempest_body(int(tail), now)
+        if route == "openweather":
+            return self.openweather_body(now)
+        if route == "station_meta":
+            return compact(self.station_meta)
+        if route == "device_obs":
+            return self.device_obs_body(int(tail), query, now)
+        return self.forecast_body(int(query.get("station_id", [0])[0]), now)
+
+    # 🎛️ Control endpoints
+
+    def control(self, method, path, body):
+        if path == "/__mock/config":
+            if method == "POST":
+                self.apply(json.loads(body or b"{}"))
+            return 200, compact(self.config())
+        if path == "/__mock/stats":
+            return 200, compact(self.stats)
+        if path == "/__mock/reset" and method == "POST":
+            self.reset()
+            return 200, b"{}"
+        return 404, b"{}"
+
+
+def pick(rate):
+    return rate > 0 and random.random() < rate
+
+
+async def read_request(reader):
+    head = await reader.readuntil(b"\r\n\r\n")
+    lines = head.decode("latin-1").split("\r\n")
+    method, target, version = lines[0].split(" ", 2)
+    headers = {}
+    for line in lines[1:]:
+        if ":" in line:
+            name, value = line.split(":", 1)
+            headers[name.strip().lower()] = value.strip()
+    body = b""
+    if int(headers.get("content-length", 0)):
+        body = await reader.readexactly(int(headers["content-length"]))
+    return method, target, version, headers, body
+
+
+async def send_body(writer, body, settings, cut):
+    """Write the body, throttled and chunked as configured; False once cut short"""
+    bps = settings["bytes_per_sec"]
+    chunked = settings["chunked"]
+    size = max(1, settings["chunk_size"] if chunked else 1024)
+    if bps:
+        size = max(1, min(size, bps // 20))  # ~20 writes a second
+    sent = 0
+    while sent < len(body):
+        piece = body[sent:sent + size]
+        if cut is not None and sent + len(piece) > cut:
+            piece = piece[:cut - sent]
+        if chunked and piece:
+            writer.write(b"%x\r\n" % len(piece) + piece + b"\r\n")
+        else:
+            writer.write(piece)
+        await writer.drain()
+        sent += len(piece)
+        if cut is not None and sent >= cut:
+            return False
+        if bps:
+            await asyncio.sleep(len(piece) / bps)
+    if chunked:
+        writer.write(b"0\r\n\r\n")
+        await writer.drain()
+    return True
+
+
+async def respond(mock, writer, method, target, version, headers, req_body):
+    """One exchange; returns whether the connection stays open"""
+    url = urllib.parse.urlsplit(target)
+    query = urllib.parse.parse_qs(url.query)
+    client_keeps = version == "HTTP/1.1" and headers.get("connection", "").lower() != "close"
+
+    if url.path.startswith("/__mock/"):
+        status, body = mock.control(method, url.path, req_body)
+        writer.write(b"HTTP/1.1 %d %s\r\nContent-Type: application/json\r\n"
+                     b"Content-Length: %d\r\nConnection: close\r\n\r\n"
+                     % (status, REASONS[status].encode(), len(body)) + body)
+        await writer.drain()
+        return False
+
+    route = next((name for name, prefix in ROUTES if url.path.startswith(prefix)), None)
+    if route is None:
+        writer.write(b"HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n\r\n")
+        await writer.drain()
+        return client_keeps
+
+    settings = mock.routes[route]
+    mock.count(route, "requests")
+    delay = settings["latency_ms"] + random.uniform(0, settings["jitter_ms"])
+    if delay:
+        await asyncio.sleep(delay / 1000)
+
+    keep = client_keeps and settings["keep_alive"]
+    extra = []
+    if pick(settings["rate_429"]):
+        status, body = 429, b'{"status":{"status_code":429,"status_message":"Too Many Requests"}}'
+        extra.append("Retry-After: %d" % settings["retry_after"])
+    elif pick(settings["rate_5xx"]):
+        status = settings["status_5xx"]
+        body = b'{"status":{"status_code":%d,"status_message":"Server Error"}}' % status
+    else:
+        try:
+            body = mock.body_for(route, url.path, query, int(time.time()))
+            status = 200
+        except ValueError:
+            status, body = 400, b'{"status":{"status_code":400,"status_message":"Bad Request"}}'
+        if status == 200:
+            etag = '"%s"' % hashlib.sha1(body).hexdigest()[:16]
+            extra.append("ETag: " + etag)
+            if headers.get("if-none-match") == etag:
+                status, body = 304, b""
+    mock.count(route, str(status))
+
+    cut = None
+    if body and pick(settings["truncate_rate"]):
+        at = settings["truncate_at"]
+        cut = min(len(body) - 1, at if at >= 0 else len(body) // 2)
+        keep = False
+
+    lines = ["HTTP/1.1 %d %s" % (status, REASONS.get(status, "Error"))]
+    if status != 304:
+        lines.append("Content-Type: application/json")
+        if settings["chunked"]:
+            lines.append("Transfer-Encoding: chunked")
+        else:
+            lines.append("Content-Length: %d" % len(body))
+    lines += extra
+    lines.append("Connection: " + ("keep-alive" if keep else "close"))
+    writer.write(("\r\n".join(lines) + "\r\n\r\n").encode())
+    await writer.drain()
+
+    if status != 304 and method != "HEAD":
+        if not await send_body(writer, body, settings, cut):
+            mock.count(route, "truncated")
+            return False
+    return keep
+
+
+async def serve(mock, reader, writer, tls_ctx=None):
+    try:
+        if tls_ctx:
+            # 🐢 Slow TLS: hold the ClientHello before answering it (unread,
+            # so the handshake and not the plain stream gets it)
+            writer.transport.pause_reading()
+            if mock.tls_delay_ms:
+                await asyncio.sleep(mock.tls_delay_ms / 1000)
+            await writer.start_tls(tls_ctx)
+        while True:
+            try:
+                request = await read_request(reader)
+            except (asyncio.IncompleteReadError, ConnectionError):
+                break
+            if not await respond(mock, writer, *request):
+                break
+    except (ConnectionError, ssl.SSLError, ValueError) as e:
+        print("⚠️ %s" % e, file=sys.stderr)
+    finally:
+        writer.close()
+
+
+async def main():
+    ap = argparse.ArgumentParser(description="Mock Tempest/OpenWeather API with fault injection")
+    ap.add_argument("--host", default="0.0.0.0")
+    ap.add_argument("--port", type=int, action="append", help="Repeat for more ports (default 8080)")
+    ap.add_argument("--config", help="JSON settings, same shape as POST /__mock/config")
+    ap.add_argument("--tls-port", type=int)
+    ap.add_argument("--cert")
+    ap.add_argument("--key")
+    ap.add_argument("--seed", type=int, help="Fixed random seed for repeatable faults")
+    args = ap.parse_args()
+
+    if args.seed is not None:
+        random.seed(args.seed)
+    config = {}
+    if args.config:
+        with open(args.config) as f:
+            config = json.load(f)
+    mock = Mock(config)
+
+    servers = []
+    for port in args.port or [8080]:
+        servers.append(await asyncio.start_server(lambda r, w: serve(mock, r, w), args.host, port))
+        print("🧪 Mock API on http://%s:%d" % (args.host, port))
+    if args.tls_port:
+        ctx = ssl.create_default_context(ssl.Purpose.CLIENT_AUTH)
+        ctx.load_cert_chain(args.cert, args.key)
+        servers.append(await asyncio.start_server(lambda r, w: serve(mock, r, w, ctx),
+                                                  args.host, args.tls_port))
+        print("🔒 TLS on port %d" % args.tls_port)
+
+    await asyncio.gather(*(s.serve_forever() for s in servers))
+
+
+if __name__ == "__main__":
+    try:
+        asyncio.run(main())
+    except KeyboardInterrupt:
+        pass
@@ -0,0 +1,105 @@
+#pragma once
+// 🧩 Just enough Arduino for the portable modules to build and run on a PC
+// (PlatformIO [env:native]). ARDUINO stays undefined, so device-only code
+// paths compile out.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <type_traits>
+
+// ⏱️ Monotonic clock since the first call, like millis() after boot
+inline uint64_t nativeNowUs() {
+  static timespec start = {};
+  timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  if (!start.tv_sec && !start.tv_nsec) start = now;
+  return (uint64_t)(now.tv_sec - start.tv_sec) * 1000000ULL + (now.tv_nsec - start.tv_nsec) / 1000;
+}
+inline unsigned long millis() { return (unsigned long)(nativeNowUs() / 1000); }
+inline unsigned long micros() { return (unsigned long)nativeNowUs(); }
+inline void delay(unsigned long ms) { usleep(ms * 1000); }
+inline void yield() {}
+
+// By value: with matching types the ?: is an lvalue, and a reference to a
+// parameter would dangle
+template <class A, class B> inline auto min(A a, B b) -> typename std::common_type<A, B>::type { return a < b ? a : b; }
+template <class A, class B> inline auto max(A a, B b) -> typename std::common_type<A, B>::type { return a > b ? a : b; }
+
+#define DEG_TO_RAD 0.017453292519943295769236907684886
+#define RAD_TO_DEG 57.295779513082320876798154814105
+
+// 🧵 WString stand-in: heap-backed like the real one, so legacy String code
+// costs on the host what it costs on the device (relative to the rest)
+class String {
+ public:
+  String(const char* s = "") { assign(s, strlen(s)); }
+  String(const String& o) { assign(o.buf, o.len); }
+  String(float v, unsigned char decimals = 2) {
+    char tmp[33];
+    snprintf(tmp, sizeof(tmp), "%.*f", decimals, v);
+    assign(tmp, strlen(tmp));
+  }
+  String(int v) {
+    char tmp[12];
+    snprintf(tmp, sizeof(tmp), "%d", v);
+    assign(tmp, strlen(tmp));
+  }
+  ~String() { free(buf); }
+
+  String& operator=(const String& o) {
+    if (this != &o) assign(o.buf, o.len);
+    return *this;
+  }
+  String& operator+=(const String& o) { return concat(o.buf, o.len); }
+  String& operator+=(const char* s) { return concat(s, strlen(s)); }
+  friend String operator+(const String& a, const String& b) { String r(a); r += b; return r; }
+  friend String operator+(const String& a, const char* b) { String r(a); r += b; return r; }
+  friend String operator+(const char* a, const String& b) { String r(a); r += b; return r; }
+  bool operator==(const char* s) const { return strcmp(buf, s) == 0; }
+
+  const char* c_str() const { return buf; }
+  unsigned int length() const { return len; }
+
+ private:
+  void reserve(size_t n) {
+    if (cap >= n && buf) return;
+    buf = (char*)realloc(buf, n + 1);
+    cap = n;
+  }
+  void assign(const char* s, size_t n) {
+    reserve(n);
+    memmove(buf, s, n);
+    buf[n] = '\0';
+    len = n;
+  }
+  String& concat(const char* s, size_t n) {
+    reserve(len + n);
+    memcpy(buf + len, s, n);
+    len += n;
+    buf[len] = '\0';
+    return *this;
+  }
+
+  char* buf = nullptr;
+  size_t len = 0;
+  size_t cap = 0;
+};
+
+// 🖨️ Serial goes to stdout
+class NativeSerial {
+ public:
+  void begin(unsigned long) {}
+  template <class... Args> int printf(const char* fmt, Args... args) { return ::printf(fmt, args...); }
+  void print(const char* s) { fputs(s, stdout); }
+  void print(const String& s) { fputs(s.c_str(), stdout); }
+  void println(const char* s = "") { puts(s); }
+  void println(const String& s) { puts(s.c_str()); }
+  size_t write(const uint8_t* data, size_t len) { return fwrite(data, 1, len, stdout); }
+};
+inline NativeSerial Serial;
@@ -0,0 +1,144 @@
+#pragma once
+// 🗄️ LittleFS over a host directory, for obs_log on a PC
+//
+// Paths map under a scratch directory (LITTLEFS_ROOT, else a fresh
+// /tmp/littlefs-XXXXXX removed at exit). Only the File/FS calls the
+// portable modules use are here, with the ESP32 core's semantics:
+// open() of a directory returns a File that lists it, path() is the
+// absolute path on the "partition".
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <ftw.h>
+#include <sys/stat.h>
+#include <memory>
+
+#define FILE_READ "r"
+#define FILE_WRITE "w"
+#define FILE_APPEND "a"
+
+// 🧨 Fault injection for tests: a partition that won't mount, or one that
+// mounts but refuses every write
+struct NativeFsFaults {
+  bool mountFails = false;
+  bool writesFail = false;
+};
+inline NativeFsFaults nativeFsFaults;
+
+inline const char* nativeFsRoot() {
+  static char root[256] = "";
+  if (!root[0]) {
+    const char* env = getenv("LITTLEFS_ROOT");
+    if (env && *env) {
+      snprintf(root, sizeof(root), "%s", env);
+      mkdir(root, 0755);
+    } else {
+      snprintf(root, sizeof(root), "/tmp/littlefs-XXXXXX");
+      if (!mkdtemp(root)) {
+        root[0] = '\0';
+        return root;
+      }
+      atexit([] {
+        nftw(nativeFsRoot(), [](const char* p, const struct stat*, int, FTW*) { return ::remove(p); },
+             16, FTW_DEPTH | FTW_PHYS);
+      });
+    }
+  }
+  return root;
+}
+
+inline void nativeFsPath(const char* path, char* out, size_t cap) {
+  snprintf(out, cap, "%s%s%s", nativeFsRoot(), path[0] == '/' ? "" : "/", path);
+}
+
+class File {
+ public:
+  File() = default;
+
+  explicit operator bool() const { return state && (state->fp || state->dir); }
+
+  size_t read(uint8_t* buf, size_t len) { return state && state->fp ? fread(buf, 1, len, state->fp) : 0; }
+  size_t write(const uint8_t* buf, size_t len) {
+    return state && state->fp ? fwrite(buf, 1, len, state->fp) : 0;
+  }
+  bool seek(uint32_t pos) { return state && state->fp && fseek(state->fp, pos, SEEK_SET) == 0; }
+  size_t size() const {
+    if (!state || !state->fp) return 0;
+    fflush(state->fp);
+    struct stat st;
+    return fstat(fileno(state->fp), &st) == 0 ? (size_t)st.st_size : 0;
+  }
+  const char* path() const { return state ? state->path : ""; }
+  bool isDirectory() const { return state && state->dir; }
+
+  File openNextFile(const char* mode = FILE_READ) {
+    if (!state || !state->dir) return File();
+    while (dirent* d = readdir(state->dir)) {
+      if (strcmp(d->d_name, ".") == 0 || strcmp(d->d_name, "..") == 0) continue;
+      char child[sizeof(state->path) + sizeof(d->d_name) + 1];
+      snprintf(child, sizeof(child), "%s/%s", state->path, d->d_name);
+      return open(child, mode);
+    }
+    return File();
+  }
+
+  void close() { state.reset(); }
+
+  // Directories list, files are fopen()ed; a missing file is a false File
+  static File open(const char* path, const char* mode) {
+    char host[512];
+    nativeFsPath(path, host, sizeof(host));
+    File f;
+    f.state = std::make_shared<State>();
+    snprintf(f.state->path, sizeof(f.state->path), "%s", path);
+    struct stat st;
+    if (stat(host, &st) == 0 && S_ISDIR(st.st_mode)) {
+      f.state->dir = opendir(host);
+    } else if (nativeFsFaults.writesFail && strcmp(mode, FILE_READ) != 0) {
+      return File();
+    } else {
+      // "w" on LittleFS truncates like fopen; reads need the file to exist
+      const char* how = strcmp(mode, FILE_APPEND) == 0 ? "ab" : strcmp(mode, FILE_WRITE) == 0 ? "wb" : "rb";
+      f.state->fp = fopen(host, how);
+    }
+    if (!f.state->fp && !f.state->dir) f.state.reset();
+    return f;
+  }
+
+ private:
+  struct State {
+    FILE* fp = nullptr;
+    DIR* dir = nullptr;
+    char path[64] = "";   // LittleFS names are short (LFS_NAME_MAX 32)
+    ~State() {
+      if (fp) fclose(fp);
+      if (dir) closedir(dir);
+    }
+  };
+  std::shared_ptr<State> state;
+};
+
+class NativeLittleFS {
+ public:
+  bool begin(bool = false) { return !nativeFsFaults.mountFails && nativeFsRoot()[0] != '\0'; }
+  bool exists(const char* path) {
+    char host[512];
+    nativeFsPath(path, host, sizeof(host));
+    struct stat st;
+    return stat(host, &st) == 0;
+  }
+  bool mkdir(const char* path) {
+    char host[512];
+    nativeFsPath(path, host, sizeof(host));
+    return ::mkdir(host, 0755) == 0;
+  }
+  bool remove(const char* path) {
+    char host[512];
+    nativeFsPath(path, host, sizeof(host));
+    return ::remove(host) == 0;
+  }
+  File open(const char* path, const char* mode = FILE_READ) { return File::open(path, mode); }
+};
+inline NativeLittleFS LittleFS;
@@ -0,0 +1,175 @@
+#include "net_model.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Block sizes, ESP-IDF 4.4 defaults on the C3
+static const size_t ADDRINFO_BYTES = 64;       // getaddrinfo result, freed after connect
+static const size_t PCB_BYTES = 196;           // sizeof(struct tcp_pcb)
+static const size_t NETCONN_BYTES = 52;
+static const size_t MBOX_BYTES = 112;          // FreeRTOS queue behind recvmbox
+static const size_t TLS_CTX_BYTES = 2344;      // esp_tls_t, mbedTLS contexts inline
+static const size_t TLS_IN_BYTES = 16717;      // 16 KB record + header/MAC/IV room
+static const size_t TLS_OUT_BYTES = 4429;      // 4 KB (asymmetric out) + the same
+static const size_t HANDSHAKE_BYTES = 1920;    // mbedtls_ssl_handshake_params, ECDHE inline
+static const size_t TRANSFORM_BYTES = 712;     // AES-GCM contexts both ways
+static const size_t SESSION_BYTES = 128;
+static const size_t CRT_BYTES = 564;           // mbedtls_x509_crt
+static const size_t CA_PARSE_BYTES = 1336;     // Bundle CA, parsed to verify then freed
+static const size_t RX_BUF_BYTES = 1600;       // Dynamic WiFi RX buffer
+static const size_t PBUF_BYTES = 32;           // PBUF_REF header pointing into it
+static const size_t TX_HEADROOM = 54;          // Ethernet/IP/TCP headers
+static const uint8_t CHAIN_CERTS = 3;          // Leaf + two intermediates
+static const uint16_t BIGNUM_OPS = 240;        // ECDHE + RSA signature check
+static const uint8_t BIGNUM_LIVE = 16;
+
+static const uint32_t TIME_WAIT_SEC = 120;     // 2 x TCP_MSL
+static const uint8_t TIME_WAIT_MAX = 16;       // MEMP_NUM_TCP_PCB
+
+struct TimeWait {
+  void* pcb;
+  uint32_t since;
+};
+static TimeWait timeWait[TIME_WAIT_MAX];
+
+static uint32_t nextRandom(uint32_t& state) {
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+  return state;
+}
+
+static bool take(void*& slot, size_t bytes) {
+  slot = malloc(bytes);
+  return slot != nullptr;
+}
+
+static void drop(void*& slot) {
+  free(slot);
+  slot = nullptr;
+}
+
+bool netConnect(NetConn& c, bool tls) {
+  memset(&c, 0, sizeof(c));
+  c.tls = tls;
+  c.open = true;
+  void* addr = nullptr;
+  bool ok = take(addr, ADDRINFO_BYTES) && take(c.pcb, PCB_BYTES) &&
+            take(c.netconn, NETCONN_BYTES) && take(c.mbox, MBOX_BYTES);
+  free(addr);
+  if (!ok || !tls) return ok;
+  // 🔐 esp_tls_conn_new: the context, then mbedtls_ssl_setup's record buffers
+  return take(c.tlsCtx, TLS_CTX_BYTES) && take(c.inBuf, TLS_IN_BYTES) && take(c.outBuf, TLS_OUT_BYTES);
+}
+
+bool netHandshake(NetConn& c, uint32_t seed) {
+  if (!c.tls) return true;
+  uint32_t rng = seed | 1;
+  void* handshake = nullptr;
+  void* session = nullptr;
+  void* crt[CHAIN_CERTS] = {};
+  void* der[CHAIN_CERTS] = {};
+  void* bignums[BIGNUM_LIVE] = {};
+  void* ca = nullptr;
+
+  bool ok = take(handshake, HANDSHAKE_BYTES) && take(session, SESSION_BYTES) &&
+            take(c.transform, TRANSFORM_BYTES);
+
+  // 📜 Certificate message: each cert parsed into a crt + a copy of its DER
+  for (uint8_t i = 0; ok && i < CHAIN_CERTS; i++) {
+    ok = take(crt[i], CRT_BYTES) && take(der[i], 1024 + nextRandom(rng) % 640);
+  }
+  if (ok) {
+    ok = take(ca, CA_PARSE_BYTES);
+    drop(ca);
+  }
+
+  // 🧮 Key exchange and signature checks: bignums come and go in bursts
+  for (uint16_t op = 0; ok && op < BIGNUM_OPS; op++) {
+    uint32_t r = nextRandom(rng);
+    void*& slot = bignums[r % BIGNUM_LIVE];
+    if (slot) {
+      drop(slot);
+    } else {
+      size_t bytes = (r >> 8) % 8 ? 32 + ((r >> 12) % 9) * 8 : 264 + ((r >> 12) % 2) * 256;
+      ok = take(slot, bytes);
+    }
+  }
+  for (uint8_t i = 0; i < BIGNUM_LIVE; i++) drop(bignums[i]);
+
+  // 🤝 Finished: the negotiated session replaces the handshake state and
+  // only the leaf's DER survives
+  if (ok) ok = take(c.session, SESSION_BYTES);
+  drop(handshake);
+  drop(session);
+  for (uint8_t i = 0; i < CHAIN_CERTS; i++) {
+    drop(crt[i]);
+    if (i == 0 && ok) {
+      c.peerCert = der[0];
+      der[0] = nullptr;
+    }
+    drop(der[i]);
+  }
+  return ok;
+}
+
+bool netSend(NetConn& c, size_t len) {
+  if (c.txPbuf) drop(c.txPbuf);
+  return c.tls || take(c.txPbuf, len + TX_HEADROOM);   // TLS writes through outBuf
+}
+
+bool netReceive(NetConn& c, const uint8_t* data, size_t len, NetSink sink, void* ctx, bool& more) {
+  void* rx = nullptr;
+  void* pbuf = nullptr;
+  more = false;
+  if (!take(rx, RX_BUF_BYTES) || !take(pbuf, PBUF_BYTES)) {
+    free(rx);
+    return false;
+  }
+  memcpy(rx, data, len < RX_BUF_BYTES ? len : RX_BUF_BYTES);
+  if (c.txPbuf) drop(c.txPbuf);   // Acked by now
+  more = sink(data, len, ctx);
+  free(pbuf);
+  free(rx);
+  return true;
+}
+
+void netClose(NetConn& c, uint32_t nowSec) {
+  if (!c.open) return;
+  drop(c.txPbuf);
+  drop(c.peerCert);
+  drop(c.session);
+  drop(c.transform);
+  drop(c.outBuf);
+  drop(c.inBuf);
+  drop(c.tlsCtx);
+  drop(c.mbox);
+  drop(c.netconn);
+  c.open = false;
+  if (!c.pcb) return;
+
+  // ⏳ The pcb outlives the socket; a full table recycles the oldest
+  uint8_t slot = 0;
+  for (uint8_t i = 0; i < TIME_WAIT_MAX; i++) {
+    if (!timeWait[i].pcb) {
+      slot = i;
+      break;
+    }
+    if (timeWait[i].since < timeWait[slot].since) slot = i;
+  }
+  free(timeWait[slot].pcb);
+  timeWait[slot].pcb = c.pcb;
+  timeWait[slot].since = nowSec;
+  c.pcb = nullptr;
+}
+
+void netTick(uint32_t nowSec) {
+  for (uint8_t i = 0; i < TIME_WAIT_MAX; i++) {
+    if (timeWait[i].pcb && nowSec - timeWait[i].since >= TIME_WAIT_SEC) {
+      drop(timeWait[i].pcb);
+    }
+  }
+}
+
+void netShutdown() {
+  for (uint8_t i = 0; i < TIME_WAIT_MAX; i++) drop(timeWait[i].pcb);
+}
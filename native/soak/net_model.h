@@ -0,0 +1,47 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+// 📶 The heap traffic of lwIP + esp-tls behind one HTTP connection
+//
+// The host build has neither, but on the board they are the biggest heap
+// users: every TLS handshake takes ~16.7 KB + ~4.4 KB of record buffers
+// that must each be one contiguous block, plus a few hundred short-lived
+// bignum and certificate allocations. This replays that pattern with block
+// sizes from the ESP-IDF defaults (MBEDTLS_SSL_IN/OUT_CONTENT_LEN, dynamic
+// WiFi RX buffers, MEMP_MEM_MALLOC pcbs). They are estimates, not
+// measurements, and only the shape has to be right for the soak to show
+// whether the firmware's own allocations fragment around them. Closed pcbs
+// linger in TIME_WAIT for two minutes as they do in lwIP.
+
+struct NetConn {
+  bool tls;
+  bool open;
+  void* pcb;           // tcp_pcb
+  void* netconn;       // netconn + its receive mailbox
+  void* mbox;
+  void* tlsCtx;        // esp_tls_t with the embedded mbedTLS contexts
+  void* inBuf;         // Record buffers, held while the connection lives
+  void* outBuf;
+  void* transform;
+  void* session;
+  void* peerCert;      // Kept for renegotiation checks (KEEP_PEER_CERTIFICATE)
+  void* txPbuf;        // The request, until the first response segment acks it
+};
+
+const size_t NET_SEGMENT = 1436;   // TCP payload per received segment
+
+// Each returns false when an allocation failed; the caller then netClose()s
+bool netConnect(NetConn& c, bool tls);
+bool netHandshake(NetConn& c, uint32_t seed);   // No-op for plain HTTP
+bool netSend(NetConn& c, size_t len);
+
+// One received segment: the WiFi RX buffer and pbuf live while sink reads it
+typedef bool (*NetSink)(const uint8_t* data, size_t len, void* ctx);
+bool netReceive(NetConn& c, const uint8_t* data, size_t len, NetSink sink, void* ctx, bool& more);
+
+void netClose(NetConn& c, uint32_t nowSec);
+
+// Free TIME_WAIT pcbs older than two minutes
+void netTick(uint32_t nowSec);
+void netShutdown();   // Drop every TIME_WAIT pcb (radio off)
@@ -0,0 +1,235 @@
+#include "sim_heap.h"
+#include <string.h>
+
+// Block layout: header, then the payload. Free blocks keep their free-list
+// links in the first 8 payload bytes, so no block is smaller than 16.
+struct BlockHeader {
+  uint32_t size;       // Whole block, header included; FREE_BIT when free
+  uint32_t prevSize;   // Size of the block below, 0 for the first
+};
+
+struct FreeLinks {
+  uint32_t next;       // Offsets of the neighbouring free blocks
+  uint32_t prev;
+};
+
+static const uint32_t HEADER = sizeof(BlockHeader);
+static const uint32_t MIN_BLOCK = HEADER + sizeof(FreeLinks);
+static const uint32_t FREE_BIT = 1;
+static const uint32_t NONE = 0xFFFFFFFFu;
+
+alignas(16) static uint8_t region[SIM_HEAP_MAX];
+static size_t capacity = 0;
+static bool active = false;
+static uint32_t freeHead = NONE;
+static SimHeapStats stats;
+
+static BlockHeader* at(uint32_t off) { return (BlockHeader*)(region + off); }
+static FreeLinks* links(uint32_t off) { return (FreeLinks*)(region + off + HEADER); }
+static uint32_t sizeOf(uint32_t off) { return at(off)->size & ~FREE_BIT; }
+static bool isFree(uint32_t off) { return at(off)->size & FREE_BIT; }
+static uint32_t usable(uint32_t off) { return sizeOf(off) - HEADER; }
+
+static bool inRegion(const void* p) {
+  return p >= (const void*)region && p < (const void*)(region + capacity);
+}
+
+static void unlink(uint32_t off) {
+  FreeLinks* l = links(off);
+  if (l->prev != NONE) links(l->prev)->next = l->next;
+  else freeHead = l->next;
+  if (l->next != NONE) links(l->next)->prev = l->prev;
+  stats.freeBlocks--;
+  stats.freeBytes -= usable(off);
+}
+
+static void pushFree(uint32_t off) {
+  at(off)->size |= FREE_BIT;
+  FreeLinks* l = links(off);
+  l->prev = NONE;
+  l->next = freeHead;
+  if (freeHead != NONE) links(freeHead)->prev = off;
+  freeHead = off;
+  stats.freeBlocks++;
+  stats.freeBytes += usable(off);
+}
+
+static void fixNextPrevSize(uint32_t off) {
+  uint32_t next = off + sizeOf(off);
+  if (next < capacity) at(next)->prevSize = sizeOf(off);
+}
+
+// Cut a used block down to need bytes, freeing the tail if it's worth a block
+static void split(uint32_t off, uint32_t need) {
+  uint32_t size = sizeOf(off);
+  if (size - need < MIN_BLOCK) return;
+  at(off)->size = need;
+  uint32_t tail = off + need;
+  at(tail)->size = size - need;
+  at(tail)->prevSize = need;
+  fixNextPrevSize(tail);
+  // The block after the tail may be free too
+  uint32_t after = tail + sizeOf(tail);
+  if (after < capacity && isFree(after)) {
+    unlink(after);
+    at(tail)->size = sizeOf(tail) + sizeOf(after);
+    fixNextPrevSize(tail);
+  }
+  pushFree(tail);
+}
+
+static uint32_t blockFor(size_t n) {
+  uint64_t need = ((uint64_t)n + HEADER + 7) & ~7ull;
+  if (need < MIN_BLOCK) need = MIN_BLOCK;
+  return need > capacity ? 0 : (uint32_t)need;
+}
+
+static void noteLow() {
+  if (stats.freeBytes < stats.minFree) stats.minFree = stats.freeBytes;
+}
+
+static void* simAlloc(size_t n) {
+  uint32_t need = blockFor(n);
+  uint32_t best = NONE;
+  for (uint32_t off = freeHead; need && off != NONE; off = links(off)->next) {
+    uint32_t size = sizeOf(off);
+    if (size >= need && (best == NONE || size < sizeOf(best))) {
+      best = off;
+      if (size == need) break;
+    }
+  }
+  if (best == NONE) {
+    stats.failed++;
+    return nullptr;
+  }
+  unlink(best);
+  at(best)->size &= ~FREE_BIT;
+  split(best, need);
+  stats.liveBlocks++;
+  stats.allocs++;
+  noteLow();
+  return region + best + HEADER;
+}
+
+static void simFree(void* p) {
+  uint32_t off = (uint32_t)((uint8_t*)p - region) - HEADER;
+  stats.liveBlocks--;
+  stats.frees++;
+
+  uint32_t next = off + sizeOf(off);
+  if (next < capacity && isFree(next)) {
+    unlink(next);
+    at(off)->size = sizeOf(off) + sizeOf(next);
+  }
+  if (at(off)->prevSize) {
+    uint32_t prev = off - at(off)->prevSize;
+    if (isFree(prev)) {
+      unlink(prev);
+      at(prev)->size = sizeOf(prev) + sizeOf(off);
+      off = prev;
+    }
+  }
+  fixNextPrevSize(off);
+  pushFree(off);
+}
+
+static void* simRealloc(void* p, size_t n) {
+  uint32_t off = (uint32_t)((uint8_t*)p - region) - HEADER;
+  uint32_t need = blockFor(n);
+  if (!need) {
+    stats.failed++;
+    return nullptr;
+  }
+  if (need <= sizeOf(off)) {
+    split(off, need);
+    stats.allocs++;
+    return p;
+  }
+  // ↗️ Grow into a free neighbour above before moving
+  uint32_t next = off + sizeOf(off);
+  if (next < capacity && isFree(next) && sizeOf(off) + sizeOf(next) >= need) {
+    unlink(next);
+    at(off)->size = sizeOf(off) + sizeOf(next);
+    fixNextPrevSize(off);
+    split(off, need);
+    stats.allocs++;
+    noteLow();
+    return p;
+  }
+  void* moved = simAlloc(n);
+  if (!moved) return nullptr;
+  memcpy(moved, p, usable(off));
+  simFree(p);
+  return moved;
+}
+
+void simHeapBegin(size_t bytes) {
+  capacity = (bytes > SIM_HEAP_MAX ? SIM_HEAP_MAX : bytes) & ~(size_t)7;
+  memset(&stats, 0, sizeof(stats));
+  freeHead = NONE;
+  at(0)->size = capacity;
+  at(0)->prevSize = 0;
+  pushFree(0);
+  stats.capacity = capacity;
+  stats.minFree = stats.freeBytes;
+  stats.minLargest = stats.freeBytes;
+  active = true;
+}
+
+void simHeapEnd() {
+  active = false;
+}
+
+const SimHeapStats& simHeapStats() {
+  return stats;
+}
+
+size_t simHeapLargestFree() {
+  uint32_t largest = 0;
+  for (uint32_t off = freeHead; off != NONE; off = links(off)->next) {
+    if (usable(off) > largest) largest = usable(off);
+  }
+  if (largest < stats.minLargest) stats.minLargest = largest;
+  return largest;
+}
+
+float simHeapFragmentation() {
+  return stats.freeBytes ? 1.0f - (float)simHeapLargestFree() / stats.freeBytes : 0.0f;
+}
+
+void simHeapResetMarks() {
+  stats.minFree = stats.freeBytes;
+  stats.minLargest = simHeapLargestFree();
+}
+
+// 🔀 The process's heap, routed here while active (glibc keeps the rest)
+extern "C" {
+void* __libc_malloc(size_t n);
+void* __libc_calloc(size_t count, size_t n);
+void* __libc_realloc(void* p, size_t n);
+void __libc_free(void* p);
+
+void* malloc(size_t n) {
+  return active ? simAlloc(n) : __libc_malloc(n);
+}
+
+void* calloc(size_t count, size_t n) {
+  if (!active) return __libc_calloc(count, n);
+  if (n && count > SIZE_MAX / n) return nullptr;
+  void* p = simAlloc(count * n);
+  if (p) memset(p, 0, count * n);
+  return p;
+}
+
+void* realloc(void* p, size_t n) {
+  if (!p) return malloc(n);
+  if (inRegion(p)) return simRealloc(p, n);
+  return __libc_realloc(p, n);
+}
+
+void free(void* p) {
+  if (!p) return;
+  if (inRegion(p)) simFree(p);
+  else __libc_free(p);
+}
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+// 🧱 Simulated device heap for the soak test
+//
+// A fixed region managed like the ESP32's DRAM heap: 8-byte headers with
+// boundary tags, best-fit over a free list, neighbours coalesced on free.
+// While active, malloc/calloc/realloc/free for the whole process land
+// here, so String, ArduinoJson's default allocator and the modelled
+// network stack all compete for the same bytes as on the board, and the
+// largest free block shows what fragmentation costs. Pointers from before
+// simHeapBegin() still go back to the C library.
+
+struct SimHeapStats {
+  size_t capacity;
+  size_t freeBytes;      // Usable bytes in free blocks
+  size_t minFree;        // Low-water mark of freeBytes
+  size_t minLargest;     // Low-water mark of the largest free block
+  uint32_t liveBlocks;
+  uint32_t freeBlocks;   // Holes, the free list length
+  uint64_t allocs;       // malloc/calloc/realloc calls that returned memory
+  uint64_t frees;
+  uint64_t failed;       // Requests no free block could satisfy
+};
+
+// Route the process's heap into a region of capacity bytes (up to
+// SIM_HEAP_MAX); call before the code under test allocates anything
+const size_t SIM_HEAP_MAX = 512 * 1024;
+void simHeapBegin(size_t capacity);
+void simHeapEnd();
+
+const SimHeapStats& simHeapStats();
+size_t simHeapLargestFree();
+
+// 1 - largest free block / free bytes; 0 = one contiguous hole
+float simHeapFragmentation();
+
+// Start new low-water marks (per reporting window)
+void simHeapResetMarks();
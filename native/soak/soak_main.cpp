@@ -0,0 +1,495 @@
+#include <Arduino.h>
+#include <math.h>
+#include "sim_heap.h"
+#include "net_model.h"
+#include "corpus.h"
+#include "api.h"
+#include "api_routes.h"
+#include "screens.h"
+#include "weather_parse.h"
+#include "forecast.h"
+#include "history.h"
+#include "stats.h"
+#include "text_format.h"
+
+// 🧫 Heap soak: months of fetch/parse/render on a virtual clock
+//
+//   program [--days 90] [--heap 180] [--legacy] [--every 7] [--csv soak.csv]
+//           [--warmup 1] [--max-growth 5] [--max-frag 10] [--seed 1]
+//
+// The firmware's schedule runs on simulated seconds against the simulated
+// heap (sim_heap.h): a Tempest observation every minute, London every ten,
+// the forecast every half hour on the observation's kept-alive connection,
+// and a screen render every rotation. Bodies are recorded responses fed in
+// TCP-sized segments through the modelled network stack (net_model.h) and
+// decoded by the firmware's own parsers, then pushed into history and
+// stats. --legacy swaps in the pre-arena code: String URLs and headers,
+// the body grown in a String and a heap JsonDocument, String display text.
+//
+// The heap is sampled whenever the radio goes idle, so only long-lived
+// blocks are left. The run fails on any refused allocation, when mean
+// fragmentation over the last day is more than --max-growth points above
+// the first day after --warmup, when any day after --warmup averages over
+// --max-frag percent (growth alone passes a heap that starts out shredded),
+// or when the idle live bytes grew (a leak).
+// --heap is the free heap once WiFi is up, in KB.
+
+static const uint32_t EPOCH_START = 1760000400;    // On a half-hour boundary
+static const uint32_t DAY_SEC = 86400;
+static const uint32_t OBS_EVERY_SEC = 60;          // Station publish interval
+static const uint32_t LONDON_EVERY_SEC = 600;
+static const uint32_t FORECAST_EVERY_SEC = 1800;
+static const uint32_t RENDER_EVERY_SEC = 30;       // main.cpp screenInterval
+static const uint32_t LEAK_SLACK_BYTES = 512;      // TIME_WAIT pcbs come and go
+
+enum ExchangeKind : uint8_t {
+  EX_OBS = 0,
+  EX_LONDON,
+  EX_FORECAST,
+  EX_KIND_COUNT
+};
+
+enum ExchangePhase : uint8_t {
+  PHASE_IDLE = 0,
+  PHASE_WAIT,        // Host busy, goes out when the connection frees up
+  PHASE_CONNECT,
+  PHASE_HANDSHAKE,
+  PHASE_SEND,
+  PHASE_RECEIVE,
+  PHASE_DONE
+};
+
+// 📥 One request of the round, stepped a phase at a time so the three
+// interleave their allocations the way concurrent async_http slots do
+struct Exchange {
+  uint8_t kind;
+  uint8_t phase;
+  NetConn* conn;
+  bool tls;
+  const char* body;
+  size_t len;
+  size_t offset;
+  uint8_t buf[4096];   // As api.cpp's SourceFetch body
+  size_t bufLen;
+  String* url;         // Legacy: what HTTPClient kept per request
+  String* headers;
+  String* payload;
+};
+
+struct Window {
+  double fragSum;
+  double usedSum;
+  uint32_t samples;
+  size_t freeBytes;
+  size_t largest;
+  uint32_t holes;
+  uint32_t liveBlocks;
+  uint64_t allocs;     // Running totals at the window start
+  uint64_t failed;
+};
+
+static bool legacy = false;
+static uint32_t now = EPOCH_START;
+static uint32_t rng = 1;
+static NetConn tempestConn;
+static NetConn londonConn;
+static Exchange exchanges[EX_KIND_COUNT];
+static WeatherObs latest[OBS_SCREEN_COUNT];
+static Forecast forecast;
+static ForecastParser forecastParser;
+static char forecastJson[64 * 1024];
+static size_t forecastLen = 0;
+static uint32_t rendered = 0;        // Keeps the formatting from being optimized out
+static uint64_t fetchFailures = 0;
+static uint64_t handshakes = 0;
+static uint64_t decodeFailures = 0;
+
+static uint32_t nextRandom() {
+  rng ^= rng << 13;
+  rng ^= rng >> 17;
+  rng ^= rng << 5;
+  return rng;
+}
+
+// 🗓️ A full-size better_forecast (10 days, 240 hours) in the API's shape
+static void buildForecast() {
+  static const char* icons[] = { "clear-day", "partly-cloudy-day", "cloudy", "rainy", "windy" };
+  size_t n = 0;
+  const size_t cap = sizeof(forecastJson);
+  uint32_t day0 = EPOCH_START - EPOCH_START % DAY_SEC;
+  n += snprintf(forecastJson + n, cap - n,
+                "{\"latitude\":32.7,\"longitude\":-117.1,\"timezone\":\"America/Los_Angeles\","
+                "\"timezone_offset_minutes\":-480,\"forecast\":{\"daily\":[");
+  for (uint8_t d = 0; d < 10; d++) {
+    n += snprintf(forecastJson + n, cap - n,
+                  "%s{\"day_start_local\":%lu,\"day_num\":%u,\"conditions\":\"Partly Cloudy\","
+                  "\"icon\":\"%s\",\"air_temp_high\":%d,\"air_temp_low\":%d,"
+                  "\"precip_probability\":%d,\"precip_type\":\"rain\"}",
+                  d ? "," : "", (unsigned long)(day0 + d * DAY_SEC), d + 1, icons[d % 5],
+                  72 - d % 3, 55 + d % 2, (d * 10) % 60);
+  }
+  n += snprintf(forecastJson + n, cap - n, "],\"hourly\":[");
+  for (uint16_t h = 0; h < 240; h++) {
+    n += snprintf(forecastJson + n, cap - n,
+                  "%s{\"time\":%lu,\"conditions\":\"Partly Cloudy\",\"icon\":\"%s\","
+                  "\"air_temperature\":%.1f,\"sea_level_pressure\":1017.2,\"relative_humidity\":70,"
+                  "\"precip\":0,\"precip_probability\":%d,\"wind_avg\":%.1f,\"wind_direction\":%d,"
+                  "\"wind_gust\":4.2,\"uv\":%d,\"feels_like\":61.0,\"local_hour\":%d,\"local_day\":14}",
+                  h ? "," : "", (unsigned long)(EPOCH_START + h * 3600), icons[h % 5],
+                  62 + 8 * sin(h / 24.0 * 2 * M_PI), (h * 5) % 70, 2 + (h % 5) * 0.5, (h * 15) % 360,
+                  h % 9, (h + 16) % 24);
+  }
+  n += snprintf(forecastJson + n, cap - n,
+                "]},\"status\":{\"status_code\":0,\"status_message\":\"SUCCESS\"}}");
+  forecastLen = n;
+}
+
+// 📼 Replay: any of the provider's recorded responses
+static const CorpusPayload& pickPayload(CorpusProvider provider) {
+  const CorpusPayload* match[8];
+  uint8_t count = 0;
+  for (uint8_t i = 0; i < corpusCount() && count < 8; i++) {
+    const CorpusPayload& p = corpusAt(i);
+    if (p.provider == provider && p.json) match[count++] = &p;
+  }
+  return *match[nextRandom() % count];
+}
+
+static void begin(Exchange& x, uint8_t kind) {
+  memset(&x, 0, sizeof(x));
+  x.kind = kind;
+  x.phase = kind == EX_FORECAST && exchanges[EX_OBS].phase != PHASE_IDLE ? PHASE_WAIT : PHASE_CONNECT;
+  x.conn = kind == EX_LONDON ? &londonConn : &tempestConn;
+  x.tls = kind != EX_LONDON;
+  if (kind == EX_FORECAST) {
+    x.body = forecastJson;
+    x.len = forecastLen;
+    forecastParseBegin(forecastParser, forecast);
+  } else {
+    const CorpusPayload& p = pickPayload(kind == EX_OBS ? CORPUS_TEMPEST : CORPUS_OPENWEATHER);
+    x.body = p.json;
+    x.len = p.len;
+  }
+  if (legacy && kind != EX_FORECAST) {
+    // 🧵 As the old fetch functions: String URL, bearer header, String body
+    x.url = new String(kind == EX_OBS ? String(TEMPEST_API_BASE TEMPEST_OBS_PATH) + "170405"
+                                      : String(OPENWEATHER_API_BASE OPENWEATHER_LONDON_PATH) + "OPEN_WEATHER_API_KEY");
+    x.headers = new String(kind == EX_OBS ? "Authorization: " + String("Bearer ") + "Tempest_API_KEY" + "\r\n"
+                                          : String(""));
+    x.payload = new String();
+  }
+}
+
+static bool onSegment(const uint8_t* data, size_t len, void* ctx) {
+  Exchange& x = *(Exchange*)ctx;
+  if (x.kind == EX_FORECAST) return forecastParseFeed(forecastParser, data, len);
+  if (x.payload) {
+    char chunk[NET_SEGMENT + 1];
+    memcpy(chunk, data, len);
+    chunk[len] = '\0';
+    *x.payload += chunk;
+    return true;
+  }
+  size_t n = min(len, sizeof(x.buf) - x.bufLen);
+  memcpy(x.buf + x.bufLen, data, n);
+  x.bufLen += n;
+  return true;
+}
+
+static bool decode(Exchange& x, WeatherObs& obs) {
+  if (!x.payload) {
+    return x.kind == EX_OBS ? parseTempest((const char*)x.buf, x.bufLen, obs)
+                            : parseLondon((const char*)x.buf, x.bufLen, obs);
+  }
+  JsonDocument doc;
+  if (deserializeJson(doc, x.payload->c_str(), x.payload->length())) return false;
+  if (x.kind == EX_OBS) readTempest(doc.as<JsonVariantConst>(), obs);
+  else readLondon(doc.as<JsonVariantConst>(), obs);
+  return true;
+}
+
+static void finish(Exchange& x, bool ok) {
+  if (!ok) {
+    fetchFailures++;
+    netClose(*x.conn, now);
+  } else if (x.kind == EX_FORECAST) {
+    if (!forecastParseOk(forecastParser)) decodeFailures++;
+    if (x.offset < x.len) netClose(*x.conn, now);  // Stopped early: the rest can't be drained
+  } else {
+    WeatherObs obs = {};
+    if (!decode(x, obs)) {
+      decodeFailures++;
+    } else {
+      obs.screen = x.kind == EX_OBS ? SCREEN_SAN_DIEGO : SCREEN_LONDON;
+      obs.timestamp = now;
+      latest[obs.screen] = obs;
+      if (x.kind == EX_OBS) {
+        HistorySample s = { now, obs.temp_f, obs.pressure_mb, obs.humidity, obs.wind_avg,
+                            obs.wind_gust, obs.wind_dir, obs.rain_mm, obs.uv };
+        historyAppend(s);
+        statsAdd(s);
+      }
+    }
+    if (x.kind == EX_LONDON) netClose(*x.conn, now);  // One request a cycle, not kept alive
+  }
+  delete x.payload;
+  delete x.headers;
+  delete x.url;
+  x.payload = x.headers = x.url = nullptr;
+  x.phase = PHASE_DONE;
+}
+
+// One phase; false once the exchange is done
+static bool step(Exchange& x) {
+  NetConn& c = *x.conn;
+  bool more = false;
+  switch (x.phase) {
+    case PHASE_WAIT:
+      if (exchanges[EX_OBS].phase == PHASE_DONE) x.phase = PHASE_CONNECT;
+      return true;
+    case PHASE_CONNECT:
+      if (c.open) {
+        x.phase = PHASE_SEND;  // ♻️ Parked connection
+        return true;
+      }
+      if (x.tls) simHeapLargestFree();  // Headroom when the record buffers are wanted
+      if (!netConnect(c, x.tls)) break;
+      x.phase = PHASE_HANDSHAKE;
+      return true;
+    case PHASE_HANDSHAKE:
+      if (!netHandshake(c, nextRandom())) break;
+      if (x.tls) handshakes++;
+      x.phase = PHASE_SEND;
+      return true;
+    case PHASE_SEND: {
+      size_t requestLen = 96 + (x.url ? x.url->length() + x.headers->length() : 160);
+      if (!netSend(c, requestLen)) break;
+      x.phase = PHASE_RECEIVE;
+      return true;
+    }
+    case PHASE_RECEIVE: {
+      size_t n = min(NET_SEGMENT, x.len - x.offset);
+      if (!netReceive(c, (const uint8_t*)x.body + x.offset, n, onSegment, &x, more)) break;
+      x.offset += n;
+      if (more && x.offset < x.len) return true;
+      finish(x, true);
+      return false;
+    }
+    default:
+      return false;
+  }
+  finish(x, false);
+  return false;
+}
+
+// 🔁 One network round: whatever is due, interleaved, then the radio idles
+static void fetchRound(bool london, bool withForecast) {
+  for (uint8_t k = 0; k < EX_KIND_COUNT; k++) exchanges[k].phase = PHASE_IDLE;
+  begin(exchanges[EX_OBS], EX_OBS);
+  if (london) begin(exchanges[EX_LONDON], EX_LONDON);
+  if (withForecast) begin(exchanges[EX_FORECAST], EX_FORECAST);
+
+  for (bool pending = true; pending;) {
+    pending = false;
+    for (uint8_t k = 0; k < EX_KIND_COUNT; k++) {
+      if (exchanges[k].phase != PHASE_IDLE && step(exchanges[k])) pending = true;
+    }
+  }
+  // 📴 idleRadio(): parked sockets close with the association
+  netClose(tempestConn, now);
+  netClose(londonConn, now);
+}
+
+// 🖼️ One rotation's text, the way the screens build it
+static void render(uint8_t screen) {
+  if (screen == SCREEN_FORECAST) {
+    char text[24];
+    for (uint8_t i = 0; i < forecast.hourCount && i < 4; i++) {
+      rendered += formatHour12(text, sizeof(text), forecast.hours[i].localHour);
+      rendered += formatNumber(text, sizeof(text), forecast.hours[i].temp_f, 0);
+    }
+    return;
+  }
+  const WeatherObs& obs = latest[screen];
+  StatSummary day;
+  if (screen == SCREEN_SAN_DIEGO && statsQuery(STAT_TEMP, WINDOW_24H, now, day)) rendered += day.samples;
+  if (legacy) {
+    String tempText = String(obs.temp_f, 1) + " F";
+    String wind = String(obs.wind_avg, 1) + " m/s " + String(windDirFromDegrees(obs.wind_dir));
+    String humidity = String((int)lroundf(obs.humidity)) + "%";
+    rendered += tempText.length() + wind.length() + humidity.length();
+    return;
+  }
+  char text[32];
+  size_t n = formatTemperature(text, sizeof(text), obs.temp_f);
+  n += formatSpeed(text, sizeof(text), obs.wind_avg);
+  n += formatPercent(text, sizeof(text), obs.humidity);
+  rendered += n + strlen(windDirFromDegrees(obs.wind_dir));
+}
+
+// ⚙️ Boot-time blocks that stay for good: task stacks, queues, sprites
+static size_t bootAllocations() {
+  const size_t blocks[] = {
+    8192 + 344,                            // "net" task stack + TCB
+    4096 + 344,                            // "udp" task
+    80 + (SCREEN_COUNT + 1),               // fetchRequests
+    80 + SCREEN_COUNT * sizeof(WeatherObs),
+    80 + 32 * sizeof(HistorySample),       // backfillSamples
+    80 + sizeof(Forecast),                 // forecastMailbox
+    80 + 8 * sizeof(TempestEvent),
+    16 * 58 * 2,                           // Wind needle sprite, 16-bit
+    140 * 22,                              // Sparkline sprite, 8-bit
+  };
+  static void* volatile held[sizeof(blocks) / sizeof(blocks[0])];  // Never freed
+  size_t bytes = 0;
+  for (size_t i = 0; i < sizeof(blocks) / sizeof(blocks[0]); i++) {
+    held[i] = malloc(blocks[i]);
+    if (held[i]) bytes += blocks[i];
+  }
+  return bytes;
+}
+
+static void sample(Window& w) {
+  const SimHeapStats& h = simHeapStats();
+  w.fragSum += simHeapFragmentation();
+  w.usedSum += h.capacity - h.freeBytes;
+  w.samples++;
+}
+
+static double meanFrag(const Window& w) {
+  return w.samples ? w.fragSum / w.samples : 0;
+}
+
+static double meanUsed(const Window& w) {
+  return w.samples ? w.usedSum / w.samples : 0;
+}
+
+static void closeWindow(Window& w, uint32_t day, bool print, FILE* csv) {
+  const SimHeapStats& h = simHeapStats();
+  w.freeBytes = h.freeBytes;
+  w.largest = simHeapLargestFree();
+  w.holes = h.freeBlocks;
+  w.liveBlocks = h.liveBlocks;
+  uint64_t allocs = h.allocs - w.allocs;
+  if (print) {
+    printf("%5u %8.1f %8.1f %7.2f %6u %6u %8.1f %8.1f %9llu %6llu\n", (unsigned)day,
+           w.freeBytes / 1024.0, w.largest / 1024.0, meanFrag(w) * 100, (unsigned)w.holes,
+           (unsigned)w.liveBlocks, h.minFree / 1024.0, h.minLargest / 1024.0,
+           (unsigned long long)allocs, (unsigned long long)(h.failed - w.failed));
+  }
+  if (csv) {
+    fprintf(csv, "%u,%u,%u,%.5f,%u,%u,%u,%u,%llu,%llu\n", (unsigned)day, (unsigned)w.freeBytes,
+            (unsigned)w.largest, meanFrag(w), (unsigned)w.holes, (unsigned)w.liveBlocks,
+            (unsigned)h.minFree, (unsigned)h.minLargest, (unsigned long long)allocs,
+            (unsigned long long)(h.failed - w.failed));
+  }
+}
+
+int main(int argc, char** argv) {
+  uint32_t days = 90;
+  uint32_t heapKb = 180;
+  uint32_t every = 7;
+  uint32_t warmup = 1;
+  float maxGrowth = 5;   // Percentage points
+  float maxFrag = 10;    // Percent, any one day's mean
+  const char* csvPath = nullptr;
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--legacy")) {
+      legacy = true;
+      continue;
+    }
+    if (i + 1 >= argc) break;
+    if (!strcmp(argv[i], "--days")) days = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "--heap")) heapKb = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "--every")) every = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "--warmup")) warmup = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "--max-growth")) maxGrowth = atof(argv[++i]);
+    else if (!strcmp(argv[i], "--max-frag")) maxFrag = atof(argv[++i]);
+    else if (!strcmp(argv[i], "--csv")) csvPath = argv[++i];
+    else if (!strcmp(argv[i], "--seed")) rng = atoi(argv[++i]) | 1;
+  }
+  if (days <= warmup) days = warmup + 1;
+  if (!every) every = 1;
+
+  // Everything the C library allocates for itself happens before the switch
+  buildForecast();
+  if (!corpusFind("tempest_obs") || !corpusFind("openweather")) {
+    printf("❌ Recorded responses missing (run from the project root or set CORPUS_DIR)\n");
+    return 1;
+  }
+  FILE* csv = csvPath ? fopen(csvPath, "w") : nullptr;
+  if (csv) fprintf(csv, "day,free,largest,frag,holes,live,min_free,min_largest,allocs,failed\n");
+  printf("🧫 Soak: %u days, %u KB heap, %s path\n", (unsigned)days, (unsigned)heapKb,
+         legacy ? "legacy String/JsonDocument" : "arena/text_format");
+  fflush(stdout);
+
+  simHeapBegin((size_t)heapKb * 1024);
+  printf("⚙️ %u bytes of task stacks, queues and sprites held from boot\n\n", (unsigned)bootAllocations());
+  printf("%5s %8s %8s %7s %6s %6s %8s %8s %9s %6s\n", "day", "freeKB", "bigKB", "frag%", "holes",
+         "live", "minFreeK", "minBigK", "allocs", "fail");
+
+  Window first = {};
+  Window window = {};
+  double worstFrag = 0;
+  uint32_t worstDay = 0;
+  const uint32_t end = EPOCH_START + days * DAY_SEC;
+  for (uint32_t day = 1; now < end; day++) {
+    window = {};
+    window.allocs = simHeapStats().allocs;
+    window.failed = simHeapStats().failed;
+    simHeapResetMarks();
+    const uint32_t dayEnd = now + DAY_SEC;
+    for (; now < dayEnd; now += RENDER_EVERY_SEC) {
+      netTick(now);
+      if (now % OBS_EVERY_SEC == 0) {
+        fetchRound(now % LONDON_EVERY_SEC == 0, now % FORECAST_EVERY_SEC == 0);
+        sample(window);
+      }
+      render((now / RENDER_EVERY_SEC) % (SCREEN_FORECAST + 1));
+    }
+    closeWindow(window, day, day % every == 0 || now >= end, csv);
+    if (day == warmup + 1) first = window;
+    if (day > warmup && meanFrag(window) > worstFrag) {
+      worstFrag = meanFrag(window);
+      worstDay = day;
+    }
+  }
+  simHeapEnd();
+  if (csv) fclose(csv);
+
+  const SimHeapStats& h = simHeapStats();
+  double growth = (meanFrag(window) - meanFrag(first)) * 100;
+  double leaked = meanUsed(window) - meanUsed(first);
+  printf("\n%llu allocations, %llu TLS handshakes, %llu failed fetches, %llu decode failures\n",
+         (unsigned long long)h.allocs, (unsigned long long)handshakes,
+         (unsigned long long)fetchFailures, (unsigned long long)decodeFailures);
+  printf("Fragmentation day %u → %u: %.2f%% → %.2f%% (%+.2f points), idle live bytes %+.0f\n",
+         (unsigned)(warmup + 1), (unsigned)days, meanFrag(first) * 100, meanFrag(window) * 100,
+         growth, leaked);
+  printf("Worst day after warm-up: day %u at %.2f%%\n", (unsigned)worstDay, worstFrag * 100);
+
+  bool failed = false;
+  if (h.failed) {
+    printf("❌ %llu allocations refused\n", (unsigned long long)h.failed);
+    failed = true;
+  }
+  if (growth > maxGrowth) {
+    printf("❌ Steady-state fragmentation grew by more than %.1f points\n", maxGrowth);
+    failed = true;
+  }
+  if (worstFrag * 100 > maxFrag) {
+    printf("❌ Day %u averaged %.2f%% fragmentation, over the %.1f%% ceiling\n", (unsigned)worstDay,
+           worstFrag * 100, maxFrag);
+    failed = true;
+  }
+  if (leaked > LEAK_SLACK_BYTES) {
+    printf("❌ Idle heap use grew by %.0f bytes\n", leaked);
+    failed = true;
+  }
+  if (decodeFailures) {
+    printf("❌ %llu payloads didn't decode\n", (unsigned long long)decodeFailures);
+    failed = true;
+  }
+  if (!failed) printf("✅ Heap steady\n");
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,301 @@
+#include <Arduino.h>
+#include <vector>
+#include "stats.h"
+
+// 📊 stats.cpp against a brute-force scan of the raw samples
+//
+//   program [--seed n] [--verbose]
+//
+// Sample streams go through statsAdd() while a plain list keeps what each
+// tier accepted. After a sample (and at later times, to watch the windows
+// empty out) every metric and tier is queried and min/max/mean/total and
+// the trend are compared with a scan of the list: same bucket rules (a
+// sample counts while its bucket is one of the window's last cap, a sample
+// older than the open bucket is dropped), same fixed-point values, no
+// running sums or deques. A NaN reading is missing for its metric only.
+// Exits non-zero if any check failed.
+
+struct TierRule {
+  uint32_t width;    // Seconds per bucket, as in stats.cpp
+  uint32_t cap;      // Buckets per window
+};
+
+static const TierRule RULES[WINDOW_COUNT] = { { 60, 60 }, { 600, 144 }, { 3600, 168 } };
+static const float SCALE[STAT_METRIC_COUNT] = { 10, 10, 10, 10, 10, 100, 10 };
+static const char* METRIC_NAMES[STAT_METRIC_COUNT] = { "temp", "pressure", "humidity", "wind_avg",
+                                                       "wind_gust", "rain", "uv" };
+static const char* WINDOW_NAMES[WINDOW_COUNT] = { "1h", "24h", "7d" };
+
+struct RawSample {
+  uint32_t timestamp;
+  int16_t v[STAT_METRIC_COUNT];
+};
+
+// What each tier kept: everything not older than its open bucket
+static std::vector<RawSample> kept[WINDOW_COUNT];
+static uint32_t failures = 0;
+static uint32_t queries = 0;
+static bool verbose = false;
+
+static const int16_t MISSING = INT16_MIN;
+
+static int16_t quantize(float v, uint8_t m) {
+  if (isnan(v)) return MISSING;
+  float q = roundf(v * SCALE[m]);
+  if (q > INT16_MAX) return INT16_MAX;
+  if (q <= MISSING) return MISSING + 1;
+  return (int16_t)q;
+}
+
+static void add(const HistorySample& s) {
+  statsAdd(s);
+  RawSample r;
+  r.timestamp = s.timestamp;
+  const float raw[STAT_METRIC_COUNT] = { s.temp_f, s.pressure_mb, s.humidity, s.wind_avg,
+                                         s.wind_gust, s.rain_mm, s.uv };
+  for (uint8_t m = 0; m < STAT_METRIC_COUNT; m++) r.v[m] = quantize(raw[m], m);
+  for (uint8_t w = 0; w < WINDOW_COUNT; w++) {
+    std::vector<RawSample>& k = kept[w];
+    if (!k.empty() && s.timestamp / RULES[w].width < k.back().timestamp / RULES[w].width) continue;
+    k.push_back(r);
+  }
+}
+
+static void clearAll() {
+  statsClear();
+  for (uint8_t w = 0; w < WINDOW_COUNT; w++) kept[w].clear();
+}
+
+// The brute-force answer; false when the window holds nothing
+static bool scan(uint8_t metric, uint8_t window, uint32_t now, StatSummary& out) {
+  const TierRule& r = RULES[window];
+  uint32_t nowSeq = now / r.width;
+  uint32_t n = 0, buckets = 0, lastSeq = 0, firstSeq = 0;
+  int64_t sum = 0;
+  int16_t lo = INT16_MAX, hi = INT16_MIN;
+  double st = 0, stt = 0, sty = 0;
+
+  for (const RawSample& s : kept[window]) {
+    uint32_t seq = s.timestamp / r.width;
+    if (seq + r.cap <= nowSeq) continue;
+    int16_t v = s.v[metric];
+    if (v == MISSING) continue;
+    if (n == 0) firstSeq = seq;
+    if (n == 0 || seq != lastSeq) buckets++;
+    lastSeq = seq;
+    double h = (double)(seq - firstSeq) * r.width / 3600.0;
+    n++;
+    sum += v;
+    if (v < lo) lo = v;
+    if (v > hi) hi = v;
+    st += h;
+    stt += h * h;
+    sty += h * v;
+  }
+  if (n == 0) return false;
+
+  float scale = SCALE[metric];
+  out.samples = n;
+  out.min = lo / scale;
+  out.max = hi / scale;
+  out.total = sum / scale;
+  out.mean = out.total / n;
+  double denom = n * stt - st * st;
+  out.trendPerHour = buckets >= 2 && fabs(denom) > 1e-9 ? (float)((n * sty - st * sum) / denom / scale) : 0;
+  return true;
+}
+
+static bool near(float got, float want, float tol) {
+  return fabs(got - want) <= tol * (1 + fabs(want));
+}
+
+// Every metric and tier at now; returns the number of mismatches
+static uint32_t compareAll(uint32_t now, const char* stream) {
+  uint32_t bad = 0;
+  for (uint8_t w = 0; w < WINDOW_COUNT; w++) {
+    for (uint8_t m = 0; m < STAT_METRIC_COUNT; m++) {
+      StatSummary got = {}, want = {};
+      bool gotAny = statsQuery((StatMetric)m, (StatWindow)w, now, got);
+      bool wantAny = scan(m, w, now, want);
+      queries++;
+      bool ok = gotAny == wantAny;
+      if (ok && wantAny) {
+        ok = got.samples == want.samples && got.min == want.min && got.max == want.max &&
+             near(got.total, want.total, 1e-6f) && near(got.mean, want.mean, 1e-5f) &&
+             near(got.trendPerHour, want.trendPerHour, 1e-3f);
+      }
+      if (!ok && (verbose || bad == 0)) {
+        printf("   %s %s/%s at %lu: got %s n=%lu min=%g max=%g mean=%g slope=%g, "
+               "wanted %s n=%lu min=%g max=%g mean=%g slope=%g\n",
+               stream, METRIC_NAMES[m], WINDOW_NAMES[w], (unsigned long)now, gotAny ? "some" : "none",
+               (unsigned long)got.samples, got.min, got.max, got.mean, got.trendPerHour,
+               wantAny ? "some" : "none", (unsigned long)want.samples, want.min, want.max, want.mean,
+               want.trendPerHour);
+      }
+      if (!ok) bad++;
+    }
+  }
+  return bad;
+}
+
+static void check(bool ok, const char* what) {
+  printf("%s %s\n", ok ? "✅" : "❌", what);
+  if (!ok) failures++;
+}
+
+static float uniform(float lo, float hi) {
+  return lo + (hi - lo) * (rand() / (float)RAND_MAX);
+}
+
+static HistorySample randomSample(uint32_t ts) {
+  HistorySample s;
+  s.timestamp = ts;
+  s.temp_f = uniform(-20, 115);
+  s.pressure_mb = uniform(960, 1050);
+  s.humidity = uniform(0, 100);
+  s.wind_avg = uniform(0, 25);
+  s.wind_gust = s.wind_avg + uniform(0, 15);
+  s.wind_dir = uniform(0, 360);
+  s.rain_mm = rand() % 4 ? 0 : uniform(0, 5);
+  s.uv = uniform(0, 11);
+  return s;
+}
+
+// A slow swing with noise, so the trend has something to find
+static HistorySample driftingSample(uint32_t ts, uint32_t t0) {
+  HistorySample s = randomSample(ts);
+  float hours = (ts - t0) / 3600.0f;
+  s.temp_f = 60 + 15 * sinf(hours * 0.26f) + uniform(-0.5f, 0.5f);
+  s.pressure_mb = 1010 + 0.4f * hours + uniform(-0.2f, 0.2f);
+  return s;
+}
+
+// Query after every step'th sample and mid-way to the next one. The clock
+// never runs backwards (a query evicts for good), so a late reading is
+// queried at the newest time seen so far.
+static uint32_t feed(const std::vector<HistorySample>& stream, uint32_t step, const char* name) {
+  uint32_t bad = 0;
+  uint32_t newest = 0;
+  for (size_t i = 0; i < stream.size(); i++) {
+    add(stream[i]);
+    if (stream[i].timestamp > newest) newest = stream[i].timestamp;
+    if (i % step) continue;
+    bad += compareAll(newest, name);
+    if (i + 1 < stream.size() && stream[i + 1].timestamp > newest) {
+      bad += compareAll(newest + (stream[i + 1].timestamp - newest) / 2, name);
+    }
+  }
+  return bad;
+}
+
+int main(int argc, char** argv) {
+  unsigned seed = 1;
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--seed") && i + 1 < argc) seed = strtoul(argv[++i], nullptr, 10);
+    else if (!strcmp(argv[i], "--verbose")) verbose = true;
+  }
+  srand(seed);
+  printf("📊 stats.cpp against a brute-force scan, seed %u\n", seed);
+  const uint32_t T0 = 1700000000;
+
+  // Empty: nothing added, or cleared after adding
+  clearAll();
+  StatSummary s = {};
+  bool none = !statsQuery(STAT_TEMP, WINDOW_1H, T0, s) && !statsQuery(STAT_UV, WINDOW_7D, T0, s);
+  add(randomSample(T0));
+  clearAll();
+  none = none && !statsQuery(STAT_TEMP, WINDOW_24H, T0, s) && compareAll(T0, "empty") == 0;
+  check(none, "Empty windows report nothing, before and after statsClear()");
+  check(!statsQuery(STAT_METRIC_COUNT, WINDOW_1H, T0, s) && !statsQuery(STAT_TEMP, WINDOW_COUNT, T0, s),
+        "Out-of-range metric or window is refused");
+
+  // One reading a minute with random jitter, ten days
+  clearAll();
+  std::vector<HistorySample> stream;
+  for (uint32_t ts = T0; ts < T0 + 10 * 86400; ts += 30 + rand() % 61) stream.push_back(randomSample(ts));
+  uint32_t bad = feed(stream, 7, "random");
+  check(bad == 0, "Random readings, about one a minute for ten days: every tier matches");
+
+  // Drifting values so the slope is non-trivial, with repeats of a timestamp
+  clearAll();
+  stream.clear();
+  for (uint32_t ts = T0; ts < T0 + 9 * 86400; ts += (rand() % 5 ? 60 : 0)) stream.push_back(driftingSample(ts, T0));
+  bad = feed(stream, 5, "drift");
+  check(bad == 0, "Trending readings with repeated timestamps: slopes match");
+
+  // Gaps: bursts of readings separated by silences shorter and longer than
+  // each window, plus late readings from before the open bucket
+  clearAll();
+  stream.clear();
+  uint32_t ts = T0;
+  static const uint32_t GAPS[] = { 90, 1800, 3 * 3600, 20 * 3600, 30 * 3600, 5 * 86400, 8 * 86400 };
+  for (uint8_t burst = 0; burst < 40; burst++) {
+    uint32_t readings = 1 + rand() % 120;
+    for (uint32_t i = 0; i < readings; i++) {
+      ts += 10 + rand() % 300;
+      stream.push_back(randomSample(ts));
+      if (rand() % 10 == 0) stream.push_back(randomSample(ts - rand() % 7200));
+    }
+    ts += GAPS[rand() % (sizeof(GAPS) / sizeof(GAPS[0]))];
+  }
+  bad = feed(stream, 1, "gappy");
+  check(bad == 0, "Bursts, gaps of minutes to days and late readings: every tier matches");
+
+  // Expiry: after the last reading, step the clock until every window is
+  // empty; each tier has to let go exactly when its last bucket leaves
+  uint32_t last = 0;
+  for (const HistorySample& h : stream) last = max(last, h.timestamp);
+  bad = 0;
+  bool emptied = false;
+  for (uint32_t t = last; t <= last + 8 * 86400; t += 59) {
+    bad += compareAll(t, "expiry");
+    emptied = !statsQuery(STAT_TEMP, WINDOW_7D, t, s);
+    if (emptied) break;
+  }
+  check(bad == 0 && emptied, "Windows drain bucket by bucket after the last reading, then report nothing");
+
+  // Readings resume after everything expired: no leftovers from before
+  for (uint32_t i = 0; i < 200; i++) add(randomSample(last + 9 * 86400 + i * 60));
+  check(compareAll(last + 9 * 86400 + 200 * 60, "resume") == 0, "Readings after a full expiry start clean");
+
+  // Missing readings: a NaN leaves its metric alone, not a zero in min/mean
+  clearAll();
+  HistorySample h = randomSample(T0);
+  h.temp_f = 50;
+  add(h);
+  h.timestamp += 60;
+  h.temp_f = NAN;
+  add(h);
+  h.timestamp += 60;
+  h.temp_f = 70;
+  add(h);
+  bool skipped = statsQuery(STAT_TEMP, WINDOW_1H, h.timestamp, s) && s.samples == 2 && s.min == 50 &&
+                 s.mean == 60 && statsQuery(STAT_UV, WINDOW_1H, h.timestamp, s) && s.samples == 3;
+  check(skipped, "A NaN reading is skipped: min and mean come from the readings there are");
+
+  // Gaps per metric: random NaNs everywhere, UV absent for the first two
+  // days and the gust never reported
+  clearAll();
+  stream.clear();
+  for (uint32_t ts = T0; ts < T0 + 9 * 86400; ts += 30 + rand() % 61) {
+    HistorySample n = driftingSample(ts, T0);
+    if (rand() % 4 == 0) n.temp_f = NAN;
+    if (rand() % 7 == 0) n.pressure_mb = NAN;
+    if (rand() % 3 == 0) n.rain_mm = NAN;
+    if (ts < T0 + 2 * 86400) n.uv = NAN;
+    n.wind_gust = NAN;
+    stream.push_back(n);
+  }
+  bad = feed(stream, 5, "missing");
+  check(bad == 0 && !statsQuery(STAT_WIND_GUST, WINDOW_7D, T0 + 9 * 86400, s) &&
+            statsQuery(STAT_WIND_AVG, WINDOW_7D, T0 + 9 * 86400, s),
+        "Readings missing per metric: each metric counts only its own, a never-seen one reports nothing");
+
+  printf("📊 %lu queries compared\n", (unsigned long)queries);
+  if (failures) {
+    printf("❌ %lu checks failed\n", (unsigned long)failures);
+    return 1;
+  }
+  printf("✅ Rolling stats match the brute-force scan\n");
+  return 0;
+}
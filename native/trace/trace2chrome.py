@@ -0,0 +1,140 @@
+#!/usr/bin/env python3
+"""🧵 Trace ring dump → Chrome trace JSON
+
+  python3 trace2chrome.py serial.log -o refresh.json
+  python3 trace2chrome.py --url http://display.local:9100/trace -o refresh.json
+
+Reads the dump src/trace.cpp writes (over serial after typing "trace", or
+GET /trace on the metrics port) from a file, stdin ("-") or a URL, and
+writes JSON for chrome://tracing or ui.perfetto.dev. The last dump in the
+input wins, so a whole monitor log can be passed as is.
+
+Each event is 8 bytes, little-endian: micros (u32), phase, task, name, id.
+Single-task spans become B/E events on their task's track. A request's
+network stages are nestable async spans (b/e) under "slot <id>". micros()
+wraps every 71 minutes, so timestamps are unwrapped and made relative to
+the oldest event. Ends whose begin was already overwritten are dropped.
+"""
+
+import argparse
+import collections
+import json
+import re
+import struct
+import sys
+import urllib.request
+
+HEADER = re.compile(r"=== TRACE v1 events=(\d+) dropped=(\d+) now=(\d+) ===")
+FOOTER = "=== TRACE END ==="
+# pio device monitor can prefix "12:00:01.123 > "
+PREFIX = re.compile(r"^\d\d:\d\d:\d\d\.\d+ > ")
+
+
+def read_input(args):
+    if args.url:
+        with urllib.request.urlopen(args.url, timeout=30) as res:
+            return res.read().decode(errors="replace")
+    if args.input in (None, "-"):
+        return sys.stdin.read()
+    with open(args.input, errors="replace") as f:
+        return f.read()
+
+
+def last_dump(text):
+    """(header match, task names, event names, raw events) of the last complete dump"""
+    found = None
+    lines = [PREFIX.sub("", l).strip() for l in text.splitlines()]
+    for i, line in enumerate(lines):
+        m = HEADER.search(line)
+        if not m:
+            continue
+        tasks, names, raw = {}, {}, bytearray()
+        for line in lines[i + 1:]:
+            if line == FOOTER:
+                found = (m, tasks, names, bytes(raw))
+                break
+            kind, _, rest = line.partition(" ")
+            if kind == "T" or kind == "N":
+                ident, _, name = rest.partition(" ")
+                (tasks if kind == "T" else names)[int(ident)] = name
+            elif kind == "E":
+                raw += bytes.fromhex(rest)
+    if not found:
+        sys.exit("❌ No complete trace dump in the input")
+    return found
+
+
+def convert(header, tasks, names, raw):
+    events = []
+    for pid_task, task in tasks.items():
+        events.append({"name": "thread_name", "ph": "M", "pid": 1, "tid": pid_task,
+                       "args": {"name": task}})
+    events.append({"name": "process_name", "ph": "M", "pid": 1, "args": {"name": "tempest display"}})
+
+    stacks = collections.defaultdict(list)   # tid → open B names
+    open_async = collections.defaultdict(list)  # slot → open b names
+    wraps, prev, first = 0, None, None
+    counts = collections.Counter()
+    orphans = 0
+
+    for off in range(0, len(raw) - 7, 8):
+        us, phase, task, name_id, ident = struct.unpack_from("<IBBBB", raw, off)
+        if prev is not None and us < prev and prev - us > 1 << 31:
+            wraps += 1
+        prev = us
+        ts = us + (wraps << 32)
+        if first is None:
+            first = ts
+        name = names.get(name_id, f"#{name_id}")
+        ph = chr(phase)
+        e = {"name": name, "ph": ph, "ts": ts - first, "pid": 1, "tid": task}
+
+        if ph == "B":
+            stacks[task].append(name)
+        elif ph == "E":
+            if name not in stacks[task]:
+                orphans += 1
+                continue
+            while stacks[task].pop() != name:
+                pass
+        elif ph == "i":
+            e["s"] = "t"
+            e["args"] = {"id": ident}
+        elif ph in "be":
+            e["cat"] = "http"
+            e["id"] = f"slot {ident}"
+            if ph == "b":
+                open_async[ident].append(name)
+            elif name in open_async[ident]:
+                open_async[ident].remove(name)
+            else:
+                orphans += 1
+                continue
+        counts[name] += ph in "Bbi"
+        events.append(e)
+
+    span = (prev + (wraps << 32) - first) if first is not None else 0
+    return events, counts, orphans, span
+
+
+def main():
+    ap = argparse.ArgumentParser(description="Convert a tempest trace dump to Chrome trace JSON")
+    ap.add_argument("input", nargs="?", help="Serial log or saved /trace body, - for stdin")
+    ap.add_argument("--url", help="Fetch the dump from the display instead")
+    ap.add_argument("-o", "--output", default="trace.json")
+    args = ap.parse_args()
+
+    header, tasks, names, raw = last_dump(read_input(args))
+    events, counts, orphans, span = convert(header, tasks, names, raw)
+    with open(args.output, "w") as f:
+        json.dump({"traceEvents": events, "displayTimeUnit": "ms",
+                   "otherData": {"dropped": int(header.group(2))}}, f)
+
+    print(f"🧵 {len(raw) // 8} events over {span / 1e6:.3f} s on {len(tasks)} tasks "
+          f"({header.group(2)} dropped, {orphans} orphan ends) → {args.output}")
+    for name, n in counts.most_common():
+        print(f"   {name:<14} {n}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,747 @@
+#include "api.h"
+#include "screens.h"
+#include <WiFi.h>
+#include <WiFiManager.h>     // Captive portal WiFi config
+#include "async_http.h"
+#include "api_routes.h"
+#include "weather_parse.h"
+#include "backfill.h"
+#include <esp_wifi.h>
+#include "radio.h"
+#include "tempest_udp.h"
+#include "perf.h"
+#include "trace.h"
+
+// 📲 OpenWeatherMap API for London
+const char* OPENWEATHER_API_KEY = "OPEN_WEATHER_API_KEY";
+const char* OPENWEATHER_LONDON_URL = OPENWEATHER_API_BASE OPENWEATHER_LONDON_PATH;
+
+// 🌤️ Tempest stations, shown in turn on the Tempest screen (add a line per
+// station when gifting multiple). The first one also backs the history,
+// the backfill and the forecast.
+struct TempestStation {
+  long id;
+  const char* name;
+};
+static const TempestStation TEMPEST_STATIONS[] = {
+  { 170405, "San Diego" },
+};
+static const uint8_t STATION_COUNT = sizeof(TEMPEST_STATIONS) / sizeof(TEMPEST_STATIONS[0]);
+static_assert(STATION_COUNT >= 1 && STATION_COUNT <= TEMPEST_STATION_MAX, "1..8 Tempest stations");
+
+const char* TEMPEST_API_URL = TEMPEST_API_BASE TEMPEST_OBS_PATH;
+const char* TEMPEST_API_KEY = "Tempest_API_KEY";
+const char* TEMPEST_STATION_META_URL = TEMPEST_API_BASE TEMPEST_STATION_META_PATH;
+const char* TEMPEST_DEVICE_OBS_URL = TEMPEST_API_BASE TEMPEST_DEVICE_OBS_PATH;
+const char* TEMPEST_FORECAST_URL = TEMPEST_API_BASE TEMPEST_FORECAST_PATH;
+
+// 🧵 Worker plumbing
+static QueueHandle_t fetchRequests = nullptr;  // uint8_t screen ids
+static QueueHandle_t fetchResults = nullptr;   // WeatherObs
+static QueueHandle_t backfillSamples = nullptr; // HistorySample
+static QueueHandle_t forecastMailbox = nullptr; // Forecast, latest only
+static const uint8_t BACKFILL_REQUEST = 0xFF;  // Wakes the task like a screen id
+static volatile NetState netState = NET_CONNECTING;
+static bool portalAllowed = true;
+static ConnectionHints hints = {};
+static char etags[SCREEN_COUNT][ETAG_MAX] = {};
+
+// 📻 Duty cycle: radio off when the next planned fetch is far enough away
+static volatile uint32_t plannedFetchAt = 0;   // millis(), 0 = none planned
+static const uint32_t radioOffMinGapMs = 15000;
+static const uint32_t rejoinBackoffMs = 30000;
+static unsigned long lastJoinMs = 2000;        // Last join duration, sets wake lead
+static unsigned long lastJoinAttempt = 0;
+
+static bool waitForWiFi(int retries) {
+  while (WiFi.status() != WL_CONNECTED && retries-- > 0) {
+    vTaskDelay(pdMS_TO_TICKS(500));
+    Serial.print(".");
+  }
+  return WiFi.status() == WL_CONNECTED;
+}
+
+// ⚡ Rejoin the remembered AP on its channel with the old lease
+static bool connectWithHints() {
+  wifi_config_t conf;
+  if (!hints.valid || esp_wifi_get_config(WIFI_IF_STA, &conf) != ESP_OK) return false;
+
+  Serial.println("⚡ Fast reconnect with saved channel/BSSID...");
+  WiFi.config(IPAddress(hints.ip), IPAddress(hints.gateway),
+              IPAddress(hints.subnet), IPAddress(hints.dns));
+  WiFi.begin((const char*)conf.sta.ssid, (const char*)conf.sta.password,
+             hints.channel, hints.bssid);
+  if (waitForWiFi(6)) return true;  // ~3s
+
+  Serial.println("\n⚠️ Fast reconnect failed, falling back to a full join.");
+  hints.valid = 0;
+  WiFi.disconnect();
+  WiFi.config(IPAddress((uint32_t)0), IPAddress((uint32_t)0), IPAddress((uint32_t)0));  // Back to DHCP
+  return false;
+}
+
+static void rememberConnection() {
+  hints.valid = 1;
+  hints.channel = WiFi.channel();
+  memcpy(hints.bssid, WiFi.BSSID(), sizeof(hints.bssid));
+  hints.ip = (uint32_t)WiFi.localIP();
+  hints.gateway = (uint32_t)WiFi.gatewayIP();
+  hints.subnet = (uint32_t)WiFi.subnetMask();
+  hints.dns = (uint32_t)WiFi.dnsIP();
+}
+
+// 📶 Radio up + join with stored credentials (no portal)
+static bool joinWiFi() {
+  unsigned long start = millis();
+  lastJoinAttempt = start;
+  radioPowerUp();
+
+  bool joined = connectWithHints();
+  if (!joined) {
+    WiFi.begin();
+    Serial.println("🌐 Trying saved WiFi credentials...");
+    joined = waitForWiFi(20);  // ~10s
+  }
+  if (!joined) return false;
+
+  Serial.println("\n✅ Connected to WiFi!");
+  rememberConnection();
+  lastJoinMs = millis() - start;
+  return true;
+}
+
+static void connectWiFi() {
+  if (joinWiFi()) {
+    netState = NET_ONLINE;
+    return;
+  }
+
+  if (!portalAllowed) {
+    Serial.println("\n📴 Saved WiFi failed, staying offline for now.");
+    netState = NET_OFFLINE;
+    return;
+  }
+
+  Serial.println("\n⚠️ Saved WiFi failed. Starting WiFiManager AP...");
+  netState = NET_PORTAL;
+
+  WiFiManager wm;
+  wm.setConfigPortalTimeout(300);  // 5 min timeout for safety
+
+  if (!wm.autoConnect("Tempest-Setup")) {
+    Serial.println("❌ WiFiManager failed or timed out. Restarting...");
+    netState = NET_FAILED;
+    vTaskDelay(pdMS_TO_TICKS(3000));  // Let the UI show the failure
+    ESP.restart();
+  }
+
+  Serial.println("✅ Connected via WiFiManager!");
+  rememberConnection();
+  netState = NET_ONLINE;
+}
+
+// Rejoin after a duty-cycle power-down or a dropped AP
+static bool ensureWiFi() {
+  if (radioIsOn() && WiFi.status() == WL_CONNECTED) return true;
+  if (netState == NET_OFFLINE && millis() - lastJoinAttempt < rejoinBackoffMs) return false;
+
+  bool ok = joinWiFi();
+  netState = ok ? NET_ONLINE : NET_OFFLINE;
+  return ok;
+}
+
+// 💤 Between fetches: power off for long gaps, modem-sleep for short ones.
+// Hub broadcasts (TEMPEST_HUB_EVENTS builds only) keep the radio up.
+static void idleRadio() {
+  if (eventListenerRunning()) {
+    radioActive();
+    return;
+  }
+  uint32_t due = plannedFetchAt;
+  int32_t gap = due ? (int32_t)(due - millis()) : 0;
+  if (due && gap > (int32_t)radioOffMinGapMs) {
+    asyncHttpCloseIdle();  // Parked sockets die with the association anyway
+    radioPowerDown();
+  } else {
+    radioModemSleep();
+  }
+}
+
+// ⏰ How long to block before waking the radio ahead of the next fetch
+static TickType_t ticksUntilWake() {
+  uint32_t due = plannedFetchAt;
+  if (radioIsOn() || !due) return portMAX_DELAY;
+
+  uint32_t lead = max(lastJoinMs + 500UL, 1000UL);
+  int32_t wait = (int32_t)(due - lead - millis());
+  return wait > 0 ? pdMS_TO_TICKS(wait) : 0;
+}
+
+// 📥 One in-flight request per source; buffers must outlive the request
+struct SourceFetch {
+  bool busy;
+  WeatherObs obs;
+  char url[192];
+  char headers[160];
+  uint8_t body[4096];
+};
+static SourceFetch sourceFetches[OBS_SCREEN_COUNT];  // The Tempest one serves every station
+
+// ⏱️ Per-station freshness. Tempest publishes once a minute, so a station
+// whose reading just changed isn't asked again until the next one is due;
+// adding stations costs a request each per minute at most, never a handshake.
+struct StationFreshness {
+  bool known;            // Checked since boot
+  uint32_t dueMs;        // millis() when a newer reading can exist
+  uint32_t timestamp;    // Newest observation seen
+  char etag[ETAG_MAX];   // Station 0 keeps its own in etags[] (RTC-backed)
+};
+static StationFreshness freshness[TEMPEST_STATION_MAX];
+static uint8_t pendingStations = 0;               // Bit per station this refresh cycle
+static const uint32_t stationPublishMs = 60000;
+static const uint32_t stationRecheckMs = 10000;   // Unchanged: the next one is close
+
+// 🗓️ better_forecast is streamed into the parser, never buffered
+struct ForecastFetch {
+  bool busy;
+  WeatherObs obs;           // Carries the status back to the UI loop
+  char url[160];
+  char headers[96];
+  ForecastParser parser;
+  Forecast data;
+  uint32_t bytes;
+  uint32_t parseUs;
+};
+static ForecastFetch forecastFetch;
+
+// Everything but London shares swd.weatherflow.com, one request at a time
+static uint8_t deferredScreens = 0;  // Bit per screen waiting for the host
+
+// ⏮️ Backfill: station metadata for the device id, then the rows. Both
+// bodies go straight into streaming decoders; nothing is buffered whole.
+struct Backfill {
+  volatile uint8_t state;   // BackfillState
+  volatile bool pending;    // Next step waits for the Tempest host to free up
+  bool busy;
+  bool paused;              // Rows stopped on a full queue; resume once it drains
+  uint32_t from, to;        // from moves up to the first row not yet queued
+  float seaLevelOffset;
+  long deviceId;
+  DeviceLookup lookup;
+  ObsRowParser rows;
+  char url[192];
+  char headers[96];
+  unsigned long startMs;
+  uint32_t startFreeHeap;
+  uint32_t minFreeHeap;
+  uint32_t bytes;
+  uint32_t queued;          // Rows handed to the UI loop, across every resume
+  uint32_t pauses;
+};
+static Backfill backfill;
+
+static void trackBackfillHeap() {
+  uint32_t freeHeap = ESP.getFreeHeap();
+  if (freeHeap < backfill.minFreeHeap) backfill.minFreeHeap = freeHeap;
+}
+
+static void finishBackfill(bool ok) {
+  trackBackfillHeap();
+  if (ok) {
+    Serial.printf("⏮️ Backfill: %lu rows (%lu pauses) in %lu ms, %lu KB streamed, "
+                  "peak heap %lu bytes (min free %lu)\n",
+                  (unsigned long)backfill.queued, (unsigned long)backfill.pauses,
+                  millis() - backfill.startMs, (unsigned long)(backfill.bytes / 1024),
+                  (unsigned long)(backfill.startFreeHeap - backfill.minFreeHeap),
+                  (unsigned long)backfill.minFreeHeap);
+  } else {
+    Serial.println("❌ Backfill failed, history will fill from live readings");
+  }
+  backfill.busy = false;
+  backfill.pending = false;
+  backfill.state = ok ? BACKFILL_DONE : BACKFILL_FAILED;
+}
+
+// ⏸️ Never blocks the network task: a full queue stops the stream here and
+// the next request picks up from this row once the UI loop has caught up
+static bool queueBackfillSample(const HistorySample& s, void*) {
+  if (xQueueSend(backfillSamples, &s, 0) != pdTRUE) {
+    backfill.from = s.timestamp;
+    backfill.paused = true;
+    return false;
+  }
+  backfill.queued++;
+  return true;
+}
+
+static bool onLookupBody(const uint8_t* data, size_t len, void*) {
+  trackBackfillHeap();
+  backfill.bytes += len;
+  return deviceLookupFeed(backfill.lookup, data, len);  // Stops once found
+}
+
+static void onLookupDone(const AsyncHttpResponse& res, void*) {
+  radioCountBytes(res.bytesSent + res.bytesReceived);
+  perfRecordHttp(res);
+  backfill.busy = false;
+  backfill.deviceId = backfill.lookup.deviceId;
+  if (!backfill.deviceId) {
+    Serial.printf("❌ No Tempest device on the station (error %d, HTTP %d)\n", res.error, res.status);
+    finishBackfill(false);
+    return;
+  }
+  Serial.printf("🔎 Tempest device %ld\n", backfill.deviceId);
+  backfill.pending = true;  // On to the rows
+}
+
+static bool onRowsBody(const uint8_t* data, size_t len, void*) {
+  trackBackfillHeap();
+  backfill.bytes += len;
+  return obsRowsFeed(backfill.rows, data, len);  // Stops after the obs array
+}
+
+static void onRowsDone(const AsyncHttpResponse& res, void*) {
+  radioCountBytes(res.bytesSent + res.bytesReceived);
+  perfRecordHttp(res);
+  bool streamOk = res.error == ASYNC_HTTP_OK || res.error == ASYNC_HTTP_ERR_ABORTED;
+  bool ok = res.status == 200 && streamOk && !jsonStreamFailed(backfill.rows.js);
+  if (ok && backfill.paused) {
+    backfill.busy = false;
+    backfill.pauses++;
+    backfill.pending = true;  // Same rows request from backfill.from
+    return;
+  }
+  if (!ok) Serial.printf("❌ Backfill rows failed (error %d, HTTP %d)\n", res.error, res.status);
+  finishBackfill(ok);
+}
+
+static void startBackfillStep() {
+  backfill.pending = false;
+  backfill.paused = false;
+  snprintf(backfill.headers, sizeof(backfill.headers), "Authorization: Bearer %s\r\n", TEMPEST_API_KEY);
+
+  AsyncHttpRequest req = {};
+  req.url = backfill.url;
+  req.headers = backfill.headers;
+  req.ctx = &backfill;
+  req.timeoutMs = 60000;
+  req.keepAlive = true;
+
+  if (!backfill.deviceId) {
+    snprintf(backfill.url, sizeof(backfill.url), "%s%ld", TEMPEST_STATION_META_URL,
+             TEMPEST_STATIONS[0].id);
+    deviceLookupBegin(backfill.lookup);
+    req.onBody = onLookupBody;
+    req.onDone = onLookupDone;
+  } else {
+    snprintf(backfill.url, sizeof(backfill.url), "%s%ld?time_start=%lu&time_end=%lu",
+             TEMPEST_DEVICE_OBS_URL, backfill.deviceId,
+             (unsigned long)backfill.from, (unsigned long)backfill.to);
+    obsRowsBegin(backfill.rows, backfill.seaLevelOffset, queueBackfillSample, nullptr);
+    req.onBody = onRowsBody;
+    req.onDone = onRowsDone;
+  }
+
+  backfill.busy = asyncHttpStart(req);
+  if (!backfill.busy) finishBackfill(false);
+}
+
+static void postResult(const WeatherObs& obs) {
+  xQueueSend(fetchResults, &obs, 0);
+}
+
+static const char* fetchTitle(const WeatherObs& obs) {
+  return obs.screen == SCREEN_SAN_DIEGO ? TEMPEST_STATIONS[obs.station].name : screenTitle(obs.screen);
+}
+
+// 🏷️ Station 0 and London keep theirs in etags[], the other stations here
+static const char* validatorFor(const WeatherObs& obs) {
+  if (obs.screen == SCREEN_SAN_DIEGO && obs.station) return freshness[obs.station].etag;
+  return etags[obs.screen];
+}
+
+static void rememberValidator(const WeatherObs& obs, const char* etag) {
+  if (obs.screen == SCREEN_SAN_DIEGO && obs.station) {
+    strlcpy(freshness[obs.station].etag, etag, ETAG_MAX);
+  } else {
+    setCacheValidator(obs.screen, etag);
+  }
+}
+
+// ⏱️ A changed reading means the next is a minute out, an unchanged one is close
+static void updateFreshness(const WeatherObs& obs) {
+  if (obs.screen != SCREEN_SAN_DIEGO) return;
+  StationFreshness& st = freshness[obs.station];
+  if (obs.status != FETCH_OK && obs.status != FETCH_NOT_MODIFIED) {
+    st.known = false;  // Due again right away
+    return;
+  }
+  bool changed = obs.status == FETCH_OK && obs.timestamp != st.timestamp;
+  if (obs.status == FETCH_OK) st.timestamp = obs.timestamp;
+  st.known = true;
+  st.dueMs = millis() + (changed ? stationPublishMs : stationRecheckMs);
+}
+
+static bool stationDue(uint8_t station) {
+  const StationFreshness& st = freshness[station];
+  return !st.known || (int32_t)(millis() - st.dueMs) >= 0;
+}
+
+static void postFailure(uint8_t screen) {
+  WeatherObs obs = {};
+  obs.screen = screen;
+  obs.status = FETCH_HTTP_ERROR;
+  postResult(obs);
+}
+
+static void onFetchDone(const AsyncHttpResponse& res, void* ctx) {
+  SourceFetch& f = *(SourceFetch*)ctx;
+  WeatherObs& obs = f.obs;
+  f.busy = false;
+  radioCountBytes(res.bytesSent + res.bytesReceived);
+  perfRecordHttp(res);
+
+  if (res.error != ASYNC_HTTP_OK || (res.status != 200 && res.status != 304)) {
+    Serial.printf("❌ %s fetch failed (error %d, HTTP %d)\n",
+                  fetchTitle(obs), res.error, res.status);
+    obs.status = FETCH_HTTP_ERROR;
+    updateFreshness(obs);
+    postResult(obs);
+    return;
+  }
+
+  char how[96] = "";
+  if (res.reused) {
+    strlcpy(how, " (kept-alive)", sizeof(how));
+  } else if (res.tlsUs) {
+    int n = snprintf(how, sizeof(how), " (TLS %lu ms, %s handshake", (unsigned long)(res.tlsUs / 1000),
+                     res.tlsResumed ? "resumed" : "full");
+    if (res.tlsRecordIn) {
+      n += snprintf(how + n, sizeof(how) - n, ", %u B records, %lu B heap saved",
+                    res.tlsRecordIn, (unsigned long)res.tlsHeapSaved);
+    }
+    snprintf(how + n, sizeof(how) - n, ")");
+  }
+  Serial.printf("⏱️ %s fetched in %lu ms%s\n", fetchTitle(obs), (unsigned long)res.elapsedMs, how);
+  if (res.status == 304) {
+    obs.status = FETCH_NOT_MODIFIED;
+    updateFreshness(obs);
+    postResult(obs);
+    return;
+  }
+
+  Serial.println(obs.screen == SCREEN_SAN_DIEGO ? "📡 Weather API Response:" : "🌍 London Weather API Response:");
+  Serial.write(res.body, res.bodyLen);
+  Serial.println();
+
+  const char* json = (const char*)res.body;
+  uint32_t parseStart = micros();
+  traceBegin(TRACE_PARSE);
+  bool ok = obs.screen == SCREEN_SAN_DIEGO ? parseTempest(json, res.bodyLen, obs)
+                                           : parseLondon(json, res.bodyLen, obs);
+  traceEnd(TRACE_PARSE);
+  perfRecord(PERF_PARSE, micros() - parseStart);
+  if (ok) {
+    rememberValidator(obs, res.etag);
+  } else {
+    Serial.println("❌ JSON Parse Failed!");
+    rememberValidator(obs, "");  // Never 304 onto a reading we lost
+  }
+  updateFreshness(obs);
+  postResult(obs);
+}
+
+static bool onForecastBody(const uint8_t* data, size_t len, void*) {
+  uint32_t start = micros();
+  traceBegin(TRACE_FORECAST);
+  bool more = forecastParseFeed(forecastFetch.parser, data, len);  // Stops once full
+  traceEnd(TRACE_FORECAST);
+  forecastFetch.parseUs += micros() - start;
+  forecastFetch.bytes += len;
+  return more;
+}
+
+static void onForecastDone(const AsyncHttpResponse& res, void*) {
+  ForecastFetch& f = forecastFetch;
+  f.busy = false;
+  radioCountBytes(res.bytesSent + res.bytesReceived);
+  perfRecordHttp(res);
+
+  bool streamOk = res.error == ASYNC_HTTP_OK || res.error == ASYNC_HTTP_ERR_ABORTED;
+  if (!streamOk || res.status != 200) {
+    Serial.printf("❌ Forecast fetch failed (error %d, HTTP %d)\n", res.error, res.status);
+    f.obs.status = FETCH_HTTP_ERROR;
+    postResult(f.obs);
+    return;
+  }
+  if (!forecastParseOk(f.parser)) {
+    Serial.println("❌ Forecast parse failed!");
+    f.obs.status = FETCH_JSON_ERROR;
+    postResult(f.obs);
+    return;
+  }
+
+  perfRecord(PERF_FORECAST, f.parseUs);
+  Serial.printf("🗓️ Forecast: %u hours, %u days from %lu bytes in %lu ms (parse %lu us, %u bytes of state)\n",
+                f.data.hourCount, f.data.dayCount, (unsigned long)f.bytes,
+                (unsigned long)res.elapsedMs, (unsigned long)f.parseUs,
+                (unsigned)(sizeof(f.parser) + sizeof(f.data)));
+  xQueueOverwrite(forecastMailbox, &f.data);
+  f.obs.status = FETCH_OK;
+  f.obs.timestamp = f.data.hours[0].time;
+  f.obs.temp_f = f.data.hours[0].temp_f;
+  postResult(f.obs);
+}
+
+static void startForecastFetch() {
+  ForecastFetch& f = forecastFetch;
+  f.obs = {};
+  f.obs.screen = SCREEN_FORECAST;
+  f.bytes = 0;
+  f.parseUs = 0;
+  forecastParseBegin(f.parser, f.data);
+  snprintf(f.url, sizeof(f.url), "%s%ld", TEMPEST_FORECAST_URL, TEMPEST_STATIONS[0].id);
+  snprintf(f.headers, sizeof(f.headers), "Authorization: Bearer %s\r\n", TEMPEST_API_KEY);
+
+  AsyncHttpRequest req = {};
+  req.url = f.url;
+  req.headers = f.headers;
+  req.onBody = onForecastBody;
+  req.onDone = onForecastDone;
+  req.ctx = &f;
+  req.timeoutMs = 15000;
+  req.keepAlive = true;
+
+  f.busy = asyncHttpStart(req);
+  if (!f.busy) postFailure(SCREEN_FORECAST);
+}
+
+static bool usesTempestHost(uint8_t screen) {
+  return screen != SCREEN_LONDON;
+}
+
+static bool tempestHostBusy() {
+  return sourceFetches[SCREEN_SAN_DIEGO].busy || forecastFetch.busy || backfill.busy;
+}
+
+// Host free, and after a pause the queue empty again
+static bool backfillReady() {
+  return backfill.pending && !tempestHostBusy() && uxQueueMessagesWaiting(backfillSamples) == 0;
+}
+
+static void startSourceFetch(SourceFetch& f, bool keepAlive) {
+  AsyncHttpRequest req = {};
+  req.url = f.url;
+  req.headers = f.headers;
+  req.bodyBuf = f.body;
+  req.bodyCap = sizeof(f.body);
+  req.onDone = onFetchDone;
+  req.ctx = &f;
+  req.timeoutMs = 15000;
+  req.keepAlive = keepAlive;
+
+  f.busy = asyncHttpStart(req);
+  if (!f.busy) {
+    f.obs.status = FETCH_HTTP_ERROR;
+    postResult(f.obs);
+  }
+}
+
+// 🌤️ Next station of the refresh cycle; they queue behind each other on
+// the one Tempest connection, so the TLS handshake is paid once per cycle
+static void startNextStation() {
+  uint8_t station = 0;
+  while (!(pendingStations & (1 << station))) station++;
+  pendingStations &= ~(1 << station);
+
+  SourceFetch& f = sourceFetches[SCREEN_SAN_DIEGO];
+  f.obs = {};
+  f.obs.screen = SCREEN_SAN_DIEGO;
+  f.obs.station = station;
+  snprintf(f.url, sizeof(f.url), "%s%ld", TEMPEST_API_URL, TEMPEST_STATIONS[station].id);
+  int n = snprintf(f.headers, sizeof(f.headers), "Authorization: Bearer %s\r\n", TEMPEST_API_KEY);
+  const char* etag = validatorFor(f.obs);
+  if (etag[0]) snprintf(f.headers + n, sizeof(f.headers) - n, "If-None-Match: %s\r\n", etag);
+
+  startSourceFetch(f, true);
+}
+
+static void queueDueStations() {
+  const SourceFetch& f = sourceFetches[SCREEN_SAN_DIEGO];
+  uint8_t due = 0;
+  for (uint8_t i = 0; i < STATION_COUNT; i++) {
+    if (f.busy && f.obs.station == i) continue;  // Already on its way
+    if (stationDue(i)) {
+      pendingStations |= 1 << i;
+      due++;
+    } else if (i == 0) {
+      // 🏷️ Nothing newer can exist yet: what the UI has is current
+      WeatherObs obs = {};
+      obs.screen = SCREEN_SAN_DIEGO;
+      obs.status = FETCH_NOT_MODIFIED;
+      postResult(obs);
+    }
+  }
+  if (STATION_COUNT > 1) Serial.printf("🌤️ %u of %u stations due\n", due, STATION_COUNT);
+  if (pendingStations && !tempestHostBusy()) startNextStation();
+}
+
+// 🚀 Queue the request on the async client; it runs alongside the others
+static void startFetch(uint8_t screen) {
+  if (screen >= FETCHED_SCREEN_COUNT) return;  // Live screens; BACKFILL_REQUEST is picked up via backfill.pending
+  if (screen == SCREEN_SAN_DIEGO) {
+    queueDueStations();  // The rest start as the Tempest host frees up
+    return;
+  }
+  bool busy = screen == SCREEN_FORECAST ? forecastFetch.busy : sourceFetches[screen].busy;
+  if (busy) return;  // Already on its way
+  if (usesTempestHost(screen) && tempestHostBusy()) {
+    deferredScreens |= 1 << screen;  // Goes out when the host frees up
+    return;
+  }
+  if (screen == SCREEN_FORECAST) {
+    startForecastFetch();
+    return;
+  }
+
+  SourceFetch& f = sourceFetches[screen];
+  f.obs = {};
+  f.obs.screen = screen;
+  snprintf(f.url, sizeof(f.url), "%s%s", OPENWEATHER_LONDON_URL, OPENWEATHER_API_KEY);
+  f.headers[0] = '\0';
+  // 🏷️ Conditional GET
+  if (etags[screen][0]) snprintf(f.headers, sizeof(f.headers), "If-None-Match: %s\r\n", etags[screen]);
+
+  startSourceFetch(f, false);  // One request a cycle; nothing to keep alive for
+}
+
+static void networkTask(void*) {
+  perfWatchTask("net");
+  connectWiFi();
+
+  for (;;) {
+    uint8_t screen;
+    if (asyncHttpIdle()) {
+      // A paused backfill only waits for the UI loop to drain the queue
+      TickType_t wait = backfill.pending ? pdMS_TO_TICKS(20) : ticksUntilWake();
+      if (xQueueReceive(fetchRequests, &screen, wait) != pdTRUE) {
+        bool online = ensureWiFi();  // Joined and idle by the time the fetch is due
+        if (online && backfillReady()) {
+          startBackfillStep();
+        } else if (!backfill.pending) {
+          radioModemSleep();
+        }
+        continue;
+      }
+      if (!ensureWiFi()) {
+        if (screen == BACKFILL_REQUEST) {
+          finishBackfill(false);
+        } else {
+          postFailure(screen);
+        }
+        continue;
+      }
+      radioActive();
+      startFetch(screen);
+    }
+
+    // 🧺 Anything else queued shares this round trip
+    while (xQueueReceive(fetchRequests, &screen, 0) == pdTRUE) startFetch(screen);
+
+    asyncHttpPoll(50);
+
+    // 🔁 Stations first, then the other live screens, then the backfill, as
+    // the Tempest host frees up
+    if (pendingStations && !tempestHostBusy()) startNextStation();
+    for (uint8_t s = 0; s < FETCHED_SCREEN_COUNT && deferredScreens && !tempestHostBusy(); s++) {
+      if (!(deferredScreens & (1 << s))) continue;
+      deferredScreens &= ~(1 << s);
+      startFetch(s);
+    }
+    if (backfillReady()) startBackfillStep();
+
+    if (asyncHttpIdle() && !backfill.pending && uxQueueMessagesWaiting(fetchRequests) == 0) idleRadio();
+  }
+}
+
+void startNetworkTask(bool allowPortal) {
+  portalAllowed = allowPortal;
+  fetchRequests = xQueueCreate(SCREEN_COUNT + 1, sizeof(uint8_t));  // + BACKFILL_REQUEST
+  fetchResults = xQueueCreate(SCREEN_COUNT, sizeof(WeatherObs));
+  backfillSamples = xQueueCreate(32, sizeof(HistorySample));
+  forecastMailbox = xQueueCreate(1, sizeof(Forecast));
+  xTaskCreate(networkTask, "net", 8192, nullptr, 1, nullptr);
+}
+
+void planNextFetch(uint32_t dueMs) {
+  plannedFetchAt = dueMs ? dueMs : 1;
+}
+
+NetState networkState() {
+  return netState;
+}
+
+uint8_t tempestStationCount() {
+  return STATION_COUNT;
+}
+
+const char* tempestStationName(uint8_t station) {
+  return station < STATION_COUNT ? TEMPEST_STATIONS[station].name : "";
+}
+
+void requestFetch(uint8_t screen) {
+  traceInstant(TRACE_FETCH_QUEUED, screen);
+  xQueueSend(fetchRequests, &screen, 0);  // Drop if one is already queued
+}
+
+bool pollFetchResult(WeatherObs& out) {
+  return xQueueReceive(fetchResults, &out, 0) == pdTRUE;
+}
+
+bool latestForecast(Forecast& out) {
+  return xQueuePeek(forecastMailbox, &out, 0) == pdTRUE;
+}
+
+void requestBackfill(uint32_t from, uint32_t to, float seaLevelOffset) {
+  if (backfill.state == BACKFILL_RUNNING) return;
+  backfill.from = from;
+  backfill.to = to;
+  backfill.seaLevelOffset = seaLevelOffset;
+  backfill.bytes = 0;
+  backfill.queued = 0;
+  backfill.pauses = 0;
+  backfill.paused = false;
+  backfill.startMs = millis();
+  backfill.startFreeHeap = backfill.minFreeHeap = ESP.getFreeHeap();
+  backfill.state = BACKFILL_RUNNING;
+  backfill.pending = true;
+
+  uint8_t wake = BACKFILL_REQUEST;
+  xQueueSend(fetchRequests, &wake, 0);
+}
+
+BackfillState backfillState() {
+  return (BackfillState)backfill.state;
+}
+
+bool pollBackfillSample(HistorySample& out) {
+  return xQueueReceive(backfillSamples, &out, 0) == pdTRUE;
+}
+
+void setConnectionHints(const ConnectionHints& h) {
+  hints = h;
+}
+
+bool getConnectionHints(ConnectionHints& out) {
+  out = hints;
+  return hints.valid;
+}
+
+void setCacheValidator(uint8_t screen, const char* etag) {
+  if (screen >= SCREEN_COUNT) return;
+  strlcpy(etags[screen], etag ? etag : "", ETAG_MAX);
+}
+
+const char* cacheValidator(uint8_t screen) {
+  return screen < SCREEN_COUNT ? etags[screen] : "";
+}
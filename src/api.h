@@ -0,0 +1,97 @@
+#pragma once
+#include <Arduino.h>
+#include "history.h"
+#include "forecast.h"
+
+// 📡 One decoded reading, handed from the network task to the UI loop
+enum FetchStatus : uint8_t {
+  FETCH_OK = 0,
+  FETCH_HTTP_ERROR,
+  FETCH_JSON_ERROR,
+  FETCH_NOT_MODIFIED   // 304: last reading for this screen still current
+};
+
+struct WeatherObs {
+  uint8_t screen;      // ScreenId this reading belongs to
+  uint8_t station;     // Tempest station index (SCREEN_SAN_DIEGO only)
+  uint8_t status;      // FetchStatus
+  float temp_f;
+  uint32_t timestamp;  // Provider epoch seconds (0 = unknown)
+  float pressure_mb;
+  float station_pressure_mb;  // Tempest only; converts backfilled rows to sea level
+  float humidity;      // %
+  float wind_avg;      // m/s
+  float wind_gust;     // m/s
+  float wind_dir;      // Degrees
+  float rain_mm;       // Since the previous observation
+  float uv;
+};
+
+// 🌐 Connection state published by the network task
+enum NetState : uint8_t {
+  NET_CONNECTING = 0,
+  NET_PORTAL,   // WiFiManager AP is up, waiting for the user
+  NET_ONLINE,
+  NET_FAILED,   // Portal timed out, restart pending
+  NET_OFFLINE   // Gave up without a portal; fetches fail fast
+};
+
+// ⚡ Last good association, lets a wake skip the scan and DHCP
+struct ConnectionHints {
+  uint8_t valid;
+  uint8_t channel;
+  uint8_t bssid[6];
+  uint32_t ip;
+  uint32_t gateway;
+  uint32_t subnet;
+  uint32_t dns;
+};
+
+// Starts WiFi + the background fetch worker; returns immediately.
+// allowPortal = false skips WiFiManager (timer wakes on battery).
+void startNetworkTask(bool allowPortal = true);
+NetState networkState();
+
+// Queue a fetch for a screen; results arrive via pollFetchResult().
+// Fetches queued together run concurrently on the async HTTP client.
+// The Tempest screen refreshes every station that is due, one after the
+// other over a kept-alive connection, primary first; each result carries
+// its station index.
+void requestFetch(uint8_t screen);
+bool pollFetchResult(WeatherObs& out);
+
+// 🌤️ Configured Tempest stations; station 0 backs the history, the
+// backfill and the forecast
+const uint8_t TEMPEST_STATION_MAX = 8;
+uint8_t tempestStationCount();
+const char* tempestStationName(uint8_t station);
+
+// 📻 millis() when the next fetch will be requested; lets the network task
+// power the radio down in between and rejoin just ahead of time
+void planNextFetch(uint32_t dueMs);
+
+// Apply before startNetworkTask(); read back once NET_ONLINE
+void setConnectionHints(const ConnectionHints& hints);
+bool getConnectionHints(ConnectionHints& out);
+
+// 🗓️ Newest forecast; a FETCH_OK result for SCREEN_FORECAST means it changed
+bool latestForecast(Forecast& out);
+
+// ⏮️ Refill the history from the Tempest device endpoint after a reboot.
+// Rows with from <= timestamp <= to are streamed, never buffered whole, and
+// arrive oldest first through pollBackfillSample(). seaLevelOffset converts
+// the rows' station pressure to the sea-level value live readings carry.
+enum BackfillState : uint8_t {
+  BACKFILL_IDLE = 0,
+  BACKFILL_RUNNING,
+  BACKFILL_DONE,
+  BACKFILL_FAILED
+};
+void requestBackfill(uint32_t from, uint32_t to, float seaLevelOffset);
+BackfillState backfillState();
+bool pollBackfillSample(HistorySample& out);
+
+// 🏷️ HTTP cache validators (ETag) per screen
+const size_t ETAG_MAX = 48;
+void setCacheValidator(uint8_t screen, const char* etag);
+const char* cacheValidator(uint8_t screen);
@@ -0,0 +1,21 @@
+#pragma once
+
+// 🌐 Provider endpoints
+//
+// The bases can be overridden at build time to aim the firmware at the
+// local mock server (native/mock_api), e.g.
+//   -DTEMPEST_API_BASE='"http://192.168.1.20:8080"'  ([env:xiao_esp32c3_mock])
+// The paths are shared with the native end-to-end harness (native/e2e).
+
+#ifndef TEMPEST_API_BASE
+#define TEMPEST_API_BASE "https://swd.weatherflow.com"
+#endif
+#ifndef OPENWEATHER_API_BASE
+#define OPENWEATHER_API_BASE "http://api.openweathermap.org"
+#endif
+
+#define TEMPEST_OBS_PATH "/swd/rest/observations/station/"
+#define TEMPEST_STATION_META_PATH "/swd/rest/stations/"
+#define TEMPEST_DEVICE_OBS_PATH "/swd/rest/observations/device/"
+#define TEMPEST_FORECAST_PATH "/swd/rest/better_forecast?units_temp=f&units_wind=mps&units_precip=mm&station_id="
+#define OPENWEATHER_LONDON_PATH "/data/2.5/weather?q=London,UK&units=imperial&appid="
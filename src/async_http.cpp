@@ -0,0 +1,1043 @@
+#include "async_http.h"
+#include "trace.h"
+#include "dns_cache.h"
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <strings.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/select.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#include <esp_tls.h>
+#include <esp_crt_bundle.h>
+#include <mbedtls/ssl.h>
+#ifdef CONFIG_ESP_TLS_CLIENT_SESSION_TICKETS
+#define TLS_RESUMPTION 1   // esp-tls can hand back and take a client session
+#endif
+#ifdef MBEDTLS_SSL_MAX_FRAGMENT_LENGTH
+#define TLS_FRAGMENT 1     // mbedTLS can offer max_fragment_length
+#endif
+static uint32_t nowMs() { return millis(); }
+static uint32_t nowUs() { return micros(); }
+static void idleMs(uint32_t ms) { delay(ms); }
+#else
+#include <time.h>
+static uint32_t nowMs() {
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint32_t)(ts.tv_sec * 1000UL + ts.tv_nsec / 1000000UL);
+}
+static uint32_t nowUs() {
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint32_t)(ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000UL);
+}
+static void idleMs(uint32_t ms) { usleep(ms * 1000); }
+#endif
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+enum SlotState : uint8_t {
+  SLOT_FREE = 0,
+  SLOT_FAILED,       // Failed during start; reported on the next poll
+  SLOT_TLS_CONNECT,  // esp-tls resolve + connect + handshake
+  SLOT_CONNECTING,   // Plain TCP connect in progress
+  SLOT_SENDING,
+  SLOT_HEADERS,
+  SLOT_BODY
+};
+
+enum ChunkState : uint8_t {
+  CHUNK_SIZE = 0,
+  CHUNK_DATA,
+  CHUNK_DATA_END,
+  CHUNK_TRAILER
+};
+
+// Transport results; positive values are byte counts
+static const int IO_AGAIN = -1;
+static const int IO_EOF = -2;
+static const int IO_ERROR = -3;
+
+static const uint32_t DEFAULT_TIMEOUT_MS = 15000;
+
+// esp-tls select()s on a still-connecting socket for timeout_ms on every
+// non-blocking call (esp_tls_low_level_conn in IDF 4.4; 0 waits forever),
+// so 1 ms keeps each step a poll. The wait itself is asyncHttpPoll()'s
+// select, which has the socket in its set, and the deadline is the slot's.
+static const int TLS_STEP_TIMEOUT_MS = 1;
+static const uint8_t NO_STAGE = 0xFF;
+
+struct Slot {
+  uint8_t state;
+  int8_t error;
+  bool tls;
+  int fd;
+#ifdef ARDUINO
+  esp_tls_t* tlsConn;
+  esp_tls_cfg_t tlsCfg;
+#endif
+  AsyncHttpRequest req;
+  char host[64];
+  uint16_t port;
+  char tx[512];
+  size_t txLen;
+  size_t txSent;
+  char hdr[768];
+  size_t hdrLen;
+  int status;
+  long contentLength;  // -1 = read until close
+  bool chunked;
+  uint8_t chunkState;
+  size_t chunkLeft;
+  char chunkLine[20];
+  uint8_t chunkLineLen;
+  size_t bodyLen;
+  char etag[48];
+  uint32_t startMs;
+  uint32_t stageUs;    // When the stage in progress began
+  uint32_t dnsUs;      // Stage times so far, see AsyncHttpResponse
+  uint32_t connectUs;
+  uint32_t tlsUs;
+  uint32_t waitUs;
+  uint8_t dnsSource;   // DnsSource of this connection's lookup
+  char addr[16];       // Resolved address, dotted, for esp-tls
+  bool tlsStarted;     // esp-tls has been called once: the connect is under way
+  uint8_t traceStage;  // TraceName open on the timeline, NO_STAGE if none
+  uint32_t bytesSent;
+  uint32_t bytesReceived;
+  bool keepAlive;      // Connection can be parked once the response ends
+  bool reused;         // Taken from the pool
+  bool offeredSession; // ClientHello carried a cached TLS session
+  bool certChecked;    // The handshake verified a certificate: a full one
+  bool offeredFragment; // ClientHello asked for ASYNC_HTTP_TLS_RECORD records
+  bool helloRetried;   // Already reconnected with a plain ClientHello
+  uint16_t tlsRecordIn;
+  uint32_t tlsHeapSaved;
+};
+
+static Slot slots[ASYNC_HTTP_SLOTS];
+
+// 🔌 Connections parked between keep-alive requests. A parked TLS session
+// holds its mbedTLS buffers, so the pool stays small.
+struct IdleConn {
+  bool open;
+  bool tls;
+  char host[64];
+  uint16_t port;
+  int fd;
+#ifdef ARDUINO
+  esp_tls_t* tlsConn;
+#endif
+  uint32_t parkedMs;
+};
+
+static IdleConn pool[ASYNC_HTTP_POOL];
+
+// 🔗 http[s]://host[:port]/path
+static bool parseUrl(const char* url, Slot& s, const char*& path) {
+  const char* p;
+  if (strncmp(url, "http://", 7) == 0) {
+    s.tls = false;
+    s.port = 80;
+    p = url + 7;
+  } else if (strncmp(url, "https://", 8) == 0) {
+    s.tls = true;
+    s.port = 443;
+    p = url + 8;
+  } else {
+    return false;
+  }
+
+  size_t hostLen = strcspn(p, ":/");
+  if (hostLen == 0 || hostLen >= sizeof(s.host)) return false;
+  memcpy(s.host, p, hostLen);
+  s.host[hostLen] = '\0';
+  p += hostLen;
+
+  if (*p == ':') {
+    char* end;
+    long port = strtol(p + 1, &end, 10);
+    if (port <= 0 || port > 65535) return false;
+    s.port = (uint16_t)port;
+    p = end;
+  }
+
+  path = *p ? p : "/";
+  return *path == '/';
+}
+
+static bool hostBusy(const char* host, uint16_t port) {
+  for (uint8_t i = 0; i < ASYNC_HTTP_SLOTS; i++) {
+    const Slot& s = slots[i];
+    if (s.state != SLOT_FREE && s.port == port && strcmp(s.host, host) == 0) return true;
+  }
+  return false;
+}
+
+// 🧵 One network stage per slot on the timeline, each ending the last
+static void traceStage(Slot& s, uint8_t name) {
+  uint8_t id = &s - slots;
+  if (s.traceStage != NO_STAGE) traceAsyncEnd(s.traceStage, id);
+  s.traceStage = name;
+  if (name != NO_STAGE) traceAsyncBegin(name, id);
+}
+
+static int slotFd(Slot& s) {
+#ifdef ARDUINO
+  if (s.tls && s.tlsConn && s.fd < 0) esp_tls_get_conn_sockfd(s.tlsConn, &s.fd);
+#endif
+  return s.fd;
+}
+
+static void closeSlot(Slot& s) {
+#ifdef ARDUINO
+  if (s.tlsConn) {
+    esp_tls_conn_destroy(s.tlsConn);  // Closes the socket too
+    s.tlsConn = nullptr;
+    s.fd = -1;
+  }
+#endif
+  if (s.fd >= 0) close(s.fd);
+  s.fd = -1;
+}
+
+static void closeIdle(IdleConn& c) {
+#ifdef ARDUINO
+  if (c.tlsConn) {
+    esp_tls_conn_destroy(c.tlsConn);
+    c.tlsConn = nullptr;
+    c.fd = -1;
+  }
+#endif
+  if (c.fd >= 0) close(c.fd);
+  c.fd = -1;
+  c.open = false;
+}
+
+// Hand the slot's connection to the pool, evicting the longest parked one
+static void park(Slot& s) {
+  IdleConn* c = nullptr;
+  for (uint8_t i = 0; i < ASYNC_HTTP_POOL; i++) {
+    IdleConn& p = pool[i];
+    if (!p.open) {
+      c = &p;
+      break;
+    }
+    if (!c || p.parkedMs < c->parkedMs) c = &p;
+  }
+  if (c->open) closeIdle(*c);
+
+  c->open = true;
+  c->tls = s.tls;
+  memcpy(c->host, s.host, sizeof(c->host));
+  c->port = s.port;
+  c->fd = s.fd;
+#ifdef ARDUINO
+  c->tlsConn = s.tlsConn;
+  s.tlsConn = nullptr;
+#endif
+  c->parkedMs = nowMs();
+  s.fd = -1;
+}
+
+// An idle socket with something to read was closed by the server (FIN or
+// a TLS close_notify); either way it can't carry another request
+static bool stillOpen(int fd) {
+  uint8_t b;
+  ssize_t rc = recv(fd, &b, 1, MSG_PEEK | MSG_DONTWAIT);
+  return rc < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+}
+
+static bool takeParked(Slot& s) {
+  for (uint8_t i = 0; i < ASYNC_HTTP_POOL; i++) {
+    IdleConn& c = pool[i];
+    if (!c.open || c.tls != s.tls || c.port != s.port || strcmp(c.host, s.host) != 0) continue;
+    if (nowMs() - c.parkedMs >= ASYNC_HTTP_IDLE_MS || c.fd < 0 || !stillOpen(c.fd)) {
+      closeIdle(c);
+      return false;
+    }
+
+    s.fd = c.fd;
+#ifdef ARDUINO
+    s.tlsConn = c.tlsConn;
+    c.tlsConn = nullptr;
+#endif
+    c.fd = -1;
+    c.open = false;
+    s.reused = true;
+    s.state = SLOT_SENDING;
+    return true;
+  }
+  return false;
+}
+
+static void finish(Slot& s, int8_t error) {
+  if (error == ASYNC_HTTP_OK && s.keepAlive) {
+    park(s);
+  } else {
+    closeSlot(s);
+  }
+
+  char etag[sizeof(s.etag)];
+  memcpy(etag, s.etag, sizeof(etag));
+
+  AsyncHttpResponse res = {};
+  res.error = error;
+  res.status = s.status;
+  res.body = s.req.onBody ? nullptr : s.req.bodyBuf;
+  res.bodyLen = s.bodyLen;
+  res.etag = etag;
+  res.elapsedMs = nowMs() - s.startMs;
+  res.dnsUs = s.dnsUs;
+  res.dnsSource = s.dnsSource;
+  res.connectUs = s.connectUs;
+  res.tlsUs = s.tlsUs;
+  res.waitUs = s.waitUs;
+  res.transferUs = s.bytesReceived ? nowUs() - s.stageUs : 0;
+  res.tlsResumed = s.tlsUs && s.offeredSession && !s.certChecked;
+  res.tlsRecordIn = s.tlsRecordIn;
+  res.tlsHeapSaved = s.tlsHeapSaved;
+  res.bytesSent = s.bytesSent;
+  res.bytesReceived = s.bytesReceived;
+  res.reused = s.reused;
+
+  traceStage(s, NO_STAGE);
+  traceAsyncEnd(TRACE_HTTP, &s - slots);
+
+  AsyncHttpDone done = s.req.onDone;
+  void* ctx = s.req.ctx;
+  s.state = SLOT_FREE;  // Free before the callback so it can start another
+  if (done) done(res, ctx);
+}
+
+// 🧭 Through the TTL cache (dns_cache.h); blocks on a miss
+static bool resolveSlot(Slot& s, uint32_t& addr) {
+  traceStage(s, TRACE_DNS);
+  uint32_t lookupUs = nowUs();
+  s.dnsSource = dnsResolve(s.host, addr);
+  s.dnsUs = nowUs() - lookupUs;
+  if (s.dnsSource == DNS_NONE) {
+    s.error = ASYNC_HTTP_ERR_RESOLVE;
+    return false;
+  }
+  return true;
+}
+
+static bool startTcp(Slot& s) {
+  sockaddr_in to = {};
+  to.sin_family = AF_INET;
+  to.sin_port = htons(s.port);
+  if (!resolveSlot(s, to.sin_addr.s_addr)) return false;
+
+  s.fd = socket(AF_INET, SOCK_STREAM, 0);
+  if (s.fd < 0) {
+    s.error = ASYNC_HTTP_ERR_CONNECT;
+    return false;
+  }
+  fcntl(s.fd, F_SETFL, fcntl(s.fd, F_GETFL, 0) | O_NONBLOCK);
+
+  traceStage(s, TRACE_CONNECT);
+  s.stageUs = nowUs();
+  int rc = connect(s.fd, (const sockaddr*)&to, sizeof(to));
+  if (rc == 0) {
+    s.connectUs = nowUs() - s.stageUs;
+    traceStage(s, NO_STAGE);
+    s.state = SLOT_SENDING;
+  } else if (errno == EINPROGRESS) {
+    s.state = SLOT_CONNECTING;
+  } else {
+    s.error = ASYNC_HTTP_ERR_CONNECT;
+    return false;
+  }
+  return true;
+}
+
+// 🔐 TLS session resumption
+//
+// The session from each host's last handshake is kept and offered in
+// the next ClientHello (ticket or session ID, whichever the server
+// issued). A resumed handshake skips the certificate chain and the ECDHE +
+// signature math, by far the slowest part of a refresh on the C3. The
+// certificate check is how the two are told apart: the bundle's verify
+// callback is wrapped, and a handshake that never called it was resumed.
+#ifdef ARDUINO
+
+static Slot* handshaking = nullptr;   // Slot whose esp-tls step is running
+
+#ifdef TLS_FRAGMENT
+
+// 📦 Max fragment length (RFC 6066)
+//
+// By default the receive buffer must hold a 16 KB record. A server that
+// accepts max_fragment_length promises records of at most
+// ASYNC_HTTP_TLS_RECORD, and with variable buffer lengths mbedTLS shrinks
+// both record buffers to match once the handshake is done; the heap goes
+// back to sprites and JSON documents. A server that ignores the extension
+// just gets full-size buffers. One that aborts the handshake over it is
+// retried at once with a plain ClientHello and remembered.
+
+static const unsigned char FRAGMENT_CODE =
+    ASYNC_HTTP_TLS_RECORD <= 512 ? MBEDTLS_SSL_MAX_FRAG_LEN_512 :
+    ASYNC_HTTP_TLS_RECORD <= 1024 ? MBEDTLS_SSL_MAX_FRAG_LEN_1024 :
+    ASYNC_HTTP_TLS_RECORD <= 2048 ? MBEDTLS_SSL_MAX_FRAG_LEN_2048 : MBEDTLS_SSL_MAX_FRAG_LEN_4096;
+
+struct PlainHello {
+  char host[64];
+  uint16_t port;
+};
+
+static PlainHello plainHellos[ASYNC_HTTP_POOL];   // Hosts that refused the extension
+static uint8_t plainHelloNext = 0;
+
+static bool wantsPlainHello(const char* host, uint16_t port) {
+  for (uint8_t i = 0; i < ASYNC_HTTP_POOL; i++) {
+    if (plainHellos[i].port == port && strcmp(plainHellos[i].host, host) == 0) return true;
+  }
+  return false;
+}
+
+static void rememberPlainHello(const char* host, uint16_t port) {
+  PlainHello& p = plainHellos[plainHelloNext];
+  plainHelloNext = (plainHelloNext + 1) % ASYNC_HTTP_POOL;
+  strlcpy(p.host, host, sizeof(p.host));
+  p.port = port;
+}
+
+// Record sizes this connection ended up with, and the buffer bytes that
+// frees against the full-size defaults
+static void noteRecordSizes(Slot& s) {
+  mbedtls_ssl_context* ssl = &s.tlsConn->ssl;
+  size_t in = mbedtls_ssl_get_input_max_frag_len(ssl);
+  s.tlsRecordIn = in;
+#ifdef MBEDTLS_SSL_VARIABLE_BUFFER_LENGTH
+  size_t out = mbedtls_ssl_get_output_max_frag_len(ssl);
+  s.tlsHeapSaved = (in < MBEDTLS_SSL_IN_CONTENT_LEN ? MBEDTLS_SSL_IN_CONTENT_LEN - in : 0) +
+                   (out < MBEDTLS_SSL_OUT_CONTENT_LEN ? MBEDTLS_SSL_OUT_CONTENT_LEN - out : 0);
+#endif
+  if (s.offeredFragment && s.tlsRecordIn > ASYNC_HTTP_TLS_RECORD) {
+    Serial.printf("📦 %s declined max_fragment_length, full-size TLS records\n", s.host);
+  }
+}
+
+#endif
+static int (*bundleVerify)(void*, mbedtls_x509_crt*, int, uint32_t*) = nullptr;
+
+static int countingVerify(void* ctx, mbedtls_x509_crt* crt, int depth, uint32_t* flags) {
+  if (handshaking) handshaking->certChecked = true;
+  return bundleVerify(ctx, crt, depth, flags);
+}
+
+static esp_err_t attachBundle(void* conf) {
+  esp_err_t err = esp_crt_bundle_attach(conf);
+  mbedtls_ssl_config* c = (mbedtls_ssl_config*)conf;
+#ifdef TLS_FRAGMENT
+  // The one hook esp-tls gives before mbedtls_ssl_setup()
+  if (handshaking && handshaking->offeredFragment) mbedtls_ssl_conf_max_frag_len(c, FRAGMENT_CODE);
+#endif
+  if (err == ESP_OK && c->f_vrfy) {
+    bundleVerify = c->f_vrfy;
+    mbedtls_ssl_conf_verify(c, countingVerify, c->p_vrfy);
+  }
+  return err;
+}
+
+#endif
+
+#ifdef TLS_RESUMPTION
+
+struct TlsSession {
+  char host[64];
+  uint16_t port;
+  esp_tls_client_session_t* session;
+  uint32_t savedMs;
+};
+
+static TlsSession sessions[ASYNC_HTTP_POOL];
+
+static TlsSession* findSession(const char* host, uint16_t port) {
+  for (uint8_t i = 0; i < ASYNC_HTTP_POOL; i++) {
+    TlsSession& t = sessions[i];
+    if (t.session && t.port == port && strcmp(t.host, host) == 0) return &t;
+  }
+  return nullptr;
+}
+
+// What esp_tls_free_client_session() does, which IDF 4.4 doesn't have yet
+static void freeSession(esp_tls_client_session_t* session) {
+  if (!session) return;
+  mbedtls_ssl_session_free(&session->saved_session);
+  free(session);
+}
+
+static void forgetSession(TlsSession* t) {
+  if (!t) return;
+  freeSession(t->session);
+  t->session = nullptr;
+}
+
+// Replaces the host's entry, or the oldest
+static void keepSession(const char* host, uint16_t port, esp_tls_client_session_t* session) {
+  TlsSession* t = findSession(host, port);
+  for (uint8_t i = 0; i < ASYNC_HTTP_POOL && !t; i++) {
+    if (!sessions[i].session) t = &sessions[i];
+  }
+  if (!t) {
+    t = &sessions[0];
+    for (uint8_t i = 1; i < ASYNC_HTTP_POOL; i++) {
+      if (sessions[i].savedMs < t->savedMs) t = &sessions[i];
+    }
+  }
+  forgetSession(t);
+  strlcpy(t->host, host, sizeof(t->host));
+  t->port = port;
+  t->session = session;
+  t->savedMs = nowMs();
+}
+
+#endif
+
+// Fresh transport; failures surface as SLOT_FAILED on the next poll
+static void connectSlot(Slot& s) {
+  s.reused = false;
+  s.tlsStarted = false;
+  s.dnsSource = DNS_NONE;
+  s.offeredSession = s.certChecked = s.offeredFragment = false;
+  s.dnsUs = s.connectUs = s.tlsUs = 0;
+  s.tlsRecordIn = 0;
+  s.tlsHeapSaved = 0;
+  if (s.tls) {
+#ifdef ARDUINO
+    // esp-tls connects to the cached address; SNI and the certificate
+    // check still use the name
+    uint32_t addr;
+    if (!resolveSlot(s, addr)) {
+      s.state = SLOT_FAILED;
+      return;
+    }
+    in_addr a;
+    a.s_addr = addr;
+    inet_ntop(AF_INET, &a, s.addr, sizeof(s.addr));
+    s.tlsConn = esp_tls_init();
+    memset(&s.tlsCfg, 0, sizeof(s.tlsCfg));
+    s.tlsCfg.non_block = true;
+    s.tlsCfg.timeout_ms = TLS_STEP_TIMEOUT_MS;
+    s.tlsCfg.crt_bundle_attach = attachBundle;
+    s.tlsCfg.common_name = s.host;
+#ifdef TLS_RESUMPTION
+    TlsSession* cached = findSession(s.host, s.port);
+    s.tlsCfg.client_session = cached ? cached->session : nullptr;
+    s.offeredSession = cached != nullptr;
+#endif
+#ifdef TLS_FRAGMENT
+    s.offeredFragment = !wantsPlainHello(s.host, s.port);
+#endif
+    s.state = s.tlsConn ? SLOT_TLS_CONNECT : SLOT_FAILED;
+    s.error = ASYNC_HTTP_ERR_TLS;
+#else
+    s.state = SLOT_FAILED;  // No TLS on host builds
+    s.error = ASYNC_HTTP_ERR_TLS;
+#endif
+    return;
+  }
+
+  if (!startTcp(s)) s.state = SLOT_FAILED;
+}
+
+// ♻️ The server dropped a parked connection just as we reused it: reconnect
+// once, as long as nothing of the response has arrived
+static bool retryFresh(Slot& s) {
+  if (!s.reused || s.state == SLOT_BODY || s.hdrLen > 0) return false;
+  closeSlot(s);
+  s.txSent = 0;
+  connectSlot(s);
+  return true;
+}
+
+bool asyncHttpStart(const AsyncHttpRequest& req) {
+  Slot* slot = nullptr;
+  for (uint8_t i = 0; i < ASYNC_HTTP_SLOTS && !slot; i++) {
+    if (slots[i].state == SLOT_FREE) slot = &slots[i];
+  }
+  if (!slot || !req.url) return false;
+
+  // Parsed in place; the slot stays free until the checks pass
+  Slot& s = *slot;
+  memset(&s, 0, sizeof(s));
+  const char* path;
+  if (!parseUrl(req.url, s, path) || hostBusy(s.host, s.port)) return false;
+
+  s.fd = -1;
+  s.contentLength = -1;
+  s.req = req;
+  s.startMs = nowMs();
+  s.keepAlive = req.keepAlive;
+
+  char hostHeader[sizeof(s.host) + 6];
+  bool defaultPort = s.port == (s.tls ? 443 : 80);
+  snprintf(hostHeader, sizeof(hostHeader), defaultPort ? "%s" : "%s:%u", s.host, s.port);
+  int n = snprintf(s.tx, sizeof(s.tx),
+                   "GET %s HTTP/1.1\r\n"
+                   "Host: %s\r\n"
+                   "User-Agent: tempestuous\r\n"
+                   "Accept: application/json\r\n"
+                   "Connection: %s\r\n"
+                   "%s\r\n",
+                   path, hostHeader, req.keepAlive ? "keep-alive" : "close",
+                   req.headers ? req.headers : "");
+  if (n < 0 || (size_t)n >= sizeof(s.tx)) return false;
+  s.txLen = n;
+
+  s.traceStage = NO_STAGE;
+  traceAsyncBegin(TRACE_HTTP, &s - slots);
+
+  if (!takeParked(s)) connectSlot(s);
+  return true;
+}
+
+static int slotWrite(Slot& s, const char* data, size_t len) {
+#ifdef ARDUINO
+  if (s.tls) {
+    ssize_t rc = esp_tls_conn_write(s.tlsConn, data, len);
+    if (rc > 0) return rc;
+    if (rc == ESP_TLS_ERR_SSL_WANT_READ || rc == ESP_TLS_ERR_SSL_WANT_WRITE) return IO_AGAIN;
+    return IO_ERROR;
+  }
+#endif
+  ssize_t rc = send(s.fd, data, len, MSG_NOSIGNAL);
+  if (rc > 0) return rc;
+  if (rc < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return IO_AGAIN;
+  return IO_ERROR;
+}
+
+static int slotRead(Slot& s, uint8_t* buf, size_t len) {
+#ifdef ARDUINO
+  if (s.tls) {
+    ssize_t rc = esp_tls_conn_read(s.tlsConn, buf, len);
+    if (rc > 0) return rc;
+    if (rc == 0 || rc == -0x7880) return IO_EOF;  // MBEDTLS_ERR_SSL_PEER_CLOSE_NOTIFY
+    if (rc == ESP_TLS_ERR_SSL_WANT_READ || rc == ESP_TLS_ERR_SSL_WANT_WRITE) return IO_AGAIN;
+    return IO_ERROR;
+  }
+#endif
+  ssize_t rc = recv(s.fd, buf, len, 0);
+  if (rc > 0) return rc;
+  if (rc == 0) return IO_EOF;
+  if (errno == EAGAIN || errno == EWOULDBLOCK) return IO_AGAIN;
+  return IO_ERROR;
+}
+
+static bool deliverBody(Slot& s, const uint8_t* data, size_t len) {
+  if (len == 0) return true;
+  if (s.req.onBody) {
+    s.bodyLen += len;
+    return s.req.onBody(data, len, s.req.ctx);
+  }
+  if (s.bodyLen + len > s.req.bodyCap) return false;
+  memcpy(s.req.bodyBuf + s.bodyLen, data, len);
+  s.bodyLen += len;
+  return true;
+}
+
+static bool bodyless(int status) {
+  return status == 204 || status == 304 || (status >= 100 && status < 200);
+}
+
+// 🧾 Status line + the few headers we act on
+static bool parseHeaders(Slot& s) {
+  s.hdr[s.hdrLen] = '\0';
+  int major, minor;
+  if (sscanf(s.hdr, "HTTP/%d.%d %d", &major, &minor, &s.status) != 3) return false;
+  if (major == 1 && minor == 0) s.keepAlive = false;  // No persistent connections by default
+
+  char* line = strstr(s.hdr, "\r\n");
+  while (line && line[2] != '\r') {
+    line += 2;
+    char* end = strstr(line, "\r\n");
+    if (!end) break;
+    *end = '\0';
+
+    char* value = strchr(line, ':');
+    if (value) {
+      *value++ = '\0';
+      while (*value == ' ') value++;
+      if (strcasecmp(line, "Content-Length") == 0) {
+        s.contentLength = strtol(value, nullptr, 10);
+      } else if (strcasecmp(line, "Transfer-Encoding") == 0) {
+        s.chunked = strstr(value, "chunked") != nullptr;
+      } else if (strcasecmp(line, "ETag") == 0) {
+        strncpy(s.etag, value, sizeof(s.etag) - 1);
+      } else if (strcasecmp(line, "Connection") == 0) {
+        if (strncasecmp(value, "close", 5) == 0) s.keepAlive = false;
+      }
+    }
+    *end = '\r';
+    line = end;
+  }
+
+  if (s.chunked) s.contentLength = -1;
+  if (!s.chunked && s.contentLength < 0 && !bodyless(s.status)) s.keepAlive = false;  // Ends at close
+  return true;
+}
+
+static bool bodyComplete(Slot& s) {
+  if (bodyless(s.status)) return true;
+  return !s.chunked && s.contentLength >= 0 && s.bodyLen >= (size_t)s.contentLength;
+}
+
+// Returns false once the slot has been finished
+static bool consumeChunked(Slot& s, const uint8_t*& p, size_t& n) {
+  while (n > 0) {
+    switch (s.chunkState) {
+      case CHUNK_DATA: {
+        size_t take = n < s.chunkLeft ? n : s.chunkLeft;
+        if (!deliverBody(s, p, take)) {
+          finish(s, s.req.onBody ? ASYNC_HTTP_ERR_ABORTED : ASYNC_HTTP_ERR_TOO_LARGE);
+          return false;
+        }
+        p += take;
+        n -= take;
+        s.chunkLeft -= take;
+        if (s.chunkLeft == 0) s.chunkState = CHUNK_DATA_END;
+        break;
+      }
+
+      case CHUNK_DATA_END:
+        if (*p++ == '\n') s.chunkState = CHUNK_SIZE;
+        n--;
+        break;
+
+      case CHUNK_SIZE:
+      case CHUNK_TRAILER: {
+        char c = *p++;
+        n--;
+        if (c != '\n') {
+          if ((size_t)s.chunkLineLen + 1 >= sizeof(s.chunkLine)) {
+            if (s.chunkState == CHUNK_TRAILER) continue;  // Ignore long trailers
+            finish(s, ASYNC_HTTP_ERR_PROTOCOL);
+            return false;
+          }
+          s.chunkLine[s.chunkLineLen++] = c;
+          continue;
+        }
+
+        s.chunkLine[s.chunkLineLen] = '\0';
+        bool blank = s.chunkLineLen == 0 || (s.chunkLineLen == 1 && s.chunkLine[0] == '\r');
+        s.chunkLineLen = 0;
+
+        if (s.chunkState == CHUNK_TRAILER) {
+          if (blank) {
+            if (n > 0) s.keepAlive = false;  // Stray bytes after the response
+            finish(s, ASYNC_HTTP_OK);
+            return false;
+          }
+          continue;
+        }
+
+        char* end;
+        s.chunkLeft = strtoul(s.chunkLine, &end, 16);
+        if (end == s.chunkLine) {
+          finish(s, ASYNC_HTTP_ERR_PROTOCOL);
+          return false;
+        }
+        s.chunkState = s.chunkLeft ? CHUNK_DATA : CHUNK_TRAILER;
+        break;
+      }
+    }
+  }
+  return true;
+}
+
+// Feed received bytes through header parsing and body framing
+static bool consume(Slot& s, const uint8_t* p, size_t n) {
+  while (n > 0 && s.state == SLOT_HEADERS) {
+    if (s.hdrLen + 1 >= sizeof(s.hdr)) {
+      finish(s, ASYNC_HTTP_ERR_PROTOCOL);
+      return false;
+    }
+    s.hdr[s.hdrLen++] = *p++;
+    n--;
+    if (s.hdrLen >= 4 && memcmp(s.hdr + s.hdrLen - 4, "\r\n\r\n", 4) == 0) {
+      if (!parseHeaders(s)) {
+        finish(s, ASYNC_HTTP_ERR_PROTOCOL);
+        return false;
+      }
+      s.state = SLOT_BODY;
+      if (bodyComplete(s)) {
+        if (n > 0) s.keepAlive = false;
+        finish(s, ASYNC_HTTP_OK);
+        return false;
+      }
+    }
+  }
+
+  if (n == 0) return true;
+  if (s.chunked) return consumeChunked(s, p, n);
+
+  size_t take = n;
+  if (s.contentLength >= 0 && s.bodyLen + take > (size_t)s.contentLength) {
+    take = s.contentLength - s.bodyLen;
+    s.keepAlive = false;
+  }
+  if (!deliverBody(s, p, take)) {
+    finish(s, s.req.onBody ? ASYNC_HTTP_ERR_ABORTED : ASYNC_HTTP_ERR_TOO_LARGE);
+    return false;
+  }
+  if (bodyComplete(s)) {
+    finish(s, ASYNC_HTTP_OK);
+    return false;
+  }
+  return true;
+}
+
+static void step(Slot& s, bool writable) {
+  switch (s.state) {
+    case SLOT_FAILED:
+      finish(s, s.error);
+      return;
+
+    case SLOT_TLS_CONNECT: {
+#ifdef ARDUINO
+      if (!s.tlsStarted) {
+        s.tlsStarted = true;
+        s.stageUs = nowUs();
+        traceStage(s, TRACE_TLS);
+      }
+      handshaking = &s;
+      int rc = esp_tls_conn_new_async(s.addr, strlen(s.addr), s.port, &s.tlsCfg, s.tlsConn);
+      handshaking = nullptr;
+      if (rc < 0) {
+        // Failed after TCP connected: maybe the server chokes on the ticket
+        // or the fragment extension, so the ClientHello drops whichever it had
+        bool inHandshake = s.tlsConn->conn_state == ESP_TLS_HANDSHAKE;
+#ifdef TLS_RESUMPTION
+        if (s.offeredSession) forgetSession(findSession(s.host, s.port));
+#endif
+#ifdef TLS_FRAGMENT
+        if (inHandshake && s.offeredFragment && !s.helloRetried) {
+          rememberPlainHello(s.host, s.port);
+          s.helloRetried = true;
+          closeSlot(s);
+          connectSlot(s);
+          return;
+        }
+#endif
+        (void)inHandshake;
+        finish(s, ASYNC_HTTP_ERR_TLS);
+        return;
+      }
+      if (rc == 0) return;  // Handshake still going
+      s.tlsUs = nowUs() - s.stageUs;
+#ifdef TLS_RESUMPTION
+      esp_tls_client_session_t* session = esp_tls_get_client_session(s.tlsConn);
+      if (session) keepSession(s.host, s.port, session);
+#endif
+#ifdef TLS_FRAGMENT
+      noteRecordSizes(s);
+#endif
+      traceStage(s, NO_STAGE);
+      slotFd(s);
+      s.state = SLOT_SENDING;
+#endif
+      break;
+    }
+
+    case SLOT_CONNECTING: {
+      if (!writable) return;
+      int err = 0;
+      socklen_t len = sizeof(err);
+      if (getsockopt(s.fd, SOL_SOCKET, SO_ERROR, &err, &len) != 0 || err != 0) {
+        finish(s, ASYNC_HTTP_ERR_CONNECT);
+        return;
+      }
+      s.connectUs = nowUs() - s.stageUs;
+      traceStage(s, NO_STAGE);
+      s.state = SLOT_SENDING;
+      break;
+    }
+
+    default:
+      break;
+  }
+
+  while (s.state == SLOT_SENDING) {
+    int rc = slotWrite(s, s.tx + s.txSent, s.txLen - s.txSent);
+    if (rc == IO_AGAIN) return;
+    if (rc < 0) {
+      if (!retryFresh(s)) finish(s, ASYNC_HTTP_ERR_IO);
+      return;
+    }
+    s.txSent += rc;
+    s.bytesSent += rc;
+    if (s.txSent == s.txLen) {
+      s.state = SLOT_HEADERS;
+      s.stageUs = nowUs();  // Waiting on the server from here
+      traceStage(s, TRACE_WAIT);
+    }
+  }
+
+  uint8_t buf[512];
+  while (s.state == SLOT_HEADERS || s.state == SLOT_BODY) {
+    int rc = slotRead(s, buf, sizeof(buf));
+    if (rc == IO_AGAIN) return;
+    if (rc < 0 && retryFresh(s)) return;
+    if (rc == IO_EOF) {
+      // Close-delimited bodies end here; anything else was cut short
+      bool delimited = s.state == SLOT_BODY && !s.chunked && s.contentLength < 0;
+      finish(s, delimited ? ASYNC_HTTP_OK : ASYNC_HTTP_ERR_IO);
+      return;
+    }
+    if (rc < 0) {
+      finish(s, ASYNC_HTTP_ERR_IO);
+      return;
+    }
+    if (!s.bytesReceived) {
+      uint32_t now = nowUs();
+      s.waitUs = now - s.stageUs;
+      s.stageUs = now;  // Transfer from the first byte on
+      traceStage(s, TRACE_TRANSFER);
+    }
+    s.bytesReceived += rc;
+    if (!consume(s, buf, rc)) return;
+  }
+}
+
+static void closeExpired() {
+  for (uint8_t i = 0; i < ASYNC_HTTP_POOL; i++) {
+    IdleConn& c = pool[i];
+    if (c.open && nowMs() - c.parkedMs >= ASYNC_HTTP_IDLE_MS) closeIdle(c);
+  }
+}
+
+void asyncHttpPoll(uint32_t waitMs) {
+  closeExpired();
+
+  fd_set rd, wr;
+  FD_ZERO(&rd);
+  FD_ZERO(&wr);
+  int maxFd = -1;
+  bool active = false;
+
+  for (uint8_t i = 0; i < ASYNC_HTTP_SLOTS; i++) {
+    Slot& s = slots[i];
+    if (s.state == SLOT_FREE) continue;
+    active = true;
+
+    int fd = slotFd(s);
+    if (s.state == SLOT_FAILED || fd < 0) {
+      waitMs = 0;  // Nothing to select on yet, come straight back
+      continue;
+    }
+    if (s.state == SLOT_CONNECTING || s.state == SLOT_SENDING || s.state == SLOT_TLS_CONNECT) {
+      FD_SET(fd, &wr);
+    }
+    if (s.state != SLOT_CONNECTING) FD_SET(fd, &rd);
+    if (fd > maxFd) maxFd = fd;
+  }
+  if (!active) return;
+
+  if (maxFd >= 0) {
+    timeval tv = { (long)(waitMs / 1000), (long)((waitMs % 1000) * 1000) };
+    select(maxFd + 1, &rd, &wr, nullptr, &tv);
+  } else if (waitMs) {
+    idleMs(waitMs);
+  }
+
+  uint32_t now = nowMs();
+  for (uint8_t i = 0; i < ASYNC_HTTP_SLOTS; i++) {
+    Slot& s = slots[i];
+    if (s.state == SLOT_FREE) continue;
+
+    bool writable = s.fd >= 0 && FD_ISSET(s.fd, &wr);
+    step(s, writable);
+
+    // Signed: a request started from an earlier slot's callback has
+    // startMs after now
+    uint32_t timeout = s.req.timeoutMs ? s.req.timeoutMs : DEFAULT_TIMEOUT_MS;
+    if (s.state != SLOT_FREE && (int32_t)(now - s.startMs) > (int32_t)timeout) {
+      finish(s, ASYNC_HTTP_ERR_TIMEOUT);
+    }
+  }
+}
+
+bool asyncHttpIdle() {
+  return asyncHttpInFlight() == 0;
+}
+
+uint8_t asyncHttpInFlight() {
+  uint8_t n = 0;
+  for (uint8_t i = 0; i < ASYNC_HTTP_SLOTS; i++) {
+    if (slots[i].state != SLOT_FREE) n++;
+  }
+  return n;
+}
+
+void asyncHttpCloseIdle() {
+  for (uint8_t i = 0; i < ASYNC_HTTP_POOL; i++) {
+    if (pool[i].open) closeIdle(pool[i]);
+  }
+}
+
+// 💾 The most recent session, for RTC memory across deep sleep:
+// [host length][host][port, LE16][mbedtls_ssl_session_save() bytes]
+
+#ifdef TLS_RESUMPTION
+
+size_t asyncHttpSaveTlsSession(uint8_t* buf, size_t cap) {
+  TlsSession* t = nullptr;
+  for (uint8_t i = 0; i < ASYNC_HTTP_POOL; i++) {
+    if (sessions[i].session && (!t || sessions[i].savedMs > t->savedMs)) t = &sessions[i];
+  }
+  if (!t) return 0;
+  size_t hostLen = strlen(t->host);
+  size_t head = 1 + hostLen + 2;
+  if (cap < head) return 0;
+  buf[0] = hostLen;
+  memcpy(buf + 1, t->host, hostLen);
+  buf[1 + hostLen] = t->port & 0xFF;
+  buf[2 + hostLen] = t->port >> 8;
+  size_t len = 0;
+  int rc = mbedtls_ssl_session_save(&t->session->saved_session, buf + head, cap - head, &len);
+  if (rc != 0) {
+    Serial.printf("⚠️ TLS session for %s not kept (%u bytes needed)\n", t->host, (unsigned)len);
+    return 0;
+  }
+  return head + len;
+}
+
+bool asyncHttpLoadTlsSession(const uint8_t* buf, size_t len) {
+  if (len < 3 || len < (size_t)buf[0] + 3 || buf[0] >= sizeof(sessions[0].host)) return false;
+  char host[sizeof(sessions[0].host)];
+  size_t hostLen = buf[0];
+  memcpy(host, buf + 1, hostLen);
+  host[hostLen] = '\0';
+  uint16_t port = buf[1 + hostLen] | (buf[2 + hostLen] << 8);
+  size_t head = 1 + hostLen + 2;
+
+  esp_tls_client_session_t* session =
+      (esp_tls_client_session_t*)calloc(1, sizeof(esp_tls_client_session_t));
+  if (!session) return false;
+  mbedtls_ssl_session_init(&session->saved_session);
+  if (mbedtls_ssl_session_load(&session->saved_session, buf + head, len - head) != 0) {
+    freeSession(session);
+    return false;
+  }
+  keepSession(host, port, session);
+  return true;
+}
+
+#else
+
+size_t asyncHttpSaveTlsSession(uint8_t*, size_t) { return 0; }
+bool asyncHttpLoadTlsSession(const uint8_t*, size_t) { return false; }
+
+#endif
@@ -0,0 +1,99 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+// ⚡ Non-blocking HTTP/1.1 GET client
+//
+// Several requests run at once, one connection per host, all driven from a
+// single select() in asyncHttpPoll(). Completion is reported through a
+// callback. Plain HTTP uses POSIX sockets (lwIP on the device, so it also
+// builds and runs on Linux); https:// goes through esp-tls on the device.
+// Host names go through the TTL cache in dns_cache.h either way; that
+// lookup is the one blocking step (see asyncHttpStart()).
+//
+// Keep-alive requests park their connection once the response is fully
+// read, and the next request to that host picks it up, skipping DNS, the
+// TCP connect and the TLS handshake. A fresh https connection still offers
+// the session from the host's last handshake, so the server can resume it
+// and skip the certificate chain and key exchange. It also asks for 4 KB
+// records so mbedTLS can keep smaller buffers.
+
+enum AsyncHttpError : int8_t {
+  ASYNC_HTTP_OK = 0,
+  ASYNC_HTTP_ERR_URL = -1,
+  ASYNC_HTTP_ERR_RESOLVE = -2,
+  ASYNC_HTTP_ERR_CONNECT = -3,
+  ASYNC_HTTP_ERR_TLS = -4,
+  ASYNC_HTTP_ERR_IO = -5,
+  ASYNC_HTTP_ERR_PROTOCOL = -6,  // Malformed status line, headers or chunks
+  ASYNC_HTTP_ERR_TOO_LARGE = -7, // Body overflowed the caller's buffer
+  ASYNC_HTTP_ERR_TIMEOUT = -8,
+  ASYNC_HTTP_ERR_ABORTED = -9    // Body sink returned false
+};
+
+struct AsyncHttpResponse {
+  int8_t error;          // AsyncHttpError
+  int status;            // HTTP status, 0 if none was received
+  const uint8_t* body;   // Caller's buffer (null when streaming)
+  size_t bodyLen;
+  const char* etag;      // "" when absent
+  uint32_t elapsedMs;
+  uint32_t dnsUs;        // ⏱️ Stage times; the first three stay 0 on a reused connection
+  uint8_t dnsSource;     // DnsSource (dns_cache.h), DNS_NONE on a reused connection
+  uint32_t connectUs;    // Plain HTTP only
+  uint32_t tlsUs;        // https: TCP connect + handshake
+  uint32_t waitUs;       // Request sent → first response byte
+  uint32_t transferUs;   // First response byte → done
+  uint32_t bytesSent;
+  uint32_t bytesReceived;
+  bool reused;           // Went out on a parked connection
+  bool tlsResumed;       // The handshake resumed a cached session
+  uint16_t tlsRecordIn;  // Largest record the server may send, 0 if unknown
+  uint32_t tlsHeapSaved; // Record buffer bytes freed by the negotiated size
+};
+
+typedef void (*AsyncHttpDone)(const AsyncHttpResponse& res, void* ctx);
+// Streaming sink; return false to abort the transfer
+typedef bool (*AsyncHttpBody)(const uint8_t* data, size_t len, void* ctx);
+
+struct AsyncHttpRequest {
+  const char* url;        // http://host[:port]/path or https://...
+  const char* headers;    // Extra "Name: value\r\n" lines, may be null
+  uint8_t* bodyBuf;       // Collect the body here...
+  size_t bodyCap;
+  AsyncHttpBody onBody;   // ...or stream it here (takes precedence)
+  AsyncHttpDone onDone;
+  void* ctx;
+  uint32_t timeoutMs;
+  bool keepAlive;         // Park the connection for the next request to this host
+};
+
+const uint8_t ASYNC_HTTP_SLOTS = 4;
+const uint8_t ASYNC_HTTP_POOL = 2;            // Parked connections, one per host
+const uint32_t ASYNC_HTTP_IDLE_MS = 30000;    // Parked longer than this are closed
+const size_t ASYNC_HTTP_SESSION_MAX = 2048;   // Saved TLS session, peer certificate included
+const uint16_t ASYNC_HTTP_TLS_RECORD = 4096;  // max_fragment_length offered; API bodies are ~2 KB
+
+// false if the URL is bad, the host already has a request in flight, or
+// every slot is busy. The headers string must outlive the request.
+// Unless a parked connection is reused, the host name is resolved right
+// here, synchronously: a dns_cache.h miss blocks the caller for up to
+// DNS_TIMEOUT_MS * DNS_TRIES before the connect starts. The same goes for
+// asyncHttpPoll() when a reused connection turns out dead and reconnects.
+bool asyncHttpStart(const AsyncHttpRequest& req);
+
+// Wait up to waitMs for socket activity, advance every request and fire
+// callbacks for the ones that finished
+void asyncHttpPoll(uint32_t waitMs);
+
+bool asyncHttpIdle();
+uint8_t asyncHttpInFlight();
+
+// Close every parked connection (before the radio goes down)
+void asyncHttpCloseIdle();
+
+// 💾 The newest TLS session, serialized for RTC memory so the first
+// handshake after deep sleep can resume. 0 if there is none (or it doesn't
+// fit cap); both are no-ops where resumption isn't built in.
+size_t asyncHttpSaveTlsSession(uint8_t* buf, size_t cap);
+bool asyncHttpLoadTlsSession(const uint8_t* buf, size_t len);
@@ -0,0 +1,134 @@
+#include "backfill.h"
+#include <math.h>
+#include <string.h>
+
+// obs_st row layout
+enum ObsStField : uint8_t {
+  OBS_EPOCH = 0,
+  OBS_WIND_LULL,
+  OBS_WIND_AVG,
+  OBS_WIND_GUST,
+  OBS_WIND_DIR,
+  OBS_WIND_INTERVAL,
+  OBS_STATION_PRESSURE,
+  OBS_AIR_TEMP,
+  OBS_HUMIDITY,
+  OBS_ILLUMINANCE,
+  OBS_UV,
+  OBS_SOLAR,
+  OBS_RAIN            // mm over the previous minute
+};
+
+static bool emitRow(ObsRowParser& p) {
+  const float* f = p.fields;
+  if (isnan(f[OBS_EPOCH]) || isnan(f[OBS_AIR_TEMP])) return true;  // Sensor gap
+
+  HistorySample s;
+  s.timestamp = (uint32_t)f[OBS_EPOCH];
+  s.temp_f = f[OBS_AIR_TEMP] * 9.0f / 5.0f + 32.0f;
+  s.pressure_mb = f[OBS_STATION_PRESSURE] + p.seaLevelOffset;
+  s.humidity = f[OBS_HUMIDITY];
+  s.wind_avg = f[OBS_WIND_AVG];
+  s.wind_gust = f[OBS_WIND_GUST];
+  s.wind_dir = f[OBS_WIND_DIR];
+  s.rain_mm = f[OBS_RAIN];
+  s.uv = f[OBS_UV];
+  p.rows++;
+  return p.emit(s, p.ctx);
+}
+
+// {"obs": [[epoch, lull, avg, ...], ...], ...}: the obs key sits at depth 1,
+// rows at depth 2 and their fields at depth 3
+static bool onObsToken(const JsonToken& tok, void* ctx) {
+  ObsRowParser& p = *(ObsRowParser*)ctx;
+
+  switch (tok.event) {
+    case JSON_KEY:
+      p.armed = tok.depth == 1 && strcmp(tok.text, "obs") == 0;
+      return true;
+    case JSON_ARRAY_START:
+      if (tok.depth == 1 && p.armed) p.inRows = true;
+      if (tok.depth == 2 && p.inRows) {
+        p.field = 0;
+        for (uint8_t i = 0; i < OBS_ST_COLUMNS; i++) p.fields[i] = NAN;
+      }
+      return true;
+    case JSON_NUMBER:
+    case JSON_NULL:
+      if (tok.depth == 3 && p.inRows) {
+        if (p.field < OBS_ST_COLUMNS && tok.event == JSON_NUMBER) {
+          p.fields[p.field] = (float)tok.number;
+        }
+        p.field++;
+      }
+      return true;
+    case JSON_ARRAY_END:
+      if (tok.depth == 2 && p.inRows) return emitRow(p);
+      if (tok.depth == 1 && p.inRows) {
+        p.inRows = false;
+        p.armed = false;
+        return false;  // 🏁 Everything after the rows is summary we don't need
+      }
+      return true;
+    default:
+      return true;
+  }
+}
+
+void obsRowsBegin(ObsRowParser& p, float seaLevelOffset, HistoryVisitor emit, void* ctx) {
+  memset(&p, 0, sizeof(p));
+  p.emit = emit;
+  p.ctx = ctx;
+  p.seaLevelOffset = seaLevelOffset;
+  jsonStreamBegin(p.js, onObsToken, &p);
+}
+
+bool obsRowsFeed(ObsRowParser& p, const uint8_t* data, size_t len) {
+  return jsonStreamFeed(p.js, data, len);
+}
+
+// Each device object carries "device_id" and "device_type" at the same
+// depth; the object closes one level up
+static bool onStationToken(const JsonToken& tok, void* ctx) {
+  DeviceLookup& d = *(DeviceLookup*)ctx;
+
+  switch (tok.event) {
+    case JSON_KEY:
+      strncpy(d.key, tok.text, sizeof(d.key) - 1);
+      d.key[sizeof(d.key) - 1] = '\0';
+      return true;
+    case JSON_NUMBER:
+      if (strcmp(d.key, "device_id") == 0) {
+        d.candidate = (long)tok.number;
+        d.idDepth = tok.depth;
+      }
+      break;
+    case JSON_STRING:
+      if (strcmp(d.key, "device_type") == 0 && strcmp(tok.text, "ST") == 0) {
+        d.isTempest = true;
+        d.typeDepth = tok.depth;
+      }
+      break;
+    case JSON_OBJECT_END:
+      if (d.isTempest && d.idDepth == d.typeDepth && tok.depth + 1 == d.idDepth) {
+        d.deviceId = d.candidate;
+        return false;  // 🎯 Found it, drop the rest
+      }
+      if (tok.depth + 1 == d.idDepth || tok.depth + 1 == d.typeDepth) {
+        d.isTempest = false;
+        d.idDepth = d.typeDepth = 0;
+      }
+      break;
+  }
+  d.key[0] = '\0';
+  return true;
+}
+
+void deviceLookupBegin(DeviceLookup& d) {
+  memset(&d, 0, sizeof(d));
+  jsonStreamBegin(d.js, onStationToken, &d);
+}
+
+bool deviceLookupFeed(DeviceLookup& d, const uint8_t* data, size_t len) {
+  return jsonStreamFeed(d.js, data, len);
+}
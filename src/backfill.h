@@ -0,0 +1,41 @@
+#pragma once
+#include "history.h"
+#include "json_stream.h"
+
+// ⏮️ Streaming decoders for the Tempest history backfill
+//
+// The device observations endpoint answers with one obs_st row per minute,
+// far too large to buffer. Both decoders sit on the JSON tokenizer and are
+// fed straight from the HTTP body sink; each finished row is converted to a
+// HistorySample and handed out before the next byte arrives.
+
+const uint8_t OBS_ST_COLUMNS = 13;  // obs_st columns up to the per-minute rain
+
+struct ObsRowParser {
+  JsonStream js;
+  HistoryVisitor emit;
+  void* ctx;
+  float seaLevelOffset;   // Rows carry station pressure; live obs are sea level
+  bool armed;             // Saw the top-level "obs" key
+  bool inRows;
+  uint8_t field;
+  float fields[OBS_ST_COLUMNS];
+  size_t rows;
+};
+
+void obsRowsBegin(ObsRowParser& p, float seaLevelOffset, HistoryVisitor emit, void* ctx);
+bool obsRowsFeed(ObsRowParser& p, const uint8_t* data, size_t len);
+
+// 🔎 Finds the Tempest (ST) device id in a /stations/<id> response
+struct DeviceLookup {
+  JsonStream js;
+  char key[16];
+  uint8_t idDepth;
+  uint8_t typeDepth;
+  long candidate;
+  bool isTempest;
+  long deviceId;          // 0 until found
+};
+
+void deviceLookupBegin(DeviceLookup& d);
+bool deviceLookupFeed(DeviceLookup& d, const uint8_t* data, size_t len);
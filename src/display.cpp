@@ -0,0 +1,42 @@
+#include "display.h"
+
+// 👈 Prep Screen
+LGFX tft;
+LGFX_Sprite touchSprite(&tft);
+
+// Wifi Signal Bar Setup
+void showWiFiSignalBars(int strength) {
+  const int totalBars = 5;
+  const int barWidth = 20;
+  const int barSpacing = 5;
+  const int baseX = (240 - ((barWidth + barSpacing) * totalBars - barSpacing)) / 2;
+  const int baseY = 60;
+
+  tft.fillRect(0, baseY, 240, 40, TFT_SKYBLUE);  // Clear area
+
+  for (int i = 0; i < totalBars; i++) {
+    uint16_t color = (i < strength) ? TFT_GREEN : TFT_LIGHTGREY;
+    int barHeight = (i + 1) * 8;
+    int x = baseX + i * (barWidth + barSpacing);
+    int y = baseY + (40 - barHeight);
+    tft.fillRect(x, y, barWidth, barHeight, color);
+  }
+}
+
+// Screen Title Helper Module
+void drawScreenTitle(const char* title) {
+  tft.setFont(&fonts::Font4);  // Big bold title font
+  tft.fillRect(0, 0, 240, 50, TFT_SKYBLUE);  // 🧱 Taller title bar
+  int16_t titleX = (240 - tft.textWidth(title)) / 2;
+  tft.setTextColor(TFT_WHITE);
+  tft.drawString(title, titleX, 22);  // 🪂 Drop it down a bit
+}
+
+// Centered one-line message on a fresh background
+void drawCenteredMessage(const char* msg, uint16_t bg, uint16_t fg, int16_t y) {
+  tft.fillScreen(bg);
+  tft.setTextColor(fg);
+  tft.setFont(&fonts::Font4);
+  int16_t msgX = (240 - tft.textWidth(msg)) / 2;
+  tft.drawString(msg, msgX, y);
+}
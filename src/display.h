@@ -0,0 +1,16 @@
+#pragma once
+#include <LovyanGFX.hpp>     // LovyanGFX display framework
+#include "lgfx_user_setup.h" // Custom pinout and TFT setup
+
+// 👈 Shared panel + sprite (owned by display.cpp)
+extern LGFX tft;
+extern LGFX_Sprite touchSprite;
+
+// Wifi Signal Bar Setup
+void showWiFiSignalBars(int strength);
+
+// Screen Title Helper Module
+void drawScreenTitle(const char* title);
+
+// Centered one-line message on a fresh background
+void drawCenteredMessage(const char* msg, uint16_t bg, uint16_t fg, int16_t y);
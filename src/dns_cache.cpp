@@ -0,0 +1,344 @@
+#include "dns_cache.h"
+#include <Arduino.h>
+#include <ctype.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <strings.h>
+#include <unistd.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <sys/select.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#ifdef ARDUINO
+#include <lwip/dns.h>
+#include <esp_random.h>
+#endif
+
+struct DnsEntry {
+  char host[64];
+  uint32_t addr;
+  uint32_t expiresMs;
+  uint32_t usedMs;      // For eviction
+};
+
+static DnsEntry entries[DNS_CACHE_ENTRIES];
+static DnsCacheStats stats = {};
+static uint32_t serverAddr = 0;
+static uint16_t serverPort = 53;
+
+enum QueryResult : uint8_t {
+  QUERY_OK = 0,
+  QUERY_NXDOMAIN,     // The name doesn't exist
+  QUERY_NODATA,       // It does, but has no A record (IPv6 only, say)
+  QUERY_FAILED        // Timeout, SERVFAIL, garbage: worth serving stale
+};
+
+void dnsCacheSetServer(uint32_t addr, uint16_t port) {
+  serverAddr = addr;
+  serverPort = port;
+}
+
+DnsCacheStats dnsCacheStats() {
+  return stats;
+}
+
+const char* dnsSourceName(uint8_t source) {
+  switch (source) {
+    case DNS_LITERAL: return "literal";
+    case DNS_CACHED: return "cached";
+    case DNS_RESOLVED: return "resolved";
+    case DNS_STALE: return "stale";
+  }
+  return "none";
+}
+
+void dnsCacheClear() {
+  memset(entries, 0, sizeof(entries));
+  memset(&stats, 0, sizeof(stats));
+}
+
+static DnsEntry* findEntry(const char* host) {
+  for (uint8_t i = 0; i < DNS_CACHE_ENTRIES; i++) {
+    if (entries[i].host[0] && strcasecmp(entries[i].host, host) == 0) return &entries[i];
+  }
+  return nullptr;
+}
+
+// Signed, so millis() wrapping between store and use is harmless
+static bool expired(const DnsEntry& e, uint32_t now) {
+  return (int32_t)(now - e.expiresMs) >= 0;
+}
+
+static void storeEntry(const char* host, uint32_t addr, uint32_t ttlS, uint32_t now) {
+  DnsEntry* e = findEntry(host);
+  if (!e) {
+    e = &entries[0];
+    for (uint8_t i = 0; i < DNS_CACHE_ENTRIES; i++) {
+      if (!entries[i].host[0]) {
+        e = &entries[i];
+        break;
+      }
+      if ((int32_t)(entries[i].usedMs - e->usedMs) < 0) e = &entries[i];
+    }
+    snprintf(e->host, sizeof(e->host), "%s", host);
+  }
+  if (ttlS > DNS_TTL_MAX_S) ttlS = DNS_TTL_MAX_S;
+  e->addr = addr;
+  e->expiresMs = now + ttlS * 1000;
+  e->usedMs = now;
+}
+
+// 🎲 Query IDs and source ports an off-path sender can't guess (RFC 5452)
+static uint32_t randomBits() {
+#ifdef ARDUINO
+  return esp_random();
+#else
+  static bool seeded = false;
+  if (!seeded) {
+    srandom((unsigned)time(nullptr) ^ ((unsigned)getpid() << 16) ^ (unsigned)micros());
+    seeded = true;
+  }
+  return random();
+#endif
+}
+
+// Somewhere in 49152-65535; lwIP would otherwise hand out ports in sequence
+static bool bindRandomPort(int fd) {
+  sockaddr_in local;
+  memset(&local, 0, sizeof(local));
+  local.sin_family = AF_INET;
+  local.sin_addr.s_addr = htonl(INADDR_ANY);
+  for (uint8_t attempt = 0; attempt < 8; attempt++) {
+    local.sin_port = htons(49152 + randomBits() % 16384);
+    if (bind(fd, (const sockaddr*)&local, sizeof(local)) == 0) return true;
+    if (errno != EADDRINUSE) return false;
+  }
+  return false;
+}
+
+// 📨 Wire format (RFC 1035)
+
+// Header + QNAME + QTYPE/QCLASS; 0 if the name can't be encoded
+static size_t writeQuery(uint8_t* buf, size_t cap, uint16_t id, const char* host) {
+  size_t hostLen = strlen(host);
+  if (hostLen == 0 || hostLen > 253 || cap < 12 + hostLen + 2 + 4) return 0;
+  memset(buf, 0, 12);
+  buf[0] = id >> 8;
+  buf[1] = id & 0xFF;
+  buf[2] = 0x01;        // RD
+  buf[5] = 1;           // QDCOUNT
+  size_t n = 12;
+  const char* label = host;
+  while (*label) {
+    const char* dot = strchr(label, '.');
+    size_t len = dot ? (size_t)(dot - label) : strlen(label);
+    if (len == 0 || len > 63) return 0;
+    buf[n++] = len;
+    memcpy(buf + n, label, len);
+    n += len;
+    label += len + (dot ? 1 : 0);
+  }
+  buf[n++] = 0;
+  buf[n++] = 0;
+  buf[n++] = 1;         // A
+  buf[n++] = 0;
+  buf[n++] = 1;         // IN
+  return n;
+}
+
+// Past a (possibly compressed) name; 0 if it runs off the end
+static size_t skipName(const uint8_t* buf, size_t len, size_t pos) {
+  while (pos < len) {
+    uint8_t b = buf[pos];
+    if (b == 0) return pos + 1;
+    if ((b & 0xC0) == 0xC0) return pos + 2 <= len ? pos + 2 : 0;
+    pos += 1 + b;
+  }
+  return 0;
+}
+
+static uint16_t be16(const uint8_t* p) { return (p[0] << 8) | p[1]; }
+static uint32_t be32(const uint8_t* p) {
+  return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+// A reply to this query: same ID, and the one question is ours (QNAME in
+// any case, QTYPE A, QCLASS IN). Anything else is someone else's answer
+static bool answersQuery(const uint8_t* buf, size_t len, const uint8_t* query, size_t qLen) {
+  if (len < qLen || be16(buf) != be16(query) || !(buf[2] & 0x80) || be16(buf + 4) != 1) return false;
+  for (size_t i = 12; i < qLen; i++) {
+    if (tolower(buf[i]) != tolower(query[i])) return false;  // Label lengths are < 64, never letters
+  }
+  return true;
+}
+
+// The first A record; its TTL is capped by any CNAME before it. The reply
+// has passed answersQuery(), so the question ends where the query's did
+static QueryResult parseAnswer(const uint8_t* buf, size_t len, size_t qLen, uint32_t& addr,
+                               uint32_t& ttlS) {
+  uint8_t rcode = buf[3] & 0x0F;
+  if (rcode == 3) return QUERY_NXDOMAIN;
+  if (rcode != 0 || (buf[2] & 0x02)) return QUERY_FAILED;  // Error or truncated
+
+  size_t pos = qLen;
+  uint32_t chainTtl = DNS_TTL_MAX_S;
+  for (uint16_t a = be16(buf + 6); a > 0; a--) {
+    pos = skipName(buf, len, pos);
+    if (!pos || pos + 10 > len) return QUERY_FAILED;
+    uint16_t type = be16(buf + pos);
+    uint16_t cls = be16(buf + pos + 2);
+    uint32_t ttl = be32(buf + pos + 4);
+    uint16_t rdLen = be16(buf + pos + 8);
+    pos += 10;
+    if (pos + rdLen > len) return QUERY_FAILED;
+    if (cls == 1 && ttl < chainTtl) chainTtl = ttl;
+    if (type == 1 && cls == 1 && rdLen == 4) {
+      memcpy(&addr, buf + pos, 4);  // Already network order
+      ttlS = chainTtl;
+      return QUERY_OK;
+    }
+    pos += rdLen;
+  }
+  return QUERY_NODATA;
+}
+
+// 🔎 Which resolver to ask
+static bool pickServer(sockaddr_in& to) {
+  memset(&to, 0, sizeof(to));
+  to.sin_family = AF_INET;
+  to.sin_port = htons(serverPort);
+  if (serverAddr) {
+    to.sin_addr.s_addr = serverAddr;
+    return true;
+  }
+#ifdef ARDUINO
+  const ip_addr_t* dns = dns_getserver(0);
+  if (!dns || ip_addr_isany(dns) || !IP_IS_V4(dns)) return false;
+  to.sin_addr.s_addr = ip_2_ip4(dns)->addr;
+  to.sin_port = htons(53);
+  return true;
+#else
+  FILE* f = fopen("/etc/resolv.conf", "r");
+  if (!f) return false;
+  char line[128];
+  bool found = false;
+  while (!found && fgets(line, sizeof(line), f)) {
+    char ip[64];
+    found = sscanf(line, " nameserver %63s", ip) == 1 && inet_aton(ip, &to.sin_addr);
+  }
+  fclose(f);
+  to.sin_port = htons(53);
+  return found;
+#endif
+}
+
+static QueryResult queryServer(const sockaddr_in& to, const char* host, uint32_t& addr,
+                               uint32_t& ttlS) {
+  uint8_t query[12 + 255 + 4];
+  size_t qLen = writeQuery(query, sizeof(query), randomBits() & 0xFFFF, host);
+  if (!qLen) return QUERY_NXDOMAIN;
+
+  int fd = socket(AF_INET, SOCK_DGRAM, 0);
+  if (fd < 0) return QUERY_FAILED;
+  if (!bindRandomPort(fd)) {
+    close(fd);
+    return QUERY_FAILED;
+  }
+  QueryResult result = QUERY_FAILED;
+  uint8_t buf[512];
+
+  for (uint8_t attempt = 0; attempt < DNS_TRIES && result == QUERY_FAILED; attempt++) {
+    if (sendto(fd, query, qLen, 0, (const sockaddr*)&to, sizeof(to)) != (ssize_t)qLen) break;
+    uint32_t startMs = millis();
+    while (true) {
+      uint32_t waited = millis() - startMs;
+      if (waited >= DNS_TIMEOUT_MS) break;
+      fd_set rd;
+      FD_ZERO(&rd);
+      FD_SET(fd, &rd);
+      timeval tv = { (long)((DNS_TIMEOUT_MS - waited) / 1000),
+                     (long)((DNS_TIMEOUT_MS - waited) % 1000) * 1000 };
+      if (select(fd + 1, &rd, nullptr, nullptr, &tv) <= 0) break;
+      sockaddr_in from;
+      socklen_t fromLen = sizeof(from);
+      ssize_t n = recvfrom(fd, buf, sizeof(buf), 0, (sockaddr*)&from, &fromLen);
+      if (n <= 0) break;
+      if (from.sin_addr.s_addr != to.sin_addr.s_addr || from.sin_port != to.sin_port) continue;
+      if (!answersQuery(buf, n, query, qLen)) continue;  // Spoofed, or meant for another query
+      result = parseAnswer(buf, n, qLen, addr, ttlS);
+      break;
+    }
+  }
+  close(fd);
+  return result;
+}
+
+// No server to ask: the system resolver, with a guessed TTL
+static QueryResult queryFallback(const char* host, uint32_t& addr, uint32_t& ttlS) {
+  addrinfo hints = {};
+  hints.ai_family = AF_INET;
+  hints.ai_socktype = SOCK_STREAM;
+  addrinfo* res = nullptr;
+  int rc = getaddrinfo(host, nullptr, &hints, &res);
+#ifdef EAI_NODATA
+  if (rc == EAI_NODATA) return QUERY_NODATA;
+#endif
+  if (rc != 0 || !res) return rc == EAI_NONAME ? QUERY_NXDOMAIN : QUERY_FAILED;
+  addr = ((sockaddr_in*)res->ai_addr)->sin_addr.s_addr;
+  ttlS = DNS_FALLBACK_TTL_S;
+  freeaddrinfo(res);
+  return QUERY_OK;
+}
+
+DnsSource dnsResolve(const char* host, uint32_t& addr) {
+  in_addr literal;
+  if (inet_aton(host, &literal)) {
+    addr = literal.s_addr;
+    return DNS_LITERAL;
+  }
+
+  uint32_t now = millis();
+  DnsEntry* e = findEntry(host);
+  if (e && !expired(*e, now)) {
+    stats.hits++;
+    e->usedMs = now;
+    addr = e->addr;
+    return DNS_CACHED;
+  }
+
+  stats.misses++;
+  sockaddr_in to;
+  uint32_t ttlS = 0;
+  bool asked = strchr(host, '.') && pickServer(to);   // "localhost" and co. aren't DNS names
+  QueryResult r = asked ? queryServer(to, host, addr, ttlS) : queryFallback(host, addr, ttlS);
+  now = millis();
+  if (r == QUERY_OK) {
+    if (ttlS) storeEntry(host, addr, ttlS, now);
+    else if (e) e->host[0] = '\0';  // TTL 0: use once, don't keep
+    return DNS_RESOLVED;
+  }
+
+  stats.failures++;
+  // Only NXDOMAIN says the name is gone. A NODATA name still exists, so its
+  // last address is as good a guess as after a timeout
+  if (r != QUERY_NXDOMAIN && e && now - e->expiresMs <= DNS_STALE_MAX_S * 1000) {
+    stats.stale++;
+    e->usedMs = now;
+    addr = e->addr;
+    Serial.printf("🧭 %s, %s from a %lu s stale entry\n",
+                  r == QUERY_NODATA ? "No A record" : "Resolver failed", host,
+                  (unsigned long)((now - e->expiresMs) / 1000));
+    return DNS_STALE;
+  }
+  if (e) e->host[0] = '\0';
+  // Nothing stale to serve: the system resolver may still know (hosts file)
+  if (r == QUERY_FAILED && asked && queryFallback(host, addr, ttlS) == QUERY_OK) {
+    storeEntry(host, addr, ttlS, millis());
+    return DNS_RESOLVED;
+  }
+  return DNS_NONE;
+}
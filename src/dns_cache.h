@@ -0,0 +1,57 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+// 🧭 Name lookups for async_http, cached for as long as their TTL says
+//
+// Every refresh used to resolve swd.weatherflow.com or
+// api.openweathermap.org again: a round trip to the resolver per request,
+// and a failed refresh whenever the resolver hiccupped. Lookups here send
+// their own A query over UDP (lwIP on the device, so it also builds and
+// runs on Linux) because getaddrinfo() hides the TTL. An answer is reused
+// until its TTL runs out. If the resolver then times out or fails, the
+// expired address is served for up to DNS_STALE_MAX_S more (RFC 8767),
+// and with nothing to serve getaddrinfo() gets a try. A NXDOMAIN is an
+// answer and drops the entry instead. NODATA (the name exists, but only
+// with other record types) doesn't: it fails the lookup and leaves the
+// entry to be served stale like a timeout.
+//
+// Each query has a random ID and a random source port, and a reply only
+// counts if it repeats our question, so a forged answer has to guess both.
+//
+// Call from one task only (the net task); there is no lock.
+
+enum DnsSource : uint8_t {
+  DNS_NONE = 0,      // Not resolved (failed, or no lookup was needed)
+  DNS_LITERAL,       // The host was already an IPv4 address
+  DNS_CACHED,        // Hit: fresh cache entry
+  DNS_RESOLVED,      // Miss: the resolver answered
+  DNS_STALE          // Miss, resolver failed: expired entry served
+};
+
+struct DnsCacheStats {
+  uint32_t hits;
+  uint32_t misses;     // Went to the resolver, stale answers included
+  uint32_t stale;
+  uint32_t failures;   // Resolver timed out, refused, or had no address
+};
+
+const uint8_t DNS_CACHE_ENTRIES = 4;
+const uint32_t DNS_TTL_MAX_S = 86400;       // Longer TTLs are capped
+const uint32_t DNS_STALE_MAX_S = 86400;     // Serve-stale window past expiry
+const uint32_t DNS_FALLBACK_TTL_S = 60;     // getaddrinfo() answers, no TTL known
+const uint32_t DNS_TIMEOUT_MS = 1500;       // Per try
+const uint8_t DNS_TRIES = 2;
+
+// Address in network byte order. Blocks for up to
+// DNS_TIMEOUT_MS * DNS_TRIES on a miss. DNS_NONE when nothing usable came back.
+DnsSource dnsResolve(const char* host, uint32_t& addr);
+
+// Resolver to query, address in network byte order. 0 picks the
+// platform's: lwIP's first DNS server on the device, /etc/resolv.conf on
+// a PC, else getaddrinfo() with DNS_FALLBACK_TTL_S.
+void dnsCacheSetServer(uint32_t addr, uint16_t port = 53);
+
+DnsCacheStats dnsCacheStats();
+const char* dnsSourceName(uint8_t source);   // "cached", "stale", ...
+void dnsCacheClear();                        // Entries and stats
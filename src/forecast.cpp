@@ -0,0 +1,158 @@
+#include "forecast.h"
+#include <string.h>
+
+enum Section : uint8_t {
+  SECTION_NONE = 0,
+  SECTION_DAILY,
+  SECTION_HOURLY
+};
+
+// better_forecast icon names minus the "possibly-" prefix and "-day"/"-night"
+static const struct {
+  const char* name;
+  uint8_t icon;
+} iconNames[] = {
+  { "clear", ICON_CLEAR },
+  { "partly-cloudy", ICON_PARTLY_CLOUDY },
+  { "cloudy", ICON_CLOUDY },
+  { "foggy", ICON_FOG },
+  { "windy", ICON_WINDY },
+  { "rainy", ICON_RAIN },
+  { "sleet", ICON_SLEET },
+  { "snow", ICON_SNOW },
+  { "thunderstorm", ICON_STORM },
+};
+
+uint8_t forecastIconFromName(const char* name) {
+  if (strncmp(name, "possibly-", 9) == 0) name += 9;
+  size_t len = strlen(name);
+  if (len > 4 && strcmp(name + len - 4, "-day") == 0) {
+    len -= 4;
+  } else if (len > 6 && strcmp(name + len - 6, "-night") == 0) {
+    len -= 6;
+  }
+  for (const auto& entry : iconNames) {
+    if (strlen(entry.name) == len && strncmp(entry.name, name, len) == 0) return entry.icon;
+  }
+  return ICON_UNKNOWN;
+}
+
+static uint8_t percent(double v) {
+  if (v < 0) return 0;
+  if (v > 100) return 100;
+  return (uint8_t)v;
+}
+
+static bool listsFull(const ForecastParser& p) {
+  return p.out->hourCount == FORECAST_HOURS && p.out->dayCount == FORECAST_DAYS;
+}
+
+static void hourField(ForecastHour& h, const char* key, const JsonToken& tok) {
+  if (tok.event == JSON_STRING) {
+    if (strcmp(key, "icon") == 0) h.icon = forecastIconFromName(tok.text);
+    return;
+  }
+  if (tok.event != JSON_NUMBER) return;
+  if (strcmp(key, "time") == 0) h.time = (uint32_t)tok.number;
+  else if (strcmp(key, "air_temperature") == 0) h.temp_f = (float)tok.number;
+  else if (strcmp(key, "wind_avg") == 0) h.wind_avg = (float)tok.number;
+  else if (strcmp(key, "precip_probability") == 0) h.precipPct = percent(tok.number);
+  else if (strcmp(key, "local_hour") == 0) h.localHour = (uint8_t)tok.number;
+}
+
+static void dayField(ForecastDay& d, const char* key, const JsonToken& tok) {
+  if (tok.event == JSON_STRING) {
+    if (strcmp(key, "icon") == 0) d.icon = forecastIconFromName(tok.text);
+    return;
+  }
+  if (tok.event != JSON_NUMBER) return;
+  if (strcmp(key, "day_start_local") == 0) d.dayStart = (uint32_t)tok.number;
+  else if (strcmp(key, "air_temp_high") == 0) d.high_f = (float)tok.number;
+  else if (strcmp(key, "air_temp_low") == 0) d.low_f = (float)tok.number;
+  else if (strcmp(key, "precip_probability") == 0) d.precipPct = percent(tok.number);
+}
+
+// {"forecast": {"daily": [{...}, ...], "hourly": [{...}, ...]}, ...}
+// "forecast" is a depth-1 key, the list keys depth 2, entries open at
+// depth 3 and their fields sit at depth 4
+static bool onForecastToken(const JsonToken& tok, void* ctx) {
+  ForecastParser& p = *(ForecastParser*)ctx;
+  Forecast& f = *p.out;
+
+  switch (tok.event) {
+    case JSON_KEY:
+      if (tok.depth == 1) {
+        p.armed = strcmp(tok.text, "forecast") == 0;
+      } else if (tok.depth == 2 && p.armed) {
+        p.section = strcmp(tok.text, "daily") == 0    ? SECTION_DAILY
+                    : strcmp(tok.text, "hourly") == 0 ? SECTION_HOURLY
+                                                      : SECTION_NONE;
+      } else if (tok.depth == 4) {
+        strncpy(p.key, tok.text, sizeof(p.key) - 1);
+        p.key[sizeof(p.key) - 1] = '\0';
+      }
+      return true;
+
+    case JSON_OBJECT_START:
+      if (tok.depth == 3) {
+        p.hour = {};
+        p.day = {};
+      }
+      return true;
+
+    case JSON_OBJECT_END:
+      if (tok.depth == 3) {
+        if (p.section == SECTION_HOURLY && f.hourCount < FORECAST_HOURS) {
+          f.hours[f.hourCount++] = p.hour;
+        } else if (p.section == SECTION_DAILY && f.dayCount < FORECAST_DAYS) {
+          f.days[f.dayCount++] = p.day;
+        }
+        if (listsFull(p)) return false;  // 🏁 Nothing further is kept
+      }
+      if (tok.depth == 1) p.armed = false;
+      return true;
+
+    case JSON_ARRAY_END:
+      if (tok.depth == 2) p.section = SECTION_NONE;
+      return true;
+
+    default:
+      if (tok.depth != 4) return true;
+      if (p.section == SECTION_HOURLY && f.hourCount < FORECAST_HOURS) {
+        hourField(p.hour, p.key, tok);
+      } else if (p.section == SECTION_DAILY && f.dayCount < FORECAST_DAYS) {
+        dayField(p.day, p.key, tok);
+      }
+      return true;
+  }
+}
+
+void forecastParseBegin(ForecastParser& p, Forecast& out) {
+  memset(&p, 0, sizeof(p));
+  memset(&out, 0, sizeof(out));
+  p.out = &out;
+  jsonStreamBegin(p.js, onForecastToken, &p);
+}
+
+bool forecastParseFeed(ForecastParser& p, const uint8_t* data, size_t len) {
+  return jsonStreamFeed(p.js, data, len);
+}
+
+bool forecastParseOk(const ForecastParser& p) {
+  return !jsonStreamFailed(p.js) && p.out->hourCount > 0;
+}
+
+const char* forecastIconLabel(uint8_t icon) {
+  switch (icon) {
+    case ICON_CLEAR:         return "Clear";
+    case ICON_PARTLY_CLOUDY: return "Partly";
+    case ICON_CLOUDY:        return "Cloudy";
+    case ICON_FOG:           return "Fog";
+    case ICON_WINDY:         return "Windy";
+    case ICON_RAIN:          return "Rain";
+    case ICON_SLEET:         return "Sleet";
+    case ICON_SNOW:          return "Snow";
+    case ICON_STORM:         return "Storm";
+    default:                 return "";
+  }
+}
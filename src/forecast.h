@@ -0,0 +1,71 @@
+#pragma once
+#include "json_stream.h"
+
+// 🗓️ Compact forecast pulled out of a streamed better_forecast response
+//
+// The payload runs to tens of KB (ten days of hourly rows). The parser keeps
+// only the first FORECAST_HOURS hourly and FORECAST_DAYS daily entries and
+// stops the stream once both are full, so time and memory are bounded by
+// those counts, not by the payload.
+
+const uint8_t FORECAST_HOURS = 12;
+const uint8_t FORECAST_DAYS = 5;
+
+enum ForecastIcon : uint8_t {
+  ICON_UNKNOWN = 0,
+  ICON_CLEAR,
+  ICON_PARTLY_CLOUDY,
+  ICON_CLOUDY,
+  ICON_FOG,
+  ICON_WINDY,
+  ICON_RAIN,
+  ICON_SLEET,
+  ICON_SNOW,
+  ICON_STORM
+};
+
+struct ForecastHour {
+  uint32_t time;       // Epoch seconds
+  float temp_f;
+  float wind_avg;      // m/s
+  uint8_t precipPct;
+  uint8_t localHour;   // 0-23, station time
+  uint8_t icon;        // ForecastIcon
+};
+
+struct ForecastDay {
+  uint32_t dayStart;   // Epoch seconds of local midnight
+  float high_f;
+  float low_f;
+  uint8_t precipPct;
+  uint8_t icon;
+};
+
+struct Forecast {
+  uint8_t hourCount;
+  uint8_t dayCount;
+  ForecastHour hours[FORECAST_HOURS];
+  ForecastDay days[FORECAST_DAYS];
+};
+
+struct ForecastParser {
+  JsonStream js;
+  Forecast* out;
+  uint8_t section;     // Which forecast list we're in
+  bool armed;          // Saw the top-level "forecast" key
+  char key[24];
+  ForecastHour hour;
+  ForecastDay day;
+};
+
+void forecastParseBegin(ForecastParser& p, Forecast& out);
+
+// false once both lists are full (the rest can be dropped) or the JSON is bad
+bool forecastParseFeed(ForecastParser& p, const uint8_t* data, size_t len);
+
+// Well-formed so far with at least one hourly entry
+bool forecastParseOk(const ForecastParser& p);
+
+// ForecastIcon for a better_forecast icon name ("possibly-rainy-night", ...)
+uint8_t forecastIconFromName(const char* name);
+const char* forecastIconLabel(uint8_t icon);
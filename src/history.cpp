@@ -0,0 +1,239 @@
+#include "history.h"
+#include <math.h>
+#include <string.h>
+
+// Column order puts the usual movers in the low bitmap bits so the change
+// mask stays a single varint byte; rain and UV spill into a second byte
+enum HistoryColumn : uint8_t {
+  COL_TEMP = 0,
+  COL_WIND_AVG,
+  COL_WIND_GUST,
+  COL_WIND_DIR,
+  COL_PRESSURE,
+  COL_HUMIDITY,
+  COL_TS,        // Delta-of-delta seconds
+  COL_RAIN,
+  COL_UV,
+  COL_COUNT
+};
+
+// Fixed-point steps per unit
+static const float colScale[COL_COUNT] = { 10, 10, 10, 1, 10, 1, 1, 100, 10 };
+
+// Sized for the 24 h backfill on noisy weather: a random walk moving every
+// sensor column every minute (test_history) averages ~9 bytes a sample, so
+// 56 blocks hold 29-32 h of it; calmer days hold far more
+static const uint8_t HISTORY_BLOCKS = 56;
+static const uint16_t BLOCK_BYTES = 256;
+static const size_t MAX_ENCODED = 3 + COL_COUNT * 5;  // Mask + worst-case varints
+
+struct Packed {
+  int32_t v[COL_COUNT];
+};
+
+struct HistoryBlock {
+  Packed key;        // First sample, absolute
+  uint16_t count;    // Samples including the keyframe
+  uint16_t used;     // Bytes of data[]
+  uint8_t data[BLOCK_BYTES];
+};
+
+static HistoryBlock blocks[HISTORY_BLOCKS];
+static uint8_t headBlock = 0;   // Oldest
+static uint8_t blockCount = 0;
+static Packed last;             // Newest sample, for O(1) deltas + latest
+static int32_t lastTsDelta = 0;
+static size_t sampleCount = 0;
+
+// A column with no reading (NaN in the sample); quantize() never returns it
+static const int32_t NO_READING = INT32_MIN;
+static const float QUANT_LIMIT = 2e9f;
+
+static int32_t quantize(float v, uint8_t col) {
+  if (isnan(v)) return NO_READING;
+  float q = v * colScale[col];
+  if (q > QUANT_LIMIT) q = QUANT_LIMIT;
+  if (q < -QUANT_LIMIT) q = -QUANT_LIMIT;
+  return (int32_t)lroundf(q);
+}
+
+static float dequantize(int32_t v, uint8_t col) {
+  return v == NO_READING ? NAN : v / colScale[col];
+}
+
+// Deltas wrap, so a column going to or from NO_READING still round-trips
+static int32_t delta(int32_t to, int32_t from) {
+  return (int32_t)((uint32_t)to - (uint32_t)from);
+}
+
+static Packed pack(const HistorySample& s) {
+  Packed p;
+  p.v[COL_TEMP] = quantize(s.temp_f, COL_TEMP);
+  p.v[COL_WIND_AVG] = quantize(s.wind_avg, COL_WIND_AVG);
+  p.v[COL_WIND_GUST] = quantize(s.wind_gust, COL_WIND_GUST);
+  p.v[COL_WIND_DIR] = quantize(s.wind_dir, COL_WIND_DIR);
+  p.v[COL_PRESSURE] = quantize(s.pressure_mb, COL_PRESSURE);
+  p.v[COL_HUMIDITY] = quantize(s.humidity, COL_HUMIDITY);
+  p.v[COL_TS] = (int32_t)s.timestamp;
+  p.v[COL_RAIN] = quantize(s.rain_mm, COL_RAIN);
+  p.v[COL_UV] = quantize(s.uv, COL_UV);
+  return p;
+}
+
+static HistorySample unpack(const Packed& p) {
+  HistorySample s;
+  s.timestamp = (uint32_t)p.v[COL_TS];
+  s.temp_f = dequantize(p.v[COL_TEMP], COL_TEMP);
+  s.wind_avg = dequantize(p.v[COL_WIND_AVG], COL_WIND_AVG);
+  s.wind_gust = dequantize(p.v[COL_WIND_GUST], COL_WIND_GUST);
+  s.wind_dir = dequantize(p.v[COL_WIND_DIR], COL_WIND_DIR);
+  s.pressure_mb = dequantize(p.v[COL_PRESSURE], COL_PRESSURE);
+  s.humidity = dequantize(p.v[COL_HUMIDITY], COL_HUMIDITY);
+  s.rain_mm = dequantize(p.v[COL_RAIN], COL_RAIN);
+  s.uv = dequantize(p.v[COL_UV], COL_UV);
+  return s;
+}
+
+static size_t putVarint(uint8_t* out, uint32_t v) {
+  size_t n = 0;
+  while (v >= 0x80) {
+    out[n++] = (uint8_t)(v | 0x80);
+    v >>= 7;
+  }
+  out[n++] = (uint8_t)v;
+  return n;
+}
+
+static uint32_t getVarint(const uint8_t*& in) {
+  uint32_t v = 0;
+  for (uint8_t shift = 0; shift < 35; shift += 7) {
+    uint8_t b = *in++;
+    v |= (uint32_t)(b & 0x7F) << shift;
+    if (!(b & 0x80)) break;
+  }
+  return v;
+}
+
+static uint32_t zigzag(int32_t v) {
+  return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+
+static int32_t unzigzag(uint32_t v) {
+  return (int32_t)(v >> 1) ^ -(int32_t)(v & 1);
+}
+
+static HistoryBlock& block(uint8_t i) {
+  return blocks[(headBlock + i) % HISTORY_BLOCKS];
+}
+
+static HistoryBlock& openBlock(const Packed& key) {
+  if (blockCount == HISTORY_BLOCKS) {
+    sampleCount -= blocks[headBlock].count;  // 🔁 Drop the oldest block whole
+    headBlock = (headBlock + 1) % HISTORY_BLOCKS;
+    blockCount--;
+  }
+  HistoryBlock& b = block(blockCount++);
+  b.key = key;
+  b.count = 1;
+  b.used = 0;
+  lastTsDelta = 0;
+  return b;
+}
+
+bool historyAppend(const HistorySample& s) {
+  Packed p = pack(s);
+  if (sampleCount > 0 && p.v[COL_TS] <= last.v[COL_TS]) return false;
+
+  if (blockCount == 0) {
+    openBlock(p);
+  } else {
+    int32_t tsDelta = p.v[COL_TS] - last.v[COL_TS];
+    uint8_t enc[MAX_ENCODED];
+    uint32_t mask = 0;
+    uint32_t deltas[COL_COUNT];
+    for (uint8_t c = 0; c < COL_COUNT; c++) {
+      int32_t d = c == COL_TS ? tsDelta - lastTsDelta : delta(p.v[c], last.v[c]);
+      deltas[c] = zigzag(d);
+      if (d) mask |= 1u << c;
+    }
+
+    size_t n = putVarint(enc, mask);
+    for (uint8_t c = 0; c < COL_COUNT; c++) {
+      if (mask & (1u << c)) n += putVarint(enc + n, deltas[c]);
+    }
+
+    HistoryBlock& b = block(blockCount - 1);
+    if (b.used + n > BLOCK_BYTES) {
+      openBlock(p);
+    } else {
+      memcpy(b.data + b.used, enc, n);
+      b.used += n;
+      b.count++;
+      lastTsDelta = tsDelta;
+    }
+  }
+
+  last = p;
+  sampleCount++;
+  return true;
+}
+
+// Decode one block, visiting samples at or after since
+static bool visitBlock(const HistoryBlock& b, uint32_t since, HistoryVisitor visit,
+                       void* ctx, size_t& visited) {
+  Packed p = b.key;
+  int32_t tsDelta = 0;
+  const uint8_t* in = b.data;
+
+  for (uint16_t i = 0; i < b.count; i++) {
+    if (i > 0) {
+      uint32_t mask = getVarint(in);
+      for (uint8_t c = 0; c < COL_COUNT; c++) {
+        int32_t d = (mask & (1u << c)) ? unzigzag(getVarint(in)) : 0;
+        if (c == COL_TS) {
+          tsDelta += d;
+          p.v[COL_TS] += tsDelta;
+        } else {
+          p.v[c] = (int32_t)((uint32_t)p.v[c] + (uint32_t)d);
+        }
+      }
+    }
+    if ((uint32_t)p.v[COL_TS] < since) continue;
+    visited++;
+    if (!visit(unpack(p), ctx)) return false;
+  }
+  return true;
+}
+
+size_t historyForEach(uint32_t since, HistoryVisitor visit, void* ctx) {
+  size_t visited = 0;
+  for (uint8_t i = 0; i < blockCount; i++) {
+    // ⏩ Whole block is older than the window if the next one starts before it
+    if (i + 1 < blockCount && (uint32_t)block(i + 1).key.v[COL_TS] <= since) continue;
+    if (!visitBlock(block(i), since, visit, ctx, visited)) break;
+  }
+  return visited;
+}
+
+bool historyLatest(HistorySample& out) {
+  if (sampleCount == 0) return false;
+  out = unpack(last);
+  return true;
+}
+
+size_t historyCount() {
+  return sampleCount;
+}
+
+size_t historyBytesUsed() {
+  size_t bytes = 0;
+  for (uint8_t i = 0; i < blockCount; i++) bytes += sizeof(Packed) + block(i).used;
+  return bytes;
+}
+
+void historyClear() {
+  headBlock = 0;
+  blockCount = 0;
+  sampleCount = 0;
+  lastTsDelta = 0;
+}
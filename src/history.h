@@ -0,0 +1,39 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+// 📈 RAM ring of Tempest samples, delta/varint encoded
+//
+// Samples are quantized to fixed-point columns and packed into small blocks:
+// each block opens with an absolute keyframe, then every later sample stores
+// a varint bitmap of the columns that changed followed by their zigzag
+// deltas (timestamps as delta-of-delta). Slow-moving columns cost nothing
+// most minutes, so the 24 h backfill fits in the ring even on gusty days.
+// A missing reading (NaN) is stored as such and reads back as NaN. Appends
+// are O(1); when the ring is full the oldest block is dropped whole.
+
+struct HistorySample {
+  uint32_t timestamp;   // Epoch seconds
+  float temp_f;
+  float pressure_mb;
+  float humidity;       // %
+  float wind_avg;       // m/s
+  float wind_gust;      // m/s
+  float wind_dir;       // Degrees
+  float rain_mm;        // Since the previous observation
+  float uv;
+};
+
+// Return false to stop early
+typedef bool (*HistoryVisitor)(const HistorySample& s, void* ctx);
+
+// Ignores samples not newer than the latest one (repeat polls)
+bool historyAppend(const HistorySample& s);
+
+// Visit samples with timestamp >= since, oldest first; returns the count
+size_t historyForEach(uint32_t since, HistoryVisitor visit, void* ctx);
+
+bool historyLatest(HistorySample& out);
+size_t historyCount();
+size_t historyBytesUsed();   // Encoded bytes, keyframes included
+void historyClear();
@@ -0,0 +1,122 @@
+#include "json_arena.h"
+#include <string.h>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#endif
+
+// Every block is preceded by this; offsets are from the arena start
+struct BlockHeader {
+  uint32_t size;   // Usable bytes, rounded up to ALIGN; FREED_BIT once released
+  uint32_t prev;   // Header offset of the block below, NO_BLOCK for the first
+};
+
+static const uint32_t ALIGN = 8;
+static const uint32_t HEADER = sizeof(BlockHeader);
+static const uint32_t FREED_BIT = 0x80000000u;
+static const uint32_t NO_BLOCK = 0xFFFFFFFFu;
+
+class JsonArena : public ArduinoJson::Allocator {
+ public:
+  void reset() {
+    top = 0;
+    last = NO_BLOCK;
+    peak = 0;
+    refused = 0;
+  }
+
+  void* allocate(size_t size) override {
+    uint32_t rounded = (size + ALIGN - 1) & ~(ALIGN - 1);
+    if (size > sizeof(buf) || top + HEADER + rounded > sizeof(buf)) {
+      refused++;
+      return nullptr;
+    }
+    BlockHeader* h = header(top);
+    h->size = rounded;
+    h->prev = last;
+    last = top;
+    top += HEADER + rounded;
+    if (top > peak) peak = top;
+    return buf + last + HEADER;
+  }
+
+  void deallocate(void* ptr) override {
+    if (!ptr) return;
+    header(offsetOf(ptr))->size |= FREED_BIT;
+    // 🔙 Roll the top back over every freed block sitting on it
+    while (last != NO_BLOCK && (header(last)->size & FREED_BIT)) {
+      top = last;
+      last = header(last)->prev;
+    }
+  }
+
+  void* reallocate(void* ptr, size_t newSize) override {
+    if (!ptr) return allocate(newSize);
+    uint32_t at = offsetOf(ptr);
+    BlockHeader* h = header(at);
+    uint32_t rounded = (newSize + ALIGN - 1) & ~(ALIGN - 1);
+
+    if (at == last) {
+      // ↕️ Newest block: grow or shrink in place
+      if (newSize > sizeof(buf) || at + HEADER + rounded > sizeof(buf)) {
+        refused++;
+        return nullptr;
+      }
+      h->size = rounded;
+      top = at + HEADER + rounded;
+      if (top > peak) peak = top;
+      return ptr;
+    }
+    if (rounded <= h->size) return ptr;  // Shrinking a buried block: keep it
+
+    void* moved = allocate(newSize);
+    if (!moved) return nullptr;
+    memcpy(moved, ptr, h->size);
+    deallocate(ptr);
+    return moved;
+  }
+
+  uint32_t peak = 0;
+  uint32_t refused = 0;
+
+ private:
+  BlockHeader* header(uint32_t at) {
+    return (BlockHeader*)(buf + at);
+  }
+
+  uint32_t offsetOf(void* ptr) {
+    return (uint8_t*)ptr - buf - HEADER;
+  }
+
+  alignas(ALIGN) uint8_t buf[JSON_ARENA_SIZE];
+  uint32_t top = 0;
+  uint32_t last = NO_BLOCK;
+};
+
+static JsonArena arena;
+static JsonArenaStats stats[JSON_PROVIDER_COUNT];
+
+ArduinoJson::Allocator* jsonArenaBegin() {
+  arena.reset();
+  return &arena;
+}
+
+void jsonArenaEnd(JsonProvider provider) {
+  JsonArenaStats& s = stats[provider];
+  s.lastPeak = arena.peak;
+  s.parses++;
+  s.overflows += arena.refused;
+  if (arena.peak <= s.highWater && !arena.refused) return;
+
+  if (arena.peak > s.highWater) s.highWater = arena.peak;
+#ifdef ARDUINO
+  static const char* const providerNames[JSON_PROVIDER_COUNT] = { "Tempest", "OpenWeather" };
+  Serial.printf("🧱 %s JSON high-water %u of %u arena bytes%s\n", providerNames[provider],
+                (unsigned)s.highWater, (unsigned)JSON_ARENA_SIZE,
+                arena.refused ? " (overflowed)" : "");
+#endif
+}
+
+const JsonArenaStats& jsonArenaStats(JsonProvider provider) {
+  return stats[provider];
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <ArduinoJson.h>
+
+// 🧱 Static arena behind every ArduinoJson document
+//
+// Documents allocate from one statically reserved block through ArduinoJson
+// 7's Allocator interface, so parsing never touches the general heap and
+// can't fragment it. Allocation bumps a pointer; freeing the newest block
+// (or a run of freed blocks at the top) rolls it back, which covers the
+// grow-a-string-then-shrink pattern the deserializer uses. Anything else is
+// reclaimed at the next jsonArenaBegin(). One document at a time, on the
+// network task.
+
+// Sized from the logged high-water marks plus headroom for payload growth
+const size_t JSON_ARENA_SIZE = 6144;
+
+enum JsonProvider : uint8_t {
+  JSON_TEMPEST = 0,
+  JSON_OPENWEATHER,
+  JSON_PROVIDER_COUNT
+};
+
+struct JsonArenaStats {
+  size_t highWater;     // Peak bytes over every parse, headers included
+  size_t lastPeak;
+  uint32_t parses;
+  uint32_t overflows;   // Allocations refused: the parse failed with NoMemory
+};
+
+// Empty the arena and hand it to a JsonDocument
+ArduinoJson::Allocator* jsonArenaBegin();
+
+// Fold this parse's peak into the provider's high-water mark (call while
+// the document is still alive or right after)
+void jsonArenaEnd(JsonProvider provider);
+
+const JsonArenaStats& jsonArenaStats(JsonProvider provider);
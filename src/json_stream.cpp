@@ -0,0 +1,230 @@
+#include "json_stream.h"
+#include <stdlib.h>
+#include <string.h>
+
+enum Expect : uint8_t {
+  EXPECT_VALUE = 0,
+  EXPECT_VALUE_OR_END,  // Just after '['
+  EXPECT_KEY,
+  EXPECT_KEY_OR_END,    // Just after '{'
+  EXPECT_COLON,
+  EXPECT_COMMA_OR_END,
+  EXPECT_NOTHING        // Top-level value complete
+};
+
+enum Lex : uint8_t {
+  LEX_NONE = 0,
+  LEX_STRING,
+  LEX_ESCAPE,
+  LEX_UNICODE,
+  LEX_NUMBER,
+  LEX_LITERAL
+};
+
+static bool emit(JsonStream& js, uint8_t event, const char* text = "", size_t len = 0,
+                 double number = 0, bool boolean = false) {
+  JsonToken tok;
+  tok.event = event;
+  tok.depth = js.depth;
+  tok.text = text;
+  tok.len = len;
+  tok.number = number;
+  tok.boolean = boolean;
+  if (!js.handler(tok, js.ctx)) js.stopped = true;
+  return !js.stopped;
+}
+
+static bool fail(JsonStream& js) {
+  js.failed = true;
+  return false;
+}
+
+static bool inObject(const JsonStream& js) {
+  return js.depth > 0 && (js.objects >> (js.depth - 1)) & 1;
+}
+
+static bool canStartValue(const JsonStream& js) {
+  return js.expect == EXPECT_VALUE || js.expect == EXPECT_VALUE_OR_END;
+}
+
+static void afterValue(JsonStream& js) {
+  js.expect = js.depth == 0 ? EXPECT_NOTHING : EXPECT_COMMA_OR_END;
+}
+
+static void append(JsonStream& js, char c) {
+  if (js.bufLen < JSON_TOKEN_MAX - 1) js.buf[js.bufLen++] = c;
+}
+
+static bool openContainer(JsonStream& js, bool object) {
+  if (!canStartValue(js) || js.depth >= JSON_MAX_DEPTH) return fail(js);
+  if (!emit(js, object ? JSON_OBJECT_START : JSON_ARRAY_START)) return false;
+  if (object) {
+    js.objects |= 1u << js.depth;
+  } else {
+    js.objects &= ~(1u << js.depth);
+  }
+  js.depth++;
+  js.expect = object ? EXPECT_KEY_OR_END : EXPECT_VALUE_OR_END;
+  return true;
+}
+
+static bool closeContainer(JsonStream& js, bool object) {
+  if (js.depth == 0 || inObject(js) != object) return fail(js);
+  uint8_t ok = object ? EXPECT_KEY_OR_END : EXPECT_VALUE_OR_END;
+  if (js.expect != ok && js.expect != EXPECT_COMMA_OR_END) return fail(js);
+  js.depth--;
+  afterValue(js);
+  return emit(js, object ? JSON_OBJECT_END : JSON_ARRAY_END);
+}
+
+static bool finishString(JsonStream& js) {
+  js.lex = LEX_NONE;
+  js.buf[js.bufLen] = '\0';
+  if (js.isKey) {
+    js.expect = EXPECT_COLON;
+    return emit(js, JSON_KEY, js.buf, js.bufLen);
+  }
+  afterValue(js);
+  return emit(js, JSON_STRING, js.buf, js.bufLen);
+}
+
+static bool finishNumber(JsonStream& js) {
+  js.lex = LEX_NONE;
+  if (js.bufLen >= JSON_TOKEN_MAX - 1) return fail(js);  // No sane number is this long
+  js.buf[js.bufLen] = '\0';
+  char* end;
+  double v = strtod(js.buf, &end);
+  if (end != js.buf + js.bufLen) return fail(js);
+  afterValue(js);
+  return emit(js, JSON_NUMBER, js.buf, js.bufLen, v);
+}
+
+static bool finishLiteral(JsonStream& js) {
+  js.lex = LEX_NONE;
+  js.buf[js.bufLen] = '\0';
+  afterValue(js);
+  if (strcmp(js.buf, "true") == 0) return emit(js, JSON_BOOL, js.buf, js.bufLen, 0, true);
+  if (strcmp(js.buf, "false") == 0) return emit(js, JSON_BOOL, js.buf, js.bufLen, 0, false);
+  if (strcmp(js.buf, "null") == 0) return emit(js, JSON_NULL, js.buf, js.bufLen);
+  return fail(js);
+}
+
+static char unescape(char c) {
+  switch (c) {
+    case 'n': return '\n';
+    case 't': return '\t';
+    case 'r': return '\r';
+    case 'b': return '\b';
+    case 'f': return '\f';
+    default:  return c;  // \" \\ \/
+  }
+}
+
+// Outside any token: whitespace, punctuation, or the start of a token
+static bool structural(JsonStream& js, char c) {
+  switch (c) {
+    case ' ': case '\t': case '\r': case '\n':
+      return true;
+    case '{': return openContainer(js, true);
+    case '[': return openContainer(js, false);
+    case '}': return closeContainer(js, true);
+    case ']': return closeContainer(js, false);
+    case ',':
+      if (js.expect != EXPECT_COMMA_OR_END) return fail(js);
+      js.expect = inObject(js) ? EXPECT_KEY : EXPECT_VALUE;
+      return true;
+    case ':':
+      if (js.expect != EXPECT_COLON) return fail(js);
+      js.expect = EXPECT_VALUE;
+      return true;
+    case '"':
+      js.isKey = js.expect == EXPECT_KEY || js.expect == EXPECT_KEY_OR_END;
+      if (!js.isKey && !canStartValue(js)) return fail(js);
+      js.lex = LEX_STRING;
+      js.bufLen = 0;
+      return true;
+  }
+
+  if (!canStartValue(js)) return fail(js);
+  js.bufLen = 0;
+  if (c == '-' || (c >= '0' && c <= '9')) {
+    js.lex = LEX_NUMBER;
+  } else if (c >= 'a' && c <= 'z') {
+    js.lex = LEX_LITERAL;
+  } else {
+    return fail(js);
+  }
+  append(js, c);
+  return true;
+}
+
+static bool isNumberChar(char c) {
+  return (c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E';
+}
+
+void jsonStreamBegin(JsonStream& js, JsonHandler handler, void* ctx) {
+  memset(&js, 0, sizeof(js));
+  js.handler = handler;
+  js.ctx = ctx;
+  js.expect = EXPECT_VALUE;
+}
+
+bool jsonStreamFeed(JsonStream& js, const uint8_t* data, size_t len) {
+  for (size_t i = 0; i < len; i++) {
+    if (js.failed || js.stopped) return false;
+    char c = (char)data[i];
+
+    switch (js.lex) {
+      case LEX_STRING:
+        if (c == '"') {
+          finishString(js);
+        } else if (c == '\\') {
+          js.lex = LEX_ESCAPE;
+        } else {
+          append(js, c);
+        }
+        continue;
+      case LEX_ESCAPE:
+        if (c == 'u') {
+          append(js, '?');
+          js.unicodeLeft = 4;
+          js.lex = LEX_UNICODE;
+        } else {
+          append(js, unescape(c));
+          js.lex = LEX_STRING;
+        }
+        continue;
+      case LEX_UNICODE:
+        if (--js.unicodeLeft == 0) js.lex = LEX_STRING;
+        continue;
+      case LEX_NUMBER:
+        if (isNumberChar(c)) {
+          append(js, c);
+          continue;
+        }
+        if (!finishNumber(js)) return false;
+        break;  // c still needs handling
+      case LEX_LITERAL:
+        if (c >= 'a' && c <= 'z') {
+          append(js, c);
+          continue;
+        }
+        if (!finishLiteral(js)) return false;
+        break;
+    }
+
+    if (js.expect == EXPECT_NOTHING && c != ' ' && c != '\t' && c != '\r' && c != '\n') {
+      return fail(js);  // Trailing garbage
+    }
+    structural(js, c);
+  }
+  return !js.failed && !js.stopped;
+}
+
+bool jsonStreamDone(const JsonStream& js) {
+  return !js.failed && js.expect == EXPECT_NOTHING && js.lex == LEX_NONE;
+}
+
+bool jsonStreamFailed(const JsonStream& js) {
+  return js.failed;
+}
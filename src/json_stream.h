@@ -0,0 +1,61 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+// 🌊 Incremental JSON tokenizer
+//
+// Bytes are fed as they come off the socket, split anywhere, and each token
+// is handed to a callback as soon as it completes. Only the token being
+// lexed is buffered, so memory is fixed no matter how large the document.
+// Strings longer than the token buffer are truncated; \u escapes become '?'.
+
+enum JsonEvent : uint8_t {
+  JSON_OBJECT_START = 0,
+  JSON_OBJECT_END,
+  JSON_ARRAY_START,
+  JSON_ARRAY_END,
+  JSON_KEY,
+  JSON_STRING,
+  JSON_NUMBER,
+  JSON_BOOL,
+  JSON_NULL
+};
+
+struct JsonToken {
+  uint8_t event;     // JsonEvent
+  uint8_t depth;     // Containers around the token; 0 = the top-level value
+  const char* text;  // Key, string or number text (NUL-terminated)
+  size_t len;
+  double number;
+  bool boolean;
+};
+
+// Return false to stop the stream
+typedef bool (*JsonHandler)(const JsonToken& tok, void* ctx);
+
+const size_t JSON_TOKEN_MAX = 64;
+const uint8_t JSON_MAX_DEPTH = 32;
+
+struct JsonStream {
+  JsonHandler handler;
+  void* ctx;
+  uint32_t objects;   // Bit per open container, set = object
+  uint8_t depth;
+  uint8_t expect;
+  uint8_t lex;
+  uint8_t unicodeLeft;
+  bool isKey;
+  bool failed;
+  bool stopped;
+  char buf[JSON_TOKEN_MAX];
+  size_t bufLen;
+};
+
+void jsonStreamBegin(JsonStream& js, JsonHandler handler, void* ctx);
+
+// false once the input is malformed or the handler stopped; later feeds
+// are ignored
+bool jsonStreamFeed(JsonStream& js, const uint8_t* data, size_t len);
+
+bool jsonStreamDone(const JsonStream& js);   // One complete top-level value
+bool jsonStreamFailed(const JsonStream& js); // Malformed (not just stopped)
@@ -1,280 +1,492 @@
 #include <Arduino.h>         // Required for delay(), Serial, etc.
-#include <WiFiManager.h>     // Captive portal WiFi config
-#include <ArduinoJson.h>     // JSON parsing for Tempest API
-#include <HTTPClient.h>      // Needed for HTTP requests
-#include <LovyanGFX.hpp>     // LovyanGFX display framework
-#include "lgfx_user_setup.h" // Custom pinout and TFT setup
 #include <Ticker.h> // For debounce timing
 #include <Wire.h>
-#include "background2.h"
+#include "display.h"
+#include "screens.h"
+#include "api.h"
+#include "obs_store.h"
+#include "obs_log.h"
+#include "power.h"
+#include "radio.h"
+#include "history.h"
+#include "stats.h"
+#include "tempest_udp.h"
+#include "wind_gauge.h"
+#include "perf.h"
+#include "metrics.h"
+#include "trace.h"
+#include <WiFi.h>
+#include <esp_timer.h>
 //#include "weather_icons.h"
 
-// 📲 OpenWeatherMap API for London
-const char* OPENWEATHER_API_KEY = "OPEN_WEATHER_API_KEY";
-const char* OPENWEATHER_LONDON_URL = "http://api.openweathermap.org/data/2.5/weather?q=London,UK&units=imperial&appid=";
-
 // 🧭 Track current screen state
 int currentScreen = 0;  // 0 = San Diego (Tempest), 1 = London (OpenWeather)
 bool shouldRedraw = true;
 const uint32_t screenInterval = 30000;  // 30 seconds
 unsigned long lastSwitchTime = 0;  
 
-// 👈 Prep Screen
-LGFX tft;
-LGFX_Sprite touchSprite(&tft);  
-
-// 🌤️ Tempest Station API URL (replace with another if gifting multiple)
-const char* TEMPEST_API_URL = "https://swd.weatherflow.com/swd/rest/observations/station/170405";
-const char* TEMPEST_API_KEY = "Tempest_API_KEY";
+// 📦 Latest reading per screen (warm-start values until fresh ones land)
+WeatherObs latestObs[SCREEN_COUNT];
+bool haveObs[SCREEN_COUNT] = {false};
+bool obsIsFresh[SCREEN_COUNT] = {false};
+Forecast forecast;  // haveObs/obsIsFresh[SCREEN_FORECAST] track it
+uint32_t lastRapidWindMs = 0;
+const uint32_t rapidWindTimeout = 60000;  // Wind screen drops out of rotation after this
+
+// 🌤️ The Tempest screen takes the stations in turn; latestObs[SCREEN_SAN_DIEGO]
+// mirrors the one up, station 0 is logged and feeds the history
+uint8_t tempestStation = 0;
+WeatherObs stationObs[TEMPEST_STATION_MAX];
+bool haveStation[TEMPEST_STATION_MAX] = {false};
+bool stationFresh[TEMPEST_STATION_MAX] = {false};
+
+// 🖼️ What the weather screen currently shows (-1 = something else)
+int shownScreen = -1;
+float shownTemp = 0;
+bool shownStale = false;
+
+// ⚡ Strike / rain alert composited over the current screen
+TempestEvent alertEvent;
+bool alertShowing = false;
+uint32_t alertShownAt = 0;
+const uint32_t alertDuration = 10000;
+
+// 🚀 Boot progress
+bool showingWeather = false;        // false = splash / WiFi status screens
+bool firstPixelReported = false;
+NetState shownNetState = NET_CONNECTING;
+int splashBars = 0;
+const uint32_t splashBarInterval = 400;
+unsigned long lastSplashBarTime = 0;
+
+// ⏱️ Time from reset to the first screen that shows real weather
+void reportFirstMeaningfulPixel(const char* what) {
+  if (firstPixelReported) return;
+  firstPixelReported = true;
+  Serial.printf("⏱️ First meaningful pixel (%s): %lu ms\n", what, millis());
+}
 
-void fetchAndDisplayWeather();
+void drawCurrentScreen() {
+  if (!haveObs[currentScreen]) return;
+  uint32_t start = micros();
+  traceBegin(TRACE_RENDER);
+  if (currentScreen == SCREEN_FORECAST) {
+    drawForecastScreen(forecast, !obsIsFresh[currentScreen]);
+  } else if (currentScreen == SCREEN_WIND) {
+    drawWindScreen();
+  } else if (currentScreen == SCREEN_SAN_DIEGO) {
+    drawTemperatureScreen(tempestStationName(tempestStation), latestObs[currentScreen].temp_f,
+                          !obsIsFresh[currentScreen], tempestStation == 0);
+  } else {
+    drawTemperatureScreen(screenTitle(currentScreen), latestObs[currentScreen].temp_f,
+                          !obsIsFresh[currentScreen], false);
+  }
+  shownScreen = currentScreen;
+  shownTemp = latestObs[currentScreen].temp_f;
+  shownStale = !obsIsFresh[currentScreen];
+  showingWeather = true;
+  reportFirstMeaningfulPixel(obsIsFresh[currentScreen] ? "live" : "cached");
+  if (alertShowing) drawAlertOverlay(alertEvent);  // Still on top after a refresh
+  traceEnd(TRACE_RENDER);
+  perfRecord(PERF_RENDER, micros() - start);
+}
 
-// Wifi Signal Bar Setup
-void showWiFiSignalBars(int strength) {
-  const int totalBars = 5;
-  const int barWidth = 20;
-  const int barSpacing = 5;
-  const int baseX = (240 - ((barWidth + barSpacing) * totalBars - barSpacing)) / 2;
-  const int baseY = 60;
+bool trendVisible() {
+  return shownScreen == SCREEN_SAN_DIEGO && tempestStation == 0;
+}
 
-  tft.fillRect(0, baseY, 240, 40, TFT_SKYBLUE);  // Clear area
+void showStation(uint8_t station) {
+  tempestStation = station;
+  latestObs[SCREEN_SAN_DIEGO] = stationObs[station];
+  haveObs[SCREEN_SAN_DIEGO] = haveStation[station];
+  obsIsFresh[SCREEN_SAN_DIEGO] = stationFresh[station];
+}
 
-  for (int i = 0; i < totalBars; i++) {
-    uint16_t color = (i < strength) ? TFT_GREEN : TFT_LIGHTGREY;
-    int barHeight = (i + 1) * 8;
-    int x = baseX + i * (barWidth + barSpacing);
-    int y = baseY + (40 - barHeight);
-    tft.fillRect(x, y, barWidth, barHeight, color);
+// Next station with a reading to show, back to the primary if none
+uint8_t nextStation() {
+  uint8_t count = tempestStationCount();
+  for (uint8_t i = 1; i <= count; i++) {
+    uint8_t s = (tempestStation + i) % count;
+    if (haveStation[s]) return s;
   }
+  return 0;
 }
 
-// Screen Title Helper Module
-void drawScreenTitle(const char* title) {
-  tft.setFont(&fonts::Font4);  // Big bold title font
-  tft.fillRect(0, 0, 240, 50, TFT_SKYBLUE);  // 🧱 Taller title bar
-  int16_t titleX = (240 - tft.textWidth(title)) / 2;
-  tft.setTextColor(TFT_WHITE);
-  tft.drawString(title, titleX, 22);  // 🪂 Drop it down a bit
+// 🖼️ Something other than a weather screen owns the panel now
+void screenCovered() {
+  shownScreen = -1;
+  alertShowing = false;
 }
 
-
-// Wind Direction Helper Module
-String windDirFromDegrees(float deg) {
-  const char* directions[] = {
-    "N", "NNE", "NE", "ENE",
-    "E", "ESE", "SE", "SSE",
-    "S", "SSW", "SW", "WSW",
-    "W", "WNW", "NW", "NNW"
-  };
-  int index = (int)((deg + 11.25) / 22.5);
-  return String(directions[index % 16]);
+void showAlert(const TempestEvent& ev) {
+  alertEvent = ev;
+  alertShownAt = millis();
+  if (shownScreen < 0) return;  // Setup and error screens keep the panel
+
+  int64_t startUs = esp_timer_get_time();
+  drawAlertOverlay(ev);
+  alertShowing = true;
+  int64_t doneUs = esp_timer_get_time();
+  Serial.printf("⚡ %s alert: event-to-pixel %lu us (waited %lu us, drew in %lu us)\n",
+                ev.type == EVENT_STRIKE ? "Strike" : "Rain",
+                (unsigned long)(doneUs - ev.receivedUs), (unsigned long)(startUs - ev.receivedUs),
+                (unsigned long)(doneUs - startUs));
 }
 
+// 🧭 rapid_wind feeds the dial; the other hub events raise an alert
+void handleTempestEvent(const TempestEvent& ev) {
+  if (ev.type != EVENT_RAPID_WIND) {
+    showAlert(ev);
+    return;
+  }
+  windGaugeUpdate(ev.windSpeed, ev.windDir, shownScreen == SCREEN_WIND && !alertShowing);
+  haveObs[SCREEN_WIND] = true;
+  obsIsFresh[SCREEN_WIND] = true;
+  lastRapidWindMs = millis();
+}
 
-//Setup the app
-void setup() {
-  Serial.begin(115200);
-  delay(1000);
-  Serial.println("🌈 Booting up Tempest Display...");
+bool windIsLive() {
+  return haveObs[SCREEN_WIND] && millis() - lastRapidWindMs < rapidWindTimeout;
+}
 
-  tft.init();
-  tft.setRotation(0);  // Adjust as needed for screen orientation
+// 🧽 Repaint just the box: clipped draws only send the pixels inside it
+void clearAlert() {
+  alertShowing = false;
+  uint32_t start = micros();
+  tft.setClipRect(ALERT_X, ALERT_Y, ALERT_W, ALERT_H);
+  drawCurrentScreen();
+  tft.clearClipRect();
+  Serial.printf("🧽 Alert cleared, %dx%d restored in %lu us\n", ALERT_W, ALERT_H,
+                micros() - start);
+}
 
-  tft.fillScreen(TFT_SKYBLUE);
-  tft.setTextColor(TFT_PURPLE);
-  tft.setFont(&fonts::Font2);
-
-  // 🎨 "Connecting WiFi..." splash
-  tft.setFont(&fonts::Font4);
-  tft.setTextColor(TFT_PURPLE);
-  String msg = "Connecting WiFi...";
-  int16_t msgX = (240 - tft.textWidth(msg)) / 2;
-  int16_t msgY = 105;
-  tft.drawString(msg, msgX, msgY);
-
-  // ⚡ Animate WiFi bars
-  for (int i = 0; i <= 5; i++) {
-    showWiFiSignalBars(i);
-    delay(400);
-  }
+void updateAlert() {
+  if (alertShowing && millis() - alertShownAt > alertDuration) clearAlert();
+}
 
-  WiFi.mode(WIFI_STA);
-  WiFi.begin();
+// 🎨 "Connecting WiFi..." splash
+void drawSplash() {
+  drawCenteredMessage("Connecting WiFi...", TFT_SKYBLUE, TFT_PURPLE, 105);
+  showWiFiSignalBars(0);
+  lastSplashBarTime = millis();
+}
 
-  Serial.println("🌐 Trying saved WiFi credentials...");
-  int retries = 0;
-  while (WiFi.status() != WL_CONNECTED && retries < 20) {  // ~10s
-    delay(500);
-    Serial.print(".");
-    retries++;
-  }
+// 📶 Reflect WiFi progress while nothing better is on screen
+void updateBootScreens() {
+  NetState state = networkState();
 
-  if (WiFi.status() == WL_CONNECTED) {
-    Serial.println("\n✅ Connected to WiFi!");
-    tft.fillScreen(TFT_SKYBLUE);
-    tft.setTextColor(TFT_PURPLE);
-    tft.setFont(&fonts::Font4);
-    String successMsg = "WiFi Connected!";
-    int16_t successX = (240 - tft.textWidth(successMsg)) / 2;
-    tft.drawString(successMsg, successX, 60);
-  } else {
-    Serial.println("\n⚠️ Saved WiFi failed. Starting WiFiManager AP...");
-    tft.fillScreen(TFT_WHITE);
-    tft.setTextColor(TFT_RED);
-    tft.setFont(&fonts::Font2);
-    String failMsg = "WiFi Setup Mode";
-    int16_t failX = (240 - tft.textWidth(failMsg)) / 2;
-    tft.drawString(failMsg, failX, 60);
-
-    WiFiManager wm;
-    wm.setConfigPortalTimeout(300);  // 5 min timeout for safety
-
-    if (!wm.autoConnect("Tempest-Setup")) {
-      Serial.println("❌ WiFiManager failed or timed out. Restarting...");
+  if (state != shownNetState) {
+    shownNetState = state;
+    if (state == NET_PORTAL) {
+      screenCovered();
+      showingWeather = false;  // The user needs to see this one
+      tft.fillScreen(TFT_WHITE);
+      tft.setTextColor(TFT_RED);
+      tft.setFont(&fonts::Font2);
+      const char* failMsg = "WiFi Setup Mode";
+      int16_t failX = (240 - tft.textWidth(failMsg)) / 2;
+      tft.drawString(failMsg, failX, 60);
+    } else if (state == NET_FAILED) {
+      screenCovered();
+      showingWeather = false;
       tft.fillScreen(TFT_BLACK);
       tft.setTextColor(TFT_RED);
       tft.drawString("WiFi Failed!", 10, 60);
-      delay(3000);
-      ESP.restart();
-    } else {
-      Serial.println("✅ Connected via WiFiManager!");
-      tft.fillScreen(TFT_SKYBLUE);
-      tft.setTextColor(TFT_PURPLE);
-      tft.setFont(&fonts::Font4);
-      String successMsg = "WiFi Connected!";
-      int16_t successX = (240 - tft.textWidth(successMsg)) / 2;
-      tft.drawString(successMsg, successX, 60);
+    } else if (state == NET_ONLINE && !showingWeather) {
+      screenCovered();
+      drawCenteredMessage("WiFi Connected!", TFT_SKYBLUE, TFT_PURPLE, 60);
     }
+    return;
   }
 
-  shouldRedraw = true;
-  currentScreen = 0;
-  fetchAndDisplayWeather();
-  lastSwitchTime = millis();
-  shouldRedraw = false;
+  // ⚡ Animate WiFi bars without blocking the loop
+  if (state == NET_CONNECTING && !showingWeather &&
+      millis() - lastSplashBarTime > splashBarInterval) {
+    splashBars = (splashBars + 1) % 6;
+    showWiFiSignalBars(splashBars);
+    lastSplashBarTime = millis();
+  }
 }
 
-void fetchAndDisplayLondonWeather() {
-  String fullUrl = String(OPENWEATHER_LONDON_URL) + OPENWEATHER_API_KEY;
+// 📈 Tempest readings feed the on-device history
+HistorySample sampleFromObs(const WeatherObs& obs) {
+  HistorySample s;
+  s.timestamp = obs.timestamp;
+  s.temp_f = obs.temp_f;
+  s.pressure_mb = obs.pressure_mb;
+  s.humidity = obs.humidity;
+  s.wind_avg = obs.wind_avg;
+  s.wind_gust = obs.wind_gust;
+  s.wind_dir = obs.wind_dir;
+  s.rain_mm = obs.rain_mm;
+  s.uv = obs.uv;
+  return s;
+}
 
-  HTTPClient http;
-  http.begin(fullUrl);
-  int httpCode = http.GET();
+// 📉 Newest sample on the trend strip; repeat polls share a timestamp
+uint32_t trendTs = 0;
+const uint32_t trendSpanSec = 140 * 60;  // One strip column per minute
+
+bool seedTrend(const ObsRecord& rec, void*) {
+  if (rec.timestamp <= trendTs) return true;
+  trendTs = rec.timestamp;
+  addTemperatureTrend(rec.temp_f, false);
+  return true;
+}
 
-  tft.setFont(&fonts::Font4);  // Just for title
+bool feedTrend(const HistorySample& s, void*) {
+  trendTs = s.timestamp;
+  addTemperatureTrend(s.temp_f, false);
+  return true;
+}
 
-  if (httpCode > 0) {
-    String payload = http.getString();
-    Serial.println("🌍 London Weather API Response:");
-    Serial.println(payload);
+// 📊 New observations only; repeat polls are rejected by the history
+void appendSample(const HistorySample& sample) {
+  if (!historyAppend(sample)) return;
+  statsAdd(sample);
+  if (sample.timestamp > trendTs) {
+    trendTs = sample.timestamp;
+    addTemperatureTrend(sample.temp_f, trendVisible());
+  }
+}
 
-    DynamicJsonDocument doc(4096);
-    DeserializationError error = deserializeJson(doc, payload);
-    if (error) {
-      Serial.println("❌ JSON Parse Failed!");
-      tft.fillScreen(TFT_BLACK);
-      tft.drawString("JSON Error!", 10, 20);
-      return;
+// ⏮️ One backfill per boot; live samples wait behind it so history stays in order
+bool backfillHandled = false;
+HistorySample heldSample;
+bool haveHeldSample = false;
+
+void recordTempestSample(const WeatherObs& obs) {
+  HistorySample sample = sampleFromObs(obs);
+  if (!deepSleepMode && backfillState() == BACKFILL_IDLE && historyCount() == 0) {
+    // Rows carry station pressure; without both readings there's no offset to apply
+    float offset = 0;
+    if (!isnan(obs.pressure_mb) && !isnan(obs.station_pressure_mb)) {
+      offset = obs.pressure_mb - obs.station_pressure_mb;
     }
+    requestBackfill(sample.timestamp - 24 * 3600UL, sample.timestamp - 1, offset);
+  }
+  if (backfillState() == BACKFILL_RUNNING) {
+    heldSample = sample;
+    haveHeldSample = true;
+    return;
+  }
+  appendSample(sample);
+}
 
-    float temp_f = doc["main"]["temp"].as<float>();
+void drainBackfill() {
+  BackfillState state = backfillState();
+  if (backfillHandled || state == BACKFILL_IDLE) return;
 
-    tft.fillScreen(TFT_WHITE);
-    tft.setSwapBytes(true);
-    tft.pushImage(0, 0, 240, 240, background2);
+  HistorySample s;
+  while (pollBackfillSample(s)) {
+    if (historyAppend(s)) statsAdd(s);
+  }
+  if (state == BACKFILL_RUNNING) return;
+
+  backfillHandled = true;
+  if (haveHeldSample && historyAppend(heldSample)) statsAdd(heldSample);
+  haveHeldSample = false;
+
+  // 📉 Redraw the trend from the now-complete history
+  HistorySample latest;
+  if (state != BACKFILL_DONE || !historyLatest(latest)) return;
+  clearTemperatureTrend();
+  historyForEach(latest.timestamp - trendSpanSec, feedTrend, nullptr);
+  if (trendVisible()) pushTemperatureTrend();
+}
 
-    tft.setTextColor(TFT_NAVY);
-    tft.setFont(&fonts::Font6);  // Big temp
-    tft.setTextSize(2);
-    String tempText = String(temp_f, 1) + " F";
-    int16_t tempX = (240 - tft.textWidth(tempText)) / 2;
-    int16_t tempY = 120 - (tft.fontHeight() / 2);
-    tempX += 15;
-    tempY += 20;
-    tft.drawString(tempText, tempX, tempY);
-    tft.setTextSize(1);
-    drawScreenTitle("London");
+// 🌤️ Every station keeps its own reading
+void recordStationResult(const WeatherObs& obs) {
+  uint8_t i = obs.station;
+  if (obs.status == FETCH_OK) {
+    stationObs[i] = obs;
+    haveStation[i] = true;
+    stationFresh[i] = true;
+    if (i == 0) {
+      saveLastObs(obs);
+      recordTempestSample(obs);
+    }
+  } else if (obs.status == FETCH_NOT_MODIFIED && haveStation[i]) {
+    stationFresh[i] = true;
+  }
+  if (i == tempestStation) showStation(i);
+}
 
-  } else {
-    Serial.println("❌ Failed to connect to OpenWeather API.");
-    tft.fillScreen(TFT_BLACK);
-    tft.drawString("API Error!", 10, 20);
+void recordFetchResult(const WeatherObs& obs) {
+  if (obs.screen == SCREEN_SAN_DIEGO) {
+    recordStationResult(obs);
+    return;
+  }
+  if (obs.status == FETCH_OK) {
+    if (obs.screen == SCREEN_FORECAST && !latestForecast(forecast)) return;
+    latestObs[obs.screen] = obs;
+    haveObs[obs.screen] = true;
+    obsIsFresh[obs.screen] = true;
+    if (obs.screen < OBS_SCREEN_COUNT) saveLastObs(obs);
+  } else if (obs.status == FETCH_NOT_MODIFIED && haveObs[obs.screen]) {
+    obsIsFresh[obs.screen] = true;  // 🏷️ 304: what we have is current
+  }
+}
+
+void drawFetchResult(const WeatherObs& obs) {
+  if (obs.screen != currentScreen) return;
+  if (obs.screen == SCREEN_SAN_DIEGO && obs.station != tempestStation) return;
+
+  if (obs.status == FETCH_OK || obs.status == FETCH_NOT_MODIFIED) {
+    if (haveObs[obs.screen]) {
+      // ✂️ Same reading already up: the trend strip was the only change
+      if (obs.screen != SCREEN_FORECAST && shownScreen == obs.screen && !shownStale &&
+          shownTemp == latestObs[obs.screen].temp_f) return;
+      drawCurrentScreen();  // 🔄 Update in place
+      return;
+    }
+  } else if (haveObs[obs.screen]) {
+    // 📴 Offline: keep the last logged reading up, flagged as cached
+    obsIsFresh[obs.screen] = false;
+    if (obs.screen == SCREEN_SAN_DIEGO) stationFresh[tempestStation] = false;
+    drawCurrentScreen();
+    return;
   }
 
-  http.end();
+  drawErrorScreen(obs.status == FETCH_JSON_ERROR ? "JSON Error!" : "API Error!");
+  screenCovered();
+  showingWeather = true;
 }
 
-void fetchAndDisplayWeather() {
-  HTTPClient http;
-  http.begin(TEMPEST_API_URL);
-  String bearer = "Bearer " + String(TEMPEST_API_KEY);
-  http.addHeader("Authorization", bearer);
-  int httpCode = http.GET();
+// 🔋 One refresh per wake, then back to sleep
+void deepSleepLoop() {
+  WeatherObs obs;
+  bool done = pollFetchResult(obs);
+  if (done && obs.screen == SCREEN_SAN_DIEGO && obs.station) return;  // Primary only on battery
+  if (!done && !powerAllowPortal() && powerFetchTimedOut()) {  // Cold boots may sit in the portal
+    obs = {};
+    obs.screen = currentScreen;
+    obs.status = FETCH_HTTP_ERROR;
+    done = true;
+  }
 
-  tft.setFont(&fonts::Font4);  // Just for title
+  if (done) {
+    recordFetchResult(obs);
+    bool render = powerShouldRender(obs);
+    if (render) drawFetchResult(obs);
+    powerSleep(obs.status, render);
+  }
 
-  if (httpCode > 0) {
-    String payload = http.getString();
-    Serial.println("📡 Weather API Response:");
-    Serial.println(payload);
+  updateBootScreens();
+  delay(20);
+}
 
-    DynamicJsonDocument doc(4096);
-    DeserializationError error = deserializeJson(doc, payload);
-    if (error) {
-      Serial.println("❌ JSON Parse Failed!");
-      tft.fillScreen(TFT_BLACK);
-      tft.drawString("JSON Error!", 10, 20);
-      return;
-    }
+// 📈 The /metrics values only the firmware can read
+void readMetricsGauges(MetricsGauges& g) {
+  g.uptimeMs = esp_timer_get_time() / 1000;
+  g.wifi = WiFi.status() == WL_CONNECTED;
+  g.rssi = g.wifi ? WiFi.RSSI() : 0;
+
+  RadioTotals radio;
+  radioTotals(radio);
+  g.radio = true;
+  g.radioOnMs = radio.radioOnMs;
+  g.radioWakes = radio.wakes;
+}
 
-    float temp_c = doc["obs"][0]["air_temperature"].as<float>();
-    float temp_f = (temp_c * 9.0 / 5.0) + 32.0;
-
-    tft.fillScreen(TFT_WHITE);
-    tft.setSwapBytes(true);
-    tft.pushImage(0, 0, 240, 240, background2);
-
-    tft.setTextColor(TFT_NAVY);
-    tft.setFont(&fonts::Font6);  // Big temp
-    tft.setTextSize(2);
-    String tempText = String(temp_f, 1) + " F";
-    int16_t tempX = (240 - tft.textWidth(tempText)) / 2;
-    int16_t tempY = 120 - (tft.fontHeight() / 2);
-    tempX += 15;
-    tempY += 20;
-    tft.drawString(tempText, tempX, tempY);
-    tft.setTextSize(1);
-    drawScreenTitle("San Diego");
+//Setup the app
+void setup() {
+  Serial.begin(115200);
+  Serial.println("🌈 Booting up Tempest Display...");
+  perfWatchTask("loop");
 
+  // 🌙 Timer wakes in battery mode find the last frame still on the panel
+  bool panelRetained = deepSleepMode && powerBegin();
+  if (panelRetained) {
+    tft.init_without_reset();
   } else {
-    Serial.println("❌ Failed to connect to API.");
-    tft.fillScreen(TFT_BLACK);
-    tft.drawString("API Error!", 10, 20);
+    tft.init();
   }
+  tft.setRotation(0);  // Adjust as needed for screen orientation
+  screensBegin();
+  windGaugeBegin();
 
-  http.end();
-}
+  // 💾 Warm start: paint the last known readings straight from flash
+  obsStoreBegin();
+  for (uint8_t s = 0; s < OBS_SCREEN_COUNT; s++) {
+    haveObs[s] = loadLastObs(s, latestObs[s]);
+  }
+  stationObs[0] = latestObs[SCREEN_SAN_DIEGO];
+  haveStation[0] = haveObs[SCREEN_SAN_DIEGO];
+  if (haveObs[SCREEN_SAN_DIEGO]) {
+    uint32_t until = latestObs[SCREEN_SAN_DIEGO].timestamp;
+    obsLogRange(until - trendSpanSec, until, SCREEN_SAN_DIEGO, seedTrend, nullptr);
+  }
 
+  currentScreen = deepSleepMode ? powerScreen() : 0;
+  if (panelRetained) {
+    showingWeather = true;
+    reportFirstMeaningfulPixel("retained");
+  } else if (haveObs[currentScreen]) {
+    drawCurrentScreen();
+  } else {
+    drawSplash();
+  }
 
+  // 🌐 WiFi + first fetch happen on the network task
+  startNetworkTask(!deepSleepMode || powerAllowPortal());
+  if (!deepSleepMode) {
+    if (hubEventsEnabled) startEventListener();
+    startMetricsServer(readMetricsGauges);
+  }
+  lastSwitchTime = millis();
+  requestFetch(currentScreen);
+  if (!deepSleepMode) {
+    planNextFetch(lastSwitchTime + screenInterval);
+    // ⚡ Warm every screen at once; the fetches run concurrently
+    for (uint8_t s = 0; s < FETCHED_SCREEN_COUNT; s++) {
+      if (s != currentScreen) requestFetch(s);
+    }
+  }
+  shouldRedraw = false;
+}
 
 void loop() {
+  if (deepSleepMode) {
+    deepSleepLoop();
+    return;
+  }
+
   uint32_t now = millis();
 
-  // ⏱ Auto-switch every 10s
-  if (now - lastSwitchTime > screenInterval) {
-    currentScreen = (currentScreen + 1) % 2;
+  // ⏱ Auto-switch every 30s; an alert holds the current screen
+  if (now - lastSwitchTime > screenInterval && !alertShowing) {
+    currentScreen = (currentScreen + 1) % SCREEN_COUNT;
+    if (currentScreen == SCREEN_WIND && !windIsLive()) currentScreen = 0;  // No hub in range
+    if (currentScreen == SCREEN_SAN_DIEGO) showStation(nextStation());
     shouldRedraw = true;
     lastSwitchTime = now;
   }
 
   if (shouldRedraw) {
-    if (currentScreen == 0) {
-      fetchAndDisplayWeather();  // 🌞 San Diego
-    } else {
-      fetchAndDisplayLondonWeather();  // 🌧️ London
-    }
+    drawCurrentScreen();  // 🌞 Show what we have, refresh behind it
+    planNextFetch(now + screenInterval);
+    requestFetch(currentScreen);
     shouldRedraw = false;
   }
 
-  delay(20);  // 🌿 Chill a bit
+  WeatherObs obs;
+  while (pollFetchResult(obs)) {
+    recordFetchResult(obs);
+    drawFetchResult(obs);
+  }
+
+  drainBackfill();
+  updateBootScreens();
+  updateAlert();
+  obsLogTick();
+  radioStatsTick();
+  perfTick();
+  traceSerialTick();
+
+  // 🌿 Chill a bit, but wake the moment a hub event lands or a needle frame is due
+  uint32_t wait = 20;
+  if (shownScreen == SCREEN_WIND && !alertShowing) wait = min(wait, windGaugeTick());
+  TempestEvent ev;
+  if (pollTempestEvent(ev, wait)) handleTempestEvent(ev);
 }
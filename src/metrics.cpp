@@ -0,0 +1,480 @@
+#include "metrics.h"
+#include "trace.h"
+#include <Arduino.h>
+#include <string.h>
+#include <stdio.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/select.h>
+#include <netinet/in.h>
+
+#ifdef ARDUINO
+#include <WiFi.h>
+#endif
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+enum MetricsSection : uint8_t {
+  SECTION_SCALARS = 0,
+  SECTION_COUNTERS,
+  SECTION_TASKS,
+  SECTION_STAGES_HEADER,
+  SECTION_STAGES,
+  SECTION_DONE
+};
+
+enum Scalar : uint8_t {
+  SCALAR_UPTIME = 0,
+  SCALAR_HEAP_FREE,
+  SCALAR_HEAP_MIN_FREE,
+  SCALAR_HEAP_LARGEST,
+  SCALAR_HEAP_MIN_LARGEST,
+  SCALAR_RSSI,
+  SCALAR_RADIO_ON,
+  SCALAR_RADIO_WAKES,
+  SCALAR_SCRAPES,
+  SCALAR_COUNT
+};
+
+struct Family {
+  const char* name;
+  const char* type;
+  const char* help;
+};
+
+static const Family scalars[SCALAR_COUNT] = {
+  { "tempest_uptime_seconds", "gauge", "Time since boot." },
+  { "tempest_heap_free_bytes", "gauge", "Free heap." },
+  { "tempest_heap_min_free_bytes", "gauge", "Lowest free heap since boot." },
+  { "tempest_heap_largest_free_block_bytes", "gauge", "Largest allocatable block." },
+  { "tempest_heap_min_largest_free_block_bytes", "gauge", "Lowest sampled largest block." },
+  { "tempest_wifi_rssi_dbm", "gauge", "Signal strength of the joined AP." },
+  { "tempest_radio_on_seconds_total", "counter", "Time the WiFi radio has been on." },
+  { "tempest_radio_wakes_total", "counter", "Radio off to on transitions." },
+  { "tempest_metrics_scrapes_total", "counter", "Scrapes of this endpoint." },
+};
+
+// Indexed by PerfCounter; the two byte counters share one family
+static const Family counterFamilies[PERF_COUNTER_COUNT] = {
+  { "tempest_http_requests_total", "counter", "Finished HTTP requests." },
+  { "tempest_http_errors_total", "counter", "Requests that failed in transport or got 4xx/5xx." },
+  { "tempest_http_not_modified_total", "counter", "Conditional requests answered 304 (ETag cache hits)." },
+  { "tempest_http_reused_connections_total", "counter", "Requests sent on a kept-alive connection." },
+  { "tempest_http_bytes_total", "counter", "HTTP request and response bytes." },
+  { "tempest_http_bytes_total", "counter", "" },
+  { "tempest_frames_dropped_total", "counter", "Wind needle frames that missed their deadline." },
+  { "tempest_dns_cache_hits_total", "counter", "Lookups answered from the DNS cache." },
+  { "tempest_dns_cache_misses_total", "counter", "Lookups sent to the resolver." },
+  { "tempest_dns_stale_answers_total", "counter", "Expired DNS entries served while the resolver failed." },
+};
+
+static const Family tasksFamily = {
+  "tempest_task_stack_free_bytes", "gauge", "Stack a task has never touched."
+};
+
+static const Family stagesFamily = {
+  "tempest_stage_seconds", "histogram", "Duration of each refresh pipeline stage."
+};
+
+static int writeFamily(char* out, const Family& f) {
+  return snprintf(out, METRICS_CHUNK_MAX, "# HELP %s %s\n# TYPE %s %s\n", f.name, f.help, f.name, f.type);
+}
+
+// Whole microseconds as seconds, without floats
+static int writeSeconds(char* out, size_t cap, uint64_t us) {
+  return snprintf(out, cap, "%llu.%06llu", (unsigned long long)(us / 1000000),
+                  (unsigned long long)(us % 1000000));
+}
+
+void metricsRenderBegin(MetricsCursor& c, MetricsGaugeFn gauges) {
+  memset(&c, 0, sizeof(c));
+  if (gauges) gauges(c.gauges);
+  perfHeap(c.heap);
+}
+
+// 🔢 One gauge or counter with its header; 0 to skip what this build lacks
+static int writeScalar(MetricsCursor& c, char* out) {
+  const Family& f = scalars[c.index];
+  bool heap = c.index >= SCALAR_HEAP_FREE && c.index <= SCALAR_HEAP_MIN_LARGEST;
+  if (heap && !c.heap.freeBytes) return 0;  // Host build: no heap to report
+  uint64_t value = 0;
+  switch (c.index) {
+    case SCALAR_UPTIME: {
+      int n = writeFamily(out, f);
+      n += snprintf(out + n, METRICS_CHUNK_MAX - n, "%s ", f.name);
+      n += writeSeconds(out + n, METRICS_CHUNK_MAX - n, c.gauges.uptimeMs * 1000);
+      return n + snprintf(out + n, METRICS_CHUNK_MAX - n, "\n");
+    }
+    case SCALAR_HEAP_FREE: value = c.heap.freeBytes; break;
+    case SCALAR_HEAP_MIN_FREE: value = c.heap.minFreeBytes; break;
+    case SCALAR_HEAP_LARGEST: value = c.heap.largestBlock; break;
+    case SCALAR_HEAP_MIN_LARGEST: value = c.heap.minLargestBlock; break;
+    case SCALAR_RSSI: {
+      if (!c.gauges.wifi) return 0;
+      int n = writeFamily(out, f);
+      return n + snprintf(out + n, METRICS_CHUNK_MAX - n, "%s %d\n", f.name, c.gauges.rssi);
+    }
+    case SCALAR_RADIO_ON: {
+      if (!c.gauges.radio) return 0;
+      int n = writeFamily(out, f);
+      n += snprintf(out + n, METRICS_CHUNK_MAX - n, "%s ", f.name);
+      n += writeSeconds(out + n, METRICS_CHUNK_MAX - n, c.gauges.radioOnMs * 1000);
+      return n + snprintf(out + n, METRICS_CHUNK_MAX - n, "\n");
+    }
+    case SCALAR_RADIO_WAKES:
+      if (!c.gauges.radio) return 0;
+      value = c.gauges.radioWakes;
+      break;
+    case SCALAR_SCRAPES: value = c.scrape; break;
+  }
+  int n = writeFamily(out, f);
+  return n + snprintf(out + n, METRICS_CHUNK_MAX - n, "%s %llu\n", f.name, (unsigned long long)value);
+}
+
+static int writeCounter(MetricsCursor& c, char* out) {
+  int n = 0;
+  if (c.index != PERF_COUNT_BYTES_RECEIVED) n = writeFamily(out, counterFamilies[c.index]);
+  const char* label = c.index == PERF_COUNT_BYTES_SENT       ? "{direction=\"sent\"}"
+                      : c.index == PERF_COUNT_BYTES_RECEIVED ? "{direction=\"received\"}"
+                                                             : "";
+  return n + snprintf(out + n, METRICS_CHUNK_MAX - n, "%s%s %llu\n", counterFamilies[c.index].name,
+                      label, (unsigned long long)perfCounter(c.index));
+}
+
+static int writeTask(MetricsCursor& c, char* out) {
+  int n = c.index == 0 ? writeFamily(out, tasksFamily) : 0;
+  return n + snprintf(out + n, METRICS_CHUNK_MAX - n, "%s{task=\"%s\"} %lu\n", tasksFamily.name,
+                      perfTaskName(c.index), (unsigned long)perfTaskStackFree(c.index));
+}
+
+// 📊 One le line per call, then +Inf, _sum and _count together. Empty
+// stages are left out until they record something.
+static int writeStage(MetricsCursor& c, char* out, bool& stageDone) {
+  stageDone = false;
+  const char* stage = perfStageName(c.index);
+  int n = 0;
+  if (c.bucket == 0) {
+    if (!perfHistogram(c.index, c.hist)) {
+      stageDone = true;
+      return 0;
+    }
+    c.cumulative = 0;
+  }
+
+  while (c.bucket < PERF_BUCKETS) {
+    uint32_t top = perfBucketTopUs(c.bucket);
+    c.cumulative += c.hist.buckets[c.bucket++];
+    if (top > METRICS_LE_MAX_US) break;
+    if (top < METRICS_LE_MIN_US || (top & (top + 1))) continue;  // Only 2^k - 1
+
+    n += snprintf(out + n, METRICS_CHUNK_MAX - n, "%s_bucket{stage=\"%s\",le=\"", stagesFamily.name, stage);
+    n += writeSeconds(out + n, METRICS_CHUNK_MAX - n, top);
+    return n + snprintf(out + n, METRICS_CHUNK_MAX - n, "\"} %lu\n", (unsigned long)c.cumulative);
+  }
+
+  n += snprintf(out + n, METRICS_CHUNK_MAX - n, "%s_bucket{stage=\"%s\",le=\"+Inf\"} %lu\n",
+                stagesFamily.name, stage, (unsigned long)c.hist.count);
+  n += snprintf(out + n, METRICS_CHUNK_MAX - n, "%s_sum{stage=\"%s\"} ", stagesFamily.name, stage);
+  n += writeSeconds(out + n, METRICS_CHUNK_MAX - n, c.hist.sumUs);
+  n += snprintf(out + n, METRICS_CHUNK_MAX - n, "\n%s_count{stage=\"%s\"} %lu\n", stagesFamily.name,
+                stage, (unsigned long)c.hist.count);
+  stageDone = true;
+  return n;
+}
+
+// The next piece of the exposition, 0 only when it's finished
+static int writeNext(MetricsCursor& c, char* out) {
+  while (c.section != SECTION_DONE) {
+    int n = 0;
+    bool next = true;
+    switch (c.section) {
+      case SECTION_SCALARS:
+        if (c.index < SCALAR_COUNT) n = writeScalar(c, out);
+        else next = false;
+        break;
+      case SECTION_COUNTERS:
+        if (c.index < PERF_COUNTER_COUNT) n = writeCounter(c, out);
+        else next = false;
+        break;
+      case SECTION_TASKS:
+        if (c.index < perfTaskCount()) n = writeTask(c, out);
+        else next = false;
+        break;
+      case SECTION_STAGES_HEADER:
+        n = writeFamily(out, stagesFamily);
+        next = false;
+        break;
+      case SECTION_STAGES: {
+        if (c.index >= PERF_STAGE_COUNT) {
+          next = false;
+          break;
+        }
+        bool stageDone;
+        n = writeStage(c, out, stageDone);
+        if (!stageDone) return n;
+        c.bucket = 0;
+        break;
+      }
+    }
+
+    if (next) {
+      c.index++;
+    } else {
+      c.section++;
+      c.index = 0;
+    }
+    if (n > 0) return n;
+  }
+  return 0;
+}
+
+size_t metricsRender(MetricsCursor& c, char* buf, size_t cap) {
+  size_t len = 0;
+  while (cap - len >= METRICS_CHUNK_MAX) {
+    int n = writeNext(c, buf + len);
+    if (n <= 0) break;
+    len += n;
+  }
+  return len;
+}
+
+// 🔌 Server
+
+enum ClientState : uint8_t {
+  CLIENT_FREE = 0,
+  CLIENT_REQUEST,   // Reading the request head
+  CLIENT_RESPONSE   // Writing; closes once the cursor runs dry
+};
+
+enum ClientBody : uint8_t {
+  BODY_FIXED = 0,   // Just what's in out[]
+  BODY_METRICS,
+  BODY_TRACE
+};
+
+struct Client {
+  uint8_t state;
+  int fd;
+  char req[192];
+  size_t reqLen;
+  char out[1024];
+  size_t outLen;
+  size_t outSent;
+  uint8_t body;     // ClientBody: where the rest comes from
+  uint32_t startMs;
+  MetricsCursor cursor;
+  TraceCursor trace;
+};
+
+static Client clients[METRICS_CLIENTS];
+static int listenFd = -1;
+static MetricsGaugeFn gaugeFn = nullptr;
+static uint32_t scrapes = 0;
+
+static const char OK_HEAD[] =
+    "HTTP/1.1 200 OK\r\n"
+    "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+    "Connection: close\r\n\r\n";
+static const char TRACE_HEAD[] =
+    "HTTP/1.1 200 OK\r\n"
+    "Content-Type: text/plain; charset=utf-8\r\n"
+    "Connection: close\r\n\r\n";
+static const char NOT_FOUND[] =
+    "HTTP/1.1 404 Not Found\r\n"
+    "Content-Type: text/plain\r\n"
+    "Connection: close\r\n\r\n"
+    "Try /metrics or /trace\n";
+
+static void closeClient(Client& cl) {
+  if (cl.body == BODY_TRACE) traceDumpEnd(cl.trace);  // Recording resumes
+  cl.body = BODY_FIXED;
+  if (cl.fd >= 0) close(cl.fd);
+  cl.fd = -1;
+  cl.state = CLIENT_FREE;
+}
+
+// "GET <path>" with an optional query
+static bool isGet(const char* req, const char* path) {
+  size_t n = strlen(path);
+  return strncmp(req, "GET ", 4) == 0 && strncmp(req + 4, path, n) == 0 &&
+         (req[4 + n] == ' ' || req[4 + n] == '?');
+}
+
+static void startResponse(Client& cl) {
+  cl.state = CLIENT_RESPONSE;
+  cl.outSent = 0;
+  const char* head = NOT_FOUND;
+  size_t headLen = sizeof(NOT_FOUND) - 1;
+  if (isGet(cl.req, "/metrics")) {
+    cl.body = BODY_METRICS;
+    metricsRenderBegin(cl.cursor, gaugeFn);
+    cl.cursor.scrape = ++scrapes;
+    head = OK_HEAD;
+    headLen = sizeof(OK_HEAD) - 1;
+  } else if (isGet(cl.req, "/trace")) {
+    cl.body = BODY_TRACE;
+    traceDumpBegin(cl.trace);
+    head = TRACE_HEAD;
+    headLen = sizeof(TRACE_HEAD) - 1;
+  }
+  memcpy(cl.out, head, headLen);
+  cl.outLen = headLen;
+}
+
+static void readRequest(Client& cl) {
+  int rc = recv(cl.fd, cl.req + cl.reqLen, sizeof(cl.req) - 1 - cl.reqLen, 0);
+  if (rc == 0 || (rc < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+    closeClient(cl);
+    return;
+  }
+  if (rc < 0) return;
+  cl.reqLen += rc;
+  cl.req[cl.reqLen] = '\0';
+
+  // The request line is all we route on; a full buffer means the rest of
+  // the head is just headers we'd ignore
+  if (strstr(cl.req, "\r\n\r\n") || strstr(cl.req, "\n\n") || cl.reqLen == sizeof(cl.req) - 1) {
+    startResponse(cl);
+  }
+}
+
+static void writeResponse(Client& cl) {
+  for (;;) {
+    if (cl.outSent == cl.outLen) {
+      cl.outSent = cl.outLen = 0;
+      if (cl.body == BODY_METRICS) cl.outLen = metricsRender(cl.cursor, cl.out, sizeof(cl.out));
+      if (cl.body == BODY_TRACE) cl.outLen = traceDump(cl.trace, cl.out, sizeof(cl.out));
+      if (!cl.outLen) {
+        closeClient(cl);
+        return;
+      }
+    }
+    int rc = send(cl.fd, cl.out + cl.outSent, cl.outLen - cl.outSent, MSG_NOSIGNAL);
+    if (rc < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return;  // Socket buffer full
+    if (rc <= 0) {
+      closeClient(cl);
+      return;
+    }
+    cl.outSent += rc;
+  }
+}
+
+static void acceptClient() {
+  int fd = accept(listenFd, nullptr, nullptr);
+  if (fd < 0) return;
+  Client* cl = nullptr;
+  for (uint8_t i = 0; i < METRICS_CLIENTS && !cl; i++) {
+    if (clients[i].state == CLIENT_FREE) cl = &clients[i];
+  }
+  if (!cl) {
+    close(fd);  // Busy; the scraper retries next interval
+    return;
+  }
+  fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+  cl->fd = fd;
+  cl->state = CLIENT_REQUEST;
+  cl->reqLen = 0;
+  cl->startMs = millis();
+}
+
+bool metricsServerBegin(uint16_t port, MetricsGaugeFn gauges) {
+  gaugeFn = gauges;
+  if (listenFd >= 0) return true;
+  for (uint8_t i = 0; i < METRICS_CLIENTS; i++) clients[i].fd = -1;
+
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  if (fd < 0) return false;
+  int on = 1;
+  setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+
+  sockaddr_in addr = {};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+  addr.sin_addr.s_addr = htonl(INADDR_ANY);
+  if (bind(fd, (sockaddr*)&addr, sizeof(addr)) < 0 || listen(fd, METRICS_CLIENTS) < 0) {
+    close(fd);
+    return false;
+  }
+  fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+  listenFd = fd;
+  Serial.printf("📈 Serving /metrics on TCP %u\n", port);
+  return true;
+}
+
+void metricsServerPoll(uint32_t waitMs) {
+  if (listenFd < 0) return;
+
+  fd_set rd, wr;
+  FD_ZERO(&rd);
+  FD_ZERO(&wr);
+  FD_SET(listenFd, &rd);
+  int maxFd = listenFd;
+  for (uint8_t i = 0; i < METRICS_CLIENTS; i++) {
+    Client& cl = clients[i];
+    if (cl.state == CLIENT_FREE) continue;
+    FD_SET(cl.fd, cl.state == CLIENT_REQUEST ? &rd : &wr);
+    if (cl.fd > maxFd) maxFd = cl.fd;
+  }
+
+  timeval tv = { (long)(waitMs / 1000), (long)((waitMs % 1000) * 1000) };
+  if (select(maxFd + 1, &rd, &wr, nullptr, &tv) < 0) return;
+
+  uint32_t now = millis();
+  for (uint8_t i = 0; i < METRICS_CLIENTS; i++) {
+    Client& cl = clients[i];
+    if (cl.state == CLIENT_REQUEST && FD_ISSET(cl.fd, &rd)) readRequest(cl);
+    else if (cl.state == CLIENT_RESPONSE && FD_ISSET(cl.fd, &wr)) writeResponse(cl);
+
+    // ⏳ A scraper that stops reading gives its slot back
+    if (cl.state != CLIENT_FREE && now - cl.startMs > METRICS_CLIENT_TIMEOUT_MS) closeClient(cl);
+  }
+  if (FD_ISSET(listenFd, &rd)) acceptClient();
+}
+
+bool metricsServerRunning() {
+  return listenFd >= 0;
+}
+
+uint32_t metricsServerScrapes() {
+  return scrapes;
+}
+
+void metricsServerEnd() {
+  if (listenFd < 0) return;
+  for (uint8_t i = 0; i < METRICS_CLIENTS; i++) {
+    if (clients[i].state != CLIENT_FREE) closeClient(clients[i]);
+  }
+  close(listenFd);
+  listenFd = -1;
+}
+
+#ifdef ARDUINO
+
+static void metricsTask(void* arg) {
+  MetricsGaugeFn gauges = (MetricsGaugeFn)arg;
+  perfWatchTask("metrics");
+
+  for (;;) {
+    if (WiFi.status() != WL_CONNECTED) {
+      metricsServerEnd();
+      vTaskDelay(pdMS_TO_TICKS(1000));
+      continue;
+    }
+    if (!metricsServerBegin(METRICS_PORT, gauges)) {
+      vTaskDelay(pdMS_TO_TICKS(1000));
+      continue;
+    }
+    metricsServerPoll(1000);  // Wake up to notice WiFi going away
+  }
+}
+
+void startMetricsServer(MetricsGaugeFn gauges) {
+  // Idle priority: a scrape only ever runs when rendering and fetching don't
+  xTaskCreate(metricsTask, "metrics", 3072, (void*)gauges, tskIDLE_PRIORITY, nullptr);
+}
+
+#endif
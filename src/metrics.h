@@ -0,0 +1,67 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include "perf.h"
+
+// 📈 GET /metrics in the Prometheus text format
+//
+// Refresh stage histograms, HTTP outcome and byte counters, frame times,
+// heap and stack watermarks, uptime, radio on-time and RSSI. The body is
+// never built whole: a cursor writes it a few lines at a time into each
+// client's fixed buffer, refilled only as the socket drains, so a scrape
+// costs no allocation and a slow scraper only ever holds its own slot.
+// The server is a select() loop over non-blocking sockets (lwIP on the
+// device, so it also builds and runs on Linux). GET /trace streams the
+// trace ring (trace.h) the same way.
+
+const uint16_t METRICS_PORT = 9100;
+const uint8_t METRICS_CLIENTS = 2;
+const uint32_t METRICS_CLIENT_TIMEOUT_MS = 5000;
+const size_t METRICS_CHUNK_MAX = 256;   // Longest piece the cursor writes at once
+
+// Exported le bounds: powers of two from 128 us to 33.5 s, then +Inf
+const uint32_t METRICS_LE_MIN_US = 127;
+const uint32_t METRICS_LE_MAX_US = 33554431;
+
+// What only the firmware knows; fields it can't fill stay false/0
+struct MetricsGauges {
+  uint64_t uptimeMs;
+  bool wifi;             // Associated, rssi valid
+  int8_t rssi;
+  bool radio;            // radioOnMs/radioWakes valid
+  uint64_t radioOnMs;
+  uint32_t radioWakes;
+};
+
+typedef void (*MetricsGaugeFn)(MetricsGauges& out);
+
+struct MetricsCursor {
+  uint8_t section;
+  uint8_t index;             // Metric, counter, task or stage within the section
+  uint8_t bucket;            // Next histogram bucket of the stage
+  uint32_t cumulative;       // Samples in the buckets written so far
+  PerfHistogram hist;        // The stage being written, copied once
+  PerfHeap heap;
+  MetricsGauges gauges;      // Read when the scrape began
+  uint32_t scrape;
+};
+
+// The whole exposition is a snapshot from this call on, histograms aside
+// (each is copied when the cursor reaches it)
+void metricsRenderBegin(MetricsCursor& c, MetricsGaugeFn gauges);
+
+// Whole lines only, cap >= METRICS_CHUNK_MAX; 0 once everything is out
+size_t metricsRender(MetricsCursor& c, char* buf, size_t cap);
+
+// false if the port can't be bound
+bool metricsServerBegin(uint16_t port, MetricsGaugeFn gauges);
+
+// Wait up to waitMs for activity, then accept, read and write what's ready
+void metricsServerPoll(uint32_t waitMs);
+
+bool metricsServerRunning();
+uint32_t metricsServerScrapes();
+void metricsServerEnd();
+
+// 📡 Serves METRICS_PORT from its own task whenever WiFi is up
+void startMetricsServer(MetricsGaugeFn gauges);
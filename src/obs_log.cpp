@@ -0,0 +1,334 @@
+#include "obs_log.h"
+#include <LittleFS.h>
+
+#define OBS_LOG_DIR "/obslog"
+
+struct SegHeader {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t recSize;
+  uint32_t seq;
+  uint32_t reserved;
+};
+
+static_assert(sizeof(ObsRecord) == 12, "ObsRecord is an on-flash format");
+
+static const uint32_t SEG_MAGIC = 0x4C534254;  // "TBSL"
+static const uint16_t SEG_VERSION = 1;
+static const size_t SEG_BYTES = 4096;          // One flash sector
+static const size_t RECS_PER_SEG = (SEG_BYTES - sizeof(SegHeader)) / sizeof(ObsRecord);
+static const uint8_t MAX_SEGMENTS = OBS_LOG_MAX_SEGMENTS;
+static const uint8_t BATCH_RECORDS = OBS_LOG_BATCH_RECORDS;
+static const uint32_t BATCH_MAX_AGE_MS = 10UL * 60UL * 1000UL;
+static const uint32_t RTC_MAGIC = 0x52424254;  // "TBBR"; bump when ObsLogRtc changes
+static const size_t SCAN_CHUNK = 32;           // Records per read()
+
+static SegIndex segs[MAX_SEGMENTS];  // Oldest first
+static uint8_t segCount = 0;
+static ObsRecord batch[BATCH_RECORDS];
+static uint8_t batchLen = 0;
+static unsigned long batchStart = 0;
+static bool logReady = false;
+static bool resumed = false;   // Index came from RTC memory: skip the scan
+
+static uint16_t crc16(const uint8_t* data, size_t len) {
+  uint16_t crc = 0xFFFF;
+  while (len--) {
+    crc ^= (uint16_t)(*data++) << 8;
+    for (int i = 0; i < 8; i++) {
+      crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : (crc << 1);
+    }
+  }
+  return crc;
+}
+
+static uint16_t recordCrc(const ObsRecord& rec) {
+  return crc16((const uint8_t*)&rec, offsetof(ObsRecord, crc));
+}
+
+static void segPath(uint32_t seq, char* path) {
+  snprintf(path, 32, OBS_LOG_DIR "/%08lx.seg", (unsigned long)seq);
+}
+
+static void indexRecord(SegIndex& seg, const ObsRecord& rec) {
+  if (seg.count == 0 || rec.timestamp < seg.minTs) seg.minTs = rec.timestamp;
+  if (seg.count == 0 || rec.timestamp > seg.maxTs) seg.maxTs = rec.timestamp;
+  seg.count++;
+}
+
+// 🩺 Validate a segment and count its good records
+static bool scanSegment(File& f, SegIndex& seg) {
+  SegHeader hdr;
+  if (f.read((uint8_t*)&hdr, sizeof(hdr)) != sizeof(hdr)) return false;
+  if (hdr.magic != SEG_MAGIC || hdr.version != SEG_VERSION ||
+      hdr.recSize != sizeof(ObsRecord)) return false;
+
+  seg = {};
+  seg.seq = hdr.seq;
+
+  size_t stored = (f.size() - sizeof(hdr)) / sizeof(ObsRecord);
+  bool partial = (f.size() - sizeof(hdr)) % sizeof(ObsRecord) != 0;
+  bool torn = false;
+
+  ObsRecord chunk[SCAN_CHUNK];
+  while (seg.count < stored) {
+    size_t want = min(SCAN_CHUNK, stored - seg.count);
+    size_t got = f.read((uint8_t*)chunk, want * sizeof(ObsRecord)) / sizeof(ObsRecord);
+    for (size_t i = 0; i < got; i++) {
+      if (recordCrc(chunk[i]) != chunk[i].crc) {
+        torn = true;
+        break;
+      }
+      indexRecord(seg, chunk[i]);
+    }
+    if (torn || got < want) break;
+  }
+
+  seg.sealed = partial || torn || seg.count < stored || seg.count >= RECS_PER_SEG;
+  return true;
+}
+
+static void insertIndex(const SegIndex& seg) {
+  uint8_t pos = segCount;
+  while (pos > 0 && segs[pos - 1].seq > seg.seq) {
+    segs[pos] = segs[pos - 1];
+    pos--;
+  }
+  segs[pos] = seg;
+  segCount++;
+}
+
+static void dropOldestSegment() {
+  char path[32];
+  segPath(segs[0].seq, path);
+  LittleFS.remove(path);
+  memmove(&segs[0], &segs[1], (segCount - 1) * sizeof(SegIndex));
+  segCount--;
+}
+
+static bool openNewSegment() {
+  if (segCount == MAX_SEGMENTS) dropOldestSegment();
+
+  SegIndex seg = {};
+  seg.seq = segCount ? segs[segCount - 1].seq + 1 : 1;
+
+  char path[32];
+  segPath(seg.seq, path);
+  File f = LittleFS.open(path, FILE_WRITE);
+  if (!f) return false;
+
+  SegHeader hdr = { SEG_MAGIC, SEG_VERSION, sizeof(ObsRecord), seg.seq, 0 };
+  bool ok = f.write((const uint8_t*)&hdr, sizeof(hdr)) == sizeof(hdr);
+  f.close();
+  if (!ok) {
+    LittleFS.remove(path);
+    return false;
+  }
+
+  segs[segCount++] = seg;
+  return true;
+}
+
+bool obsLogBegin() {
+  if (!LittleFS.begin(true)) {
+    Serial.println("❌ LittleFS mount failed, observation log disabled.");
+    logReady = false;
+    return false;
+  }
+  if (!LittleFS.exists(OBS_LOG_DIR)) LittleFS.mkdir(OBS_LOG_DIR);
+
+  if (resumed) {
+    resumed = false;
+    char path[32];
+    if (segCount > 0) segPath(segs[segCount - 1].seq, path);
+    if (segCount == 0 || LittleFS.exists(path)) {
+      Serial.printf("📜 Observation log resumed: %u segments, %u pending\n", segCount, batchLen);
+      logReady = true;
+      return true;
+    }
+    Serial.println("🧹 Saved log index doesn't match flash, rescanning.");
+  }
+
+  segCount = 0;
+  File dir = LittleFS.open(OBS_LOG_DIR);
+  File f;
+  while ((f = dir.openNextFile())) {
+    SegIndex seg;
+    bool ok = scanSegment(f, seg);
+    char path[64];
+    snprintf(path, sizeof(path), "%s", f.path());
+    f.close();
+
+    if (!ok) {
+      Serial.printf("🧹 Dropping unreadable log segment %s\n", path);
+      LittleFS.remove(path);
+      continue;
+    }
+    if (segCount == MAX_SEGMENTS) dropOldestSegment();
+    insertIndex(seg);
+  }
+
+  uint32_t records = 0;
+  for (uint8_t i = 0; i < segCount; i++) records += segs[i].count;
+  Serial.printf("📜 Observation log: %u segments, %lu records\n", segCount, (unsigned long)records);
+
+  logReady = true;
+  return true;
+}
+
+void obsLogAppend(const WeatherObs& obs) {
+  if (!logReady || obs.status != FETCH_OK) return;
+
+  if (batchLen == BATCH_RECORDS) {
+    // 🧯 The last flush couldn't write: keep the newest readings
+    memmove(&batch[0], &batch[1], (BATCH_RECORDS - 1) * sizeof(ObsRecord));
+    batchLen--;
+  }
+
+  ObsRecord& rec = batch[batchLen];
+  rec = {};
+  rec.timestamp = obs.timestamp;
+  rec.temp_f = obs.temp_f;
+  rec.screen = obs.screen;
+  rec.crc = recordCrc(rec);
+
+  if (batchLen++ == 0) batchStart = millis();
+  if (batchLen == BATCH_RECORDS) obsLogFlush();
+}
+
+void obsLogFlush() {
+  if (!logReady || batchLen == 0) return;
+
+  uint8_t written = 0;
+  while (written < batchLen) {
+    if (segCount == 0 || segs[segCount - 1].sealed) {
+      if (!openNewSegment()) break;
+    }
+
+    SegIndex& seg = segs[segCount - 1];
+    size_t n = min((size_t)(batchLen - written), RECS_PER_SEG - seg.count);
+
+    char path[32];
+    segPath(seg.seq, path);
+    File f = LittleFS.open(path, FILE_APPEND);
+    size_t bytes = f ? f.write((const uint8_t*)&batch[written], n * sizeof(ObsRecord)) : 0;
+    f.close();
+
+    for (size_t i = 0; i < bytes / sizeof(ObsRecord); i++) {
+      indexRecord(seg, batch[written + i]);
+    }
+    if (bytes != n * sizeof(ObsRecord)) {
+      // ⚠️ Short write: seal it so the damaged tail is never appended to
+      Serial.println("⚠️ Observation log write failed, sealing segment.");
+      seg.sealed = true;
+      break;
+    }
+    if (seg.count >= RECS_PER_SEG) seg.sealed = true;
+    written += n;
+  }
+
+  if (written < batchLen) {
+    memmove(&batch[0], &batch[written], (batchLen - written) * sizeof(ObsRecord));
+  }
+  batchLen -= written;
+  batchStart = millis();
+}
+
+void obsLogTick() {
+  if (batchLen > 0 && millis() - batchStart > BATCH_MAX_AGE_MS) obsLogFlush();
+}
+
+void obsLogSuspend(ObsLogRtc& out) {
+  // millis() restarts every wake, so age the batch by its readings
+  if (batchLen > 0 && batch[batchLen - 1].timestamp >= batch[0].timestamp + BATCH_MAX_AGE_MS / 1000) {
+    obsLogFlush();
+  }
+  out.magic = logReady ? RTC_MAGIC : 0;
+  out.segCount = segCount;
+  out.batchLen = batchLen;
+  memcpy(out.segs, segs, sizeof(segs));
+  memcpy(out.batch, batch, sizeof(batch));
+}
+
+void obsLogResume(const ObsLogRtc& saved) {
+  resumed = saved.magic == RTC_MAGIC && saved.segCount <= MAX_SEGMENTS && saved.batchLen <= BATCH_RECORDS;
+  segCount = resumed ? saved.segCount : 0;
+  batchLen = resumed ? saved.batchLen : 0;
+  if (!resumed) return;
+  memcpy(segs, saved.segs, sizeof(segs));
+  memcpy(batch, saved.batch, sizeof(batch));
+  batchStart = millis();
+}
+
+static bool inRange(const ObsRecord& rec, uint32_t from, uint32_t to, int screen) {
+  return rec.timestamp >= from && rec.timestamp <= to && (screen < 0 || rec.screen == screen);
+}
+
+size_t obsLogRange(uint32_t from, uint32_t to, int screen, ObsVisitor visit, void* ctx) {
+  size_t visited = 0;
+  ObsRecord chunk[SCAN_CHUNK];
+
+  for (uint8_t s = 0; s < segCount; s++) {
+    const SegIndex& seg = segs[s];
+    if (seg.count == 0 || seg.maxTs < from || seg.minTs > to) continue;  // 🗂️ Index skip
+
+    char path[32];
+    segPath(seg.seq, path);
+    File f = LittleFS.open(path, FILE_READ);
+    if (!f || !f.seek(sizeof(SegHeader))) continue;
+
+    size_t left = seg.count;
+    while (left > 0) {
+      size_t want = min(SCAN_CHUNK, left);
+      size_t got = f.read((uint8_t*)chunk, want * sizeof(ObsRecord)) / sizeof(ObsRecord);
+      for (size_t i = 0; i < got; i++) {
+        if (!inRange(chunk[i], from, to, screen)) continue;
+        visited++;
+        if (!visit(chunk[i], ctx)) return visited;
+      }
+      if (got < want) break;
+      left -= got;
+    }
+  }
+
+  for (uint8_t i = 0; i < batchLen; i++) {
+    if (!inRange(batch[i], from, to, screen)) continue;
+    visited++;
+    if (!visit(batch[i], ctx)) break;
+  }
+  return visited;
+}
+
+bool obsLogLatest(uint8_t screen, ObsRecord& out) {
+  for (int i = batchLen - 1; i >= 0; i--) {
+    if (batch[i].screen == screen) {
+      out = batch[i];
+      return true;
+    }
+  }
+
+  ObsRecord chunk[SCAN_CHUNK];
+  for (int s = segCount - 1; s >= 0; s--) {
+    char path[32];
+    segPath(segs[s].seq, path);
+    File f = LittleFS.open(path, FILE_READ);
+    if (!f || !f.seek(sizeof(SegHeader))) continue;
+
+    bool found = false;
+    size_t left = segs[s].count;
+    while (left > 0) {
+      size_t want = min(SCAN_CHUNK, left);
+      size_t got = f.read((uint8_t*)chunk, want * sizeof(ObsRecord)) / sizeof(ObsRecord);
+      for (size_t i = 0; i < got; i++) {
+        if (chunk[i].screen == screen) {
+          out = chunk[i];
+          found = true;
+        }
+      }
+      if (got < want) break;
+      left -= got;
+    }
+    if (found) return true;
+  }
+  return false;
+}
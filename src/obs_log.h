@@ -0,0 +1,62 @@
+#pragma once
+#include "api.h"
+
+// 📜 Append-only observation log on LittleFS
+//
+// Readings are batched in RAM and appended as fixed-size CRC'd records to
+// numbered segment files. A RAM index keeps each segment's timestamp span so
+// range reads only open the segments they need. Full or damaged segments are
+// sealed and never written again; the oldest segment is dropped when the log
+// is full, spreading erases over the whole partition.
+
+struct ObsRecord {
+  uint32_t timestamp;  // Provider epoch seconds
+  float temp_f;
+  uint8_t screen;
+  uint8_t reserved;
+  uint16_t crc;        // CRC-16/CCITT over the bytes above
+};
+
+// 🗂️ RAM index entry, one per segment file
+struct SegIndex {
+  uint32_t seq;
+  uint32_t minTs;
+  uint32_t maxTs;
+  uint16_t count;   // Valid records
+  bool sealed;      // Full or damaged tail: never append again
+};
+
+const uint8_t OBS_LOG_MAX_SEGMENTS = 32;
+const uint8_t OBS_LOG_BATCH_RECORDS = 16;
+
+// 🧠 The pending batch and the index, kept in RTC memory across deep sleep
+// so a wake neither writes a sector for one reading nor rescans every
+// segment. A battery pull loses what was still pending (at most one batch).
+struct ObsLogRtc {
+  uint32_t magic;   // Anything else (cold boot, older layout): rescan
+  uint8_t segCount;
+  uint8_t batchLen;
+  SegIndex segs[OBS_LOG_MAX_SEGMENTS];
+  ObsRecord batch[OBS_LOG_BATCH_RECORDS];
+};
+
+// Return false to stop the scan early
+typedef bool (*ObsVisitor)(const ObsRecord& rec, void* ctx);
+
+bool obsLogBegin();                      // Mount + recover; safe after power loss
+
+// Ignored until obsLogBegin() succeeds. When flash refuses the batch, the
+// oldest pending reading makes room for the new one.
+void obsLogAppend(const WeatherObs& obs);
+void obsLogFlush();                      // Force the pending batch to flash
+void obsLogTick();                       // Flush once the batch is old enough
+
+// Before deep sleep: flush only a full or old batch, then save the rest.
+// After a timer wake, before obsLogBegin(): adopt the saved state.
+void obsLogSuspend(ObsLogRtc& out);
+void obsLogResume(const ObsLogRtc& saved);
+
+// Visit records with from <= timestamp <= to, oldest first.
+// screen < 0 matches every screen. Returns the number of records visited.
+size_t obsLogRange(uint32_t from, uint32_t to, int screen, ObsVisitor visit, void* ctx);
+bool obsLogLatest(uint8_t screen, ObsRecord& out);
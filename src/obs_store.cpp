@@ -0,0 +1,25 @@
+#include "obs_store.h"
+#include "obs_log.h"
+
+static bool storeReady = false;  // No LittleFS: nothing to load, nothing saved
+
+void obsStoreBegin() {
+  storeReady = obsLogBegin();
+}
+
+bool loadLastObs(uint8_t screen, WeatherObs& out) {
+  ObsRecord rec;
+  if (!storeReady || !obsLogLatest(screen, rec)) return false;
+
+  out = {};
+  out.screen = screen;
+  out.status = FETCH_OK;
+  out.temp_f = rec.temp_f;
+  out.timestamp = rec.timestamp;
+  return true;
+}
+
+// Batched: at most one batch of readings is lost on power cut
+void saveLastObs(const WeatherObs& obs) {
+  if (storeReady) obsLogAppend(obs);
+}
@@ -0,0 +1,7 @@
+#pragma once
+#include "api.h"
+
+// 💾 Last known reading per screen, backed by the observation log
+void obsStoreBegin();
+bool loadLastObs(uint8_t screen, WeatherObs& out);
+void saveLastObs(const WeatherObs& obs);
@@ -0,0 +1,275 @@
+#include "perf.h"
+#include <Arduino.h>
+#include <string.h>
+#include "async_http.h"
+#include "dns_cache.h"
+
+#ifdef ARDUINO
+#include <esp_heap_caps.h>
+#include <esp_system.h>
+static portMUX_TYPE perfMux = portMUX_INITIALIZER_UNLOCKED;
+#define PERF_LOCK() portENTER_CRITICAL(&perfMux)
+#define PERF_UNLOCK() portEXIT_CRITICAL(&perfMux)
+#else
+#define PERF_LOCK()
+#define PERF_UNLOCK()
+#endif
+
+static const uint32_t HEAP_SAMPLE_MS = 1000;
+static const uint32_t REPORT_MS = 3600000UL;
+
+static PerfHistogram histograms[PERF_STAGE_COUNT];
+static uint64_t counters[PERF_COUNTER_COUNT];
+
+static const char* const stageNames[PERF_STAGE_COUNT] = {
+  "dns", "connect", "tls", "tls_resumed", "wait", "transfer", "fetch", "parse", "forecast",
+  "render", "push_image", "frame"
+};
+
+static const char* const counterNames[PERF_COUNTER_COUNT] = {
+  "requests", "errors", "not_modified", "reused", "bytes_sent", "bytes_received",
+  "frames_dropped", "dns_hits", "dns_misses", "dns_stale"
+};
+
+// 0-3 exact, then [4..7] << (e - 2) in four steps for the e-th power of two
+static uint8_t bucketOf(uint32_t us) {
+  if (us < 4) return us;
+  uint8_t e = 31 - __builtin_clz(us);
+  return 4 + (e - 2) * 4 + ((us >> (e - 2)) & 3);
+}
+
+static uint32_t bucketTop(uint8_t b) {
+  if (b < 4) return b;
+  uint8_t e = (b - 4) / 4 + 2;
+  uint64_t top = ((uint64_t)(4 + (b - 4) % 4 + 1) << (e - 2)) - 1;
+  return top > 0xFFFFFFFFu ? 0xFFFFFFFFu : (uint32_t)top;
+}
+
+void perfRecord(uint8_t stage, uint32_t us) {
+  if (stage >= PERF_STAGE_COUNT) return;
+  PerfHistogram& h = histograms[stage];
+  PERF_LOCK();
+  h.buckets[bucketOf(us)]++;
+  if (!h.count || us < h.minUs) h.minUs = us;
+  if (us > h.maxUs) h.maxUs = us;
+  h.count++;
+  h.sumUs += us;
+  PERF_UNLOCK();
+}
+
+void perfCount(uint8_t counter, uint32_t n) {
+  if (counter >= PERF_COUNTER_COUNT) return;
+  PERF_LOCK();
+  counters[counter] += n;
+  PERF_UNLOCK();
+}
+
+void perfRecordHttp(const AsyncHttpResponse& res) {
+  bool transportOk = res.error == ASYNC_HTTP_OK || res.error == ASYNC_HTTP_ERR_ABORTED;
+  perfCount(PERF_COUNT_REQUESTS);
+  if (!transportOk || res.status >= 400) perfCount(PERF_COUNT_ERRORS);
+  if (res.status == 304) perfCount(PERF_COUNT_NOT_MODIFIED);
+  if (res.reused) perfCount(PERF_COUNT_REUSED);
+  perfCount(PERF_COUNT_BYTES_SENT, res.bytesSent);
+  perfCount(PERF_COUNT_BYTES_RECEIVED, res.bytesReceived);
+  if (res.dnsSource == DNS_CACHED) perfCount(PERF_COUNT_DNS_HITS);
+  if (res.dnsSource == DNS_RESOLVED || res.dnsSource == DNS_STALE) perfCount(PERF_COUNT_DNS_MISSES);
+  if (res.dnsSource == DNS_STALE) perfCount(PERF_COUNT_DNS_STALE);
+
+  if (res.status == 0) return;  // Never got an answer: the stage times are partial
+  if (!res.reused) {
+    perfRecord(PERF_DNS, res.dnsUs);
+    if (res.tlsUs) {
+      perfRecord(res.tlsResumed ? PERF_TLS_RESUMED : PERF_TLS, res.tlsUs);
+      perfSampleHeap();  // Record buffers are all still held
+    } else {
+      perfRecord(PERF_CONNECT, res.connectUs);
+    }
+  }
+  perfRecord(PERF_WAIT, res.waitUs);
+  perfRecord(PERF_TRANSFER, res.transferUs);
+  perfRecord(PERF_FETCH, res.elapsedMs * 1000);
+}
+
+static uint32_t percentileOf(const PerfHistogram& h, float pct) {
+  if (!h.count) return 0;
+  uint32_t rank = (uint32_t)(pct / 100.0f * (h.count - 1)) + 1;
+  uint32_t seen = 0;
+  for (uint8_t b = 0; b < PERF_BUCKETS; b++) {
+    seen += h.buckets[b];
+    if (seen >= rank) {
+      uint32_t top = bucketTop(b);
+      return top > h.maxUs ? h.maxUs : top < h.minUs ? h.minUs : top;
+    }
+  }
+  return h.maxUs;
+}
+
+// The histogram is ~0.5 KB: copy it out rather than hold the lock while walking
+static bool snapshot(uint8_t stage, PerfHistogram& out) {
+  if (stage >= PERF_STAGE_COUNT) {
+    out = {};
+    return false;
+  }
+  PERF_LOCK();
+  out = histograms[stage];
+  PERF_UNLOCK();
+  return out.count > 0;
+}
+
+bool perfSummary(uint8_t stage, PerfSummary& out) {
+  out = {};
+  PerfHistogram h;
+  if (!snapshot(stage, h)) return false;
+  out.count = h.count;
+  out.minUs = h.minUs;
+  out.maxUs = h.maxUs;
+  out.meanUs = (uint32_t)(h.sumUs / h.count);
+  out.p50Us = percentileOf(h, 50);
+  out.p90Us = percentileOf(h, 90);
+  out.p99Us = percentileOf(h, 99);
+  return true;
+}
+
+uint32_t perfPercentile(uint8_t stage, float pct) {
+  PerfHistogram h;
+  if (!snapshot(stage, h)) return 0;
+  return percentileOf(h, pct < 0 ? 0 : pct > 100 ? 100 : pct);
+}
+
+bool perfHistogram(uint8_t stage, PerfHistogram& out) {
+  return snapshot(stage, out);
+}
+
+uint32_t perfBucketTopUs(uint8_t bucket) {
+  return bucketTop(bucket < PERF_BUCKETS ? bucket : PERF_BUCKETS - 1);
+}
+
+uint64_t perfCounter(uint8_t counter) {
+  if (counter >= PERF_COUNTER_COUNT) return 0;
+  PERF_LOCK();
+  uint64_t n = counters[counter];
+  PERF_UNLOCK();
+  return n;
+}
+
+const char* perfStageName(uint8_t stage) {
+  return stage < PERF_STAGE_COUNT ? stageNames[stage] : "";
+}
+
+const char* perfCounterName(uint8_t counter) {
+  return counter < PERF_COUNTER_COUNT ? counterNames[counter] : "";
+}
+
+void perfReset() {
+  PERF_LOCK();
+  memset(histograms, 0, sizeof(histograms));
+  memset(counters, 0, sizeof(counters));
+  PERF_UNLOCK();
+}
+
+// 🧠 Heap
+
+#ifdef ARDUINO
+static uint32_t minLargest = 0xFFFFFFFFu;
+#endif
+
+void perfSampleHeap() {
+#ifdef ARDUINO
+  uint32_t largest = heap_caps_get_largest_free_block(MALLOC_CAP_8BIT);
+  PERF_LOCK();
+  if (largest < minLargest) minLargest = largest;
+  PERF_UNLOCK();
+#endif
+}
+
+void perfHeap(PerfHeap& out) {
+  out = {};
+#ifdef ARDUINO
+  out.freeBytes = esp_get_free_heap_size();
+  out.minFreeBytes = esp_get_minimum_free_heap_size();
+  out.largestBlock = heap_caps_get_largest_free_block(MALLOC_CAP_8BIT);
+  PERF_LOCK();
+  if (out.largestBlock < minLargest) minLargest = out.largestBlock;
+  out.minLargestBlock = minLargest;
+  PERF_UNLOCK();
+#endif
+}
+
+// 🧵 Stacks
+
+struct WatchedTask {
+  const char* name;
+#ifdef ARDUINO
+  TaskHandle_t handle;
+#endif
+};
+
+static WatchedTask tasks[PERF_TASKS_MAX];
+static uint8_t taskCount = 0;
+
+void perfWatchTask(const char* name) {
+  PERF_LOCK();
+  if (taskCount < PERF_TASKS_MAX) {
+    tasks[taskCount].name = name;
+#ifdef ARDUINO
+    tasks[taskCount].handle = xTaskGetCurrentTaskHandle();
+#endif
+    taskCount++;
+  }
+  PERF_UNLOCK();
+}
+
+uint8_t perfTaskCount() {
+  return taskCount;
+}
+
+const char* perfTaskName(uint8_t i) {
+  return i < taskCount ? tasks[i].name : "";
+}
+
+uint32_t perfTaskStackFree(uint8_t i) {
+#ifdef ARDUINO
+  if (i < taskCount) return uxTaskGetStackHighWaterMark(tasks[i].handle);  // Bytes on ESP-IDF
+#endif
+  (void)i;
+  return 0;
+}
+
+// 📋 The hourly report
+
+static uint32_t lastHeapSampleMs = 0;
+static uint32_t lastReportMs = 0;
+
+static void logReport() {
+  Serial.println("⏱️ Stage          n      p50      p90      p99      max (us)");
+  for (uint8_t s = 0; s < PERF_STAGE_COUNT; s++) {
+    PerfSummary p;
+    if (!perfSummary(s, p)) continue;
+    Serial.printf("   %-10s %6lu %8lu %8lu %8lu %8lu\n", stageNames[s], (unsigned long)p.count,
+                  (unsigned long)p.p50Us, (unsigned long)p.p90Us, (unsigned long)p.p99Us,
+                  (unsigned long)p.maxUs);
+  }
+
+  PerfHeap heap;
+  perfHeap(heap);
+  Serial.printf("🧠 Heap: %lu free (min %lu), largest block %lu (min %lu)\n",
+                (unsigned long)heap.freeBytes, (unsigned long)heap.minFreeBytes,
+                (unsigned long)heap.largestBlock, (unsigned long)heap.minLargestBlock);
+  for (uint8_t i = 0; i < taskCount; i++) {
+    Serial.printf("🧵 %s: %lu bytes of stack never used\n", tasks[i].name,
+                  (unsigned long)perfTaskStackFree(i));
+  }
+}
+
+void perfTick() {
+  uint32_t now = millis();
+  if (now - lastHeapSampleMs >= HEAP_SAMPLE_MS) {
+    lastHeapSampleMs = now;
+    perfSampleHeap();
+  }
+  if (now - lastReportMs >= REPORT_MS) {
+    lastReportMs = now;
+    logReport();
+  }
+}
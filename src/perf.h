@@ -0,0 +1,110 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+struct AsyncHttpResponse;
+
+// ⏱️ Per-stage latency histograms + heap and stack watermarks
+//
+// Every stage of fetch → parse → render records its duration into a fixed
+// log-linear histogram: exact below 4 us, then four buckets per power of
+// two, so a percentile is the top of a bucket no wider than a quarter of
+// its value. Recording is O(1) with no allocation, safe from any task;
+// queries copy the histogram under the same lock and walk it. The heap
+// low-water marks come from sampling (each second and right after TLS
+// handshakes, the peak), stacks from FreeRTOS's high-water marks of the
+// tasks that registered themselves. Counters cover what a histogram
+// can't: how requests ended, bytes moved and frames dropped.
+
+enum PerfStage : uint8_t {
+  PERF_DNS = 0,      // Name lookup, cache hits included
+  PERF_CONNECT,      // Plain TCP connect
+  PERF_TLS,          // https: TCP connect + full handshake
+  PERF_TLS_RESUMED,  // https: TCP connect + resumed handshake
+  PERF_WAIT,         // Request sent → first response byte
+  PERF_TRANSFER,     // First → last response byte
+  PERF_FETCH,        // The whole request, kept-alive ones included
+  PERF_PARSE,        // Observation JSON → WeatherObs
+  PERF_FORECAST,     // Streamed forecast decode, summed over the body
+  PERF_RENDER,       // A full screen draw
+  PERF_PUSH_IMAGE,   // The 240x240 background blit
+  PERF_FRAME,        // A drawn wind needle frame
+  PERF_STAGE_COUNT
+};
+
+const uint8_t PERF_BUCKETS = 124;   // Covers the whole uint32_t range
+
+struct PerfSummary {
+  uint32_t count;
+  uint32_t minUs;
+  uint32_t maxUs;
+  uint32_t meanUs;
+  uint32_t p50Us;
+  uint32_t p90Us;
+  uint32_t p99Us;
+};
+
+// Raw copy for exporters; buckets[b] counts samples in (top(b - 1), top(b)]
+struct PerfHistogram {
+  uint32_t buckets[PERF_BUCKETS];
+  uint32_t count;
+  uint32_t minUs;
+  uint32_t maxUs;
+  uint64_t sumUs;
+};
+
+enum PerfCounter : uint8_t {
+  PERF_COUNT_REQUESTS = 0,    // Every finished HTTP request
+  PERF_COUNT_ERRORS,          // Transport errors and 4xx/5xx
+  PERF_COUNT_NOT_MODIFIED,    // 304: the ETag cache hit
+  PERF_COUNT_REUSED,          // Went out on a kept-alive connection
+  PERF_COUNT_BYTES_SENT,
+  PERF_COUNT_BYTES_RECEIVED,
+  PERF_COUNT_FRAMES_DROPPED,  // Wind needle deadlines missed
+  PERF_COUNT_DNS_HITS,        // Lookups answered from the TTL cache
+  PERF_COUNT_DNS_MISSES,      // Lookups that went to the resolver
+  PERF_COUNT_DNS_STALE,       // Misses the resolver failed, served expired
+  PERF_COUNTER_COUNT
+};
+
+void perfRecord(uint8_t stage, uint32_t us);
+void perfCount(uint8_t counter, uint32_t n = 1);
+
+// Network stages of a finished request; only what actually ran is recorded
+void perfRecordHttp(const AsyncHttpResponse& res);
+
+// false while the stage has no samples
+bool perfSummary(uint8_t stage, PerfSummary& out);
+
+// pct 0-100; 0 without samples
+uint32_t perfPercentile(uint8_t stage, float pct);
+
+// false while the stage has no samples (out is still a valid empty copy)
+bool perfHistogram(uint8_t stage, PerfHistogram& out);
+uint32_t perfBucketTopUs(uint8_t bucket);   // Largest value bucket b holds
+uint64_t perfCounter(uint8_t counter);
+const char* perfCounterName(uint8_t counter);   // "requests", "bytes_sent", ...
+
+const char* perfStageName(uint8_t stage);   // "dns", "tls", "push_image", ...
+void perfReset();
+
+// 🧠 Heap, in bytes
+struct PerfHeap {
+  uint32_t freeBytes;
+  uint32_t minFreeBytes;      // Since boot
+  uint32_t largestBlock;
+  uint32_t minLargestBlock;   // Lowest sampled
+};
+
+void perfSampleHeap();
+void perfHeap(PerfHeap& out);
+
+// 🧵 Call from inside a task to have its stack watched
+const uint8_t PERF_TASKS_MAX = 4;
+void perfWatchTask(const char* name);
+uint8_t perfTaskCount();
+const char* perfTaskName(uint8_t i);
+uint32_t perfTaskStackFree(uint8_t i);   // Bytes never touched so far
+
+// Samples the heap once a second and logs the tables once an hour
+void perfTick();
@@ -0,0 +1,99 @@
+#include "power.h"
+#include "sleep_cycle.h"
+#include "screens.h"
+#include "obs_log.h"
+#include "radio.h"
+#include "async_http.h"
+#include <esp_sleep.h>
+#include <driver/gpio.h>
+
+// 🧠 Survives deep sleep (zeroed again on power-on or reset)
+struct RtcState {
+  SleepCycle cycle;
+  ConnectionHints hints;
+  char etags[SCREEN_COUNT][ETAG_MAX];
+  uint16_t tlsSessionLen;   // 🔐 Lets the first handshake after a wake resume
+  uint8_t tlsSession[ASYNC_HTTP_SESSION_MAX];
+  ObsLogRtc obsLog;         // 📜 Pending readings + segment index
+};
+RTC_DATA_ATTR static RtcState rtc;
+
+static const SleepCycleConfig sleepConfig = {
+  FETCHED_SCREEN_COUNT,  // No live screens without the UDP listener
+  60000,         // Tempest publishes once a minute
+  15000,         // First retry
+  15 * 60000     // Retry ceiling
+};
+static const uint32_t fetchTimeoutMs = 20000;
+
+// Panel control lines (see lgfx_user_setup.h) latched through sleep so the
+// GC9A01 is neither reset nor selected and keeps showing its GRAM
+static const gpio_num_t panelHoldPins[] = { GPIO_NUM_6, GPIO_NUM_10, GPIO_NUM_7 };  // RST, CS, DC
+
+static CycleOutcome outcomeFor(uint8_t fetchStatus) {
+  switch (fetchStatus) {
+    case FETCH_OK:           return OUTCOME_FRESH;
+    case FETCH_NOT_MODIFIED: return OUTCOME_UNCHANGED;
+    default:                 return OUTCOME_FAILED;
+  }
+}
+
+bool powerBegin() {
+  for (gpio_num_t pin : panelHoldPins) gpio_hold_dis(pin);
+  gpio_deep_sleep_hold_dis();
+
+  bool timerWake = esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_TIMER;
+  cycleWake(rtc.cycle, timerWake ? WAKE_TIMER : WAKE_COLD);
+
+  if (timerWake) {
+    setConnectionHints(rtc.hints);
+    for (uint8_t s = 0; s < SCREEN_COUNT; s++) setCacheValidator(s, rtc.etags[s]);
+    asyncHttpLoadTlsSession(rtc.tlsSession, rtc.tlsSessionLen);
+    obsLogResume(rtc.obsLog);
+  }
+
+  Serial.printf("🌙 Wake #%lu (%s), refreshing screen %u\n",
+                (unsigned long)rtc.cycle.wakeCount, timerWake ? "timer" : "cold",
+                rtc.cycle.screen);
+  return cyclePanelRetained(rtc.cycle);
+}
+
+uint8_t powerScreen() {
+  return rtc.cycle.screen;
+}
+
+bool powerAllowPortal() {
+  return rtc.cycle.wakeCount <= 1;
+}
+
+bool powerFetchTimedOut() {
+  return millis() > fetchTimeoutMs;
+}
+
+bool powerShouldRender(const WeatherObs& obs) {
+  return cycleShouldRender(rtc.cycle, outcomeFor(obs.status));
+}
+
+void powerSleep(uint8_t fetchStatus, bool rendered) {
+  uint32_t sleepMs = cycleFinish(rtc.cycle, outcomeFor(fetchStatus), rendered, sleepConfig);
+  uint32_t awakeMs = millis();
+  sleepMs = sleepMs > awakeMs ? sleepMs - awakeMs : 1000;  // Keep the period steady
+
+  getConnectionHints(rtc.hints);
+  for (uint8_t s = 0; s < SCREEN_COUNT; s++) {
+    strlcpy(rtc.etags[s], cacheValidator(s), ETAG_MAX);
+  }
+  rtc.tlsSessionLen = asyncHttpSaveTlsSession(rtc.tlsSession, sizeof(rtc.tlsSession));
+  obsLogSuspend(rtc.obsLog);  // Written once the batch is full or old
+
+  Serial.printf("😴 Awake %lu ms, sleeping %lu ms\n", (unsigned long)awakeMs, (unsigned long)sleepMs);
+  Serial.flush();
+
+  radioPowerDown();
+
+  for (gpio_num_t pin : panelHoldPins) gpio_hold_en(pin);
+  gpio_deep_sleep_hold_en();
+
+  esp_sleep_enable_timer_wakeup((uint64_t)sleepMs * 1000ULL);
+  esp_deep_sleep_start();
+}
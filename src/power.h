@@ -0,0 +1,22 @@
+#pragma once
+#include "api.h"
+
+// 🔋 Battery mode: fetch, render once, deep-sleep until the next refresh.
+// Build the xiao_esp32c3_battery env (TEMPEST_DEEP_SLEEP) to enable it.
+#ifdef TEMPEST_DEEP_SLEEP
+const bool deepSleepMode = true;
+#else
+const bool deepSleepMode = false;
+#endif
+
+// First thing in setup(). Restores RTC state and returns true when the
+// panel still holds the last frame (init it without a reset).
+bool powerBegin();
+
+uint8_t powerScreen();          // Screen to refresh on this wake
+bool powerAllowPortal();        // WiFiManager only on cold boots
+bool powerFetchTimedOut();      // Give up on this wake's fetch
+bool powerShouldRender(const WeatherObs& obs);
+
+// Save RTC state (the log batch included), hold the panel pins and sleep. Never returns.
+void powerSleep(uint8_t fetchStatus, bool rendered);
@@ -0,0 +1,112 @@
+#include "radio.h"
+#include <WiFi.h>
+#include <esp_timer.h>
+
+static const uint8_t HOURS_KEPT = 24;
+static const uint64_t MS_PER_HOUR = 3600000ULL;
+
+static RadioHourStats hours[HOURS_KEPT];
+static RadioTotals totals = {};
+static bool radioOn = false;
+static uint64_t onSince = 0;
+static uint32_t lastLoggedHour = 0;
+static portMUX_TYPE radioMux = portMUX_INITIALIZER_UNLOCKED;
+
+// 64-bit uptime so the buckets survive the 49-day millis() wrap
+static uint64_t uptimeMs() {
+  return esp_timer_get_time() / 1000;
+}
+
+static RadioHourStats& bucketFor(uint32_t hour) {
+  RadioHourStats& b = hours[hour % HOURS_KEPT];
+  if (b.hour != hour) {
+    b = {};
+    b.hour = hour;
+  }
+  return b;
+}
+
+// Charge on-time up to now, split across hour boundaries
+static void accrueOnTime(uint64_t now) {
+  while (radioOn && onSince < now) {
+    uint32_t hour = onSince / MS_PER_HOUR;
+    uint64_t until = min(now, (hour + 1) * MS_PER_HOUR);
+    bucketFor(hour).radioOnMs += until - onSince;
+    totals.radioOnMs += until - onSince;
+    onSince = until;
+  }
+}
+
+void radioPowerUp() {
+  if (radioOn) return;
+  WiFi.mode(WIFI_STA);
+
+  uint64_t now = uptimeMs();
+  portENTER_CRITICAL(&radioMux);
+  radioOn = true;
+  onSince = now;
+  bucketFor(now / MS_PER_HOUR).wakes++;
+  totals.wakes++;
+  portEXIT_CRITICAL(&radioMux);
+}
+
+void radioPowerDown() {
+  if (!radioOn) return;
+  WiFi.disconnect(true);
+  WiFi.mode(WIFI_OFF);
+
+  portENTER_CRITICAL(&radioMux);
+  accrueOnTime(uptimeMs());
+  radioOn = false;
+  portEXIT_CRITICAL(&radioMux);
+}
+
+void radioModemSleep() {
+  WiFi.setSleep(WIFI_PS_MAX_MODEM);
+}
+
+void radioActive() {
+  WiFi.setSleep(WIFI_PS_MIN_MODEM);
+}
+
+bool radioIsOn() {
+  return radioOn;
+}
+
+void radioCountBytes(uint32_t bytes) {
+  portENTER_CRITICAL(&radioMux);
+  bucketFor(uptimeMs() / MS_PER_HOUR).bytes += bytes;
+  portEXIT_CRITICAL(&radioMux);
+}
+
+bool radioStatsHour(uint8_t hoursAgo, RadioHourStats& out) {
+  uint64_t now = uptimeMs();
+  uint32_t current = now / MS_PER_HOUR;
+  if (hoursAgo >= HOURS_KEPT || hoursAgo > current) return false;
+
+  portENTER_CRITICAL(&radioMux);
+  accrueOnTime(now);
+  out = bucketFor(current - hoursAgo);
+  portEXIT_CRITICAL(&radioMux);
+  return true;
+}
+
+void radioTotals(RadioTotals& out) {
+  uint64_t now = uptimeMs();
+  portENTER_CRITICAL(&radioMux);
+  accrueOnTime(now);
+  out = totals;
+  portEXIT_CRITICAL(&radioMux);
+}
+
+void radioStatsTick() {
+  uint32_t current = uptimeMs() / MS_PER_HOUR;
+  if (current == lastLoggedHour) return;
+  lastLoggedHour = current;
+
+  RadioHourStats h;
+  if (!radioStatsHour(1, h)) return;
+  Serial.printf("📻 Hour %lu: radio on %lu ms, %lu bytes, %u wakes\n",
+                (unsigned long)h.hour, (unsigned long)h.radioOnMs,
+                (unsigned long)h.bytes, h.wakes);
+}
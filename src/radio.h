@@ -0,0 +1,29 @@
+#pragma once
+#include <Arduino.h>
+
+// 📻 Radio power states + per-hour accounting for battery sizing
+struct RadioHourStats {
+  uint32_t hour;       // Uptime hour this bucket covers
+  uint32_t radioOnMs;  // Associated or joining, modem-sleep included
+  uint32_t bytes;      // HTTP request + response bytes (no TCP/TLS overhead)
+  uint16_t wakes;      // Off → on transitions
+};
+
+void radioPowerUp();     // Off → STA, counts a wake
+void radioPowerDown();   // Disassociate and switch the radio off
+void radioModemSleep();  // Stay associated, sleep between DTIM beacons
+void radioActive();      // Light power save for the duration of a fetch
+bool radioIsOn();
+
+void radioCountBytes(uint32_t bytes);
+
+// Since boot, for counters that must never go backwards
+struct RadioTotals {
+  uint64_t radioOnMs;
+  uint32_t wakes;
+};
+
+// hoursAgo = 0 is the hour in progress; false past the kept history
+bool radioStatsHour(uint8_t hoursAgo, RadioHourStats& out);
+void radioTotals(RadioTotals& out);
+void radioStatsTick();   // Logs the finished hour once it rolls over
@@ -0,0 +1,97 @@
+#include "rotate_blit.h"
+#include <math.h>
+
+static const uint16_t SIN_STEPS = 1024;  // 0.35 degrees, interpolated between
+static int32_t sinTable[SIN_STEPS + 1];  // Q16, last entry wraps to the first
+static bool tableReady = false;
+
+static void buildTable() {
+  for (uint16_t i = 0; i <= SIN_STEPS; i++) {
+    sinTable[i] = (int32_t)lroundf(sinf(i * 2.0f * (float)M_PI / SIN_STEPS) * 65536.0f);
+  }
+  tableReady = true;
+}
+
+// Once per blit, so the interpolation is free; without it a needle pivoted
+// 100 px out lands up to 0.6 px off at the tip
+static int32_t sinQ16(uint16_t angle) {
+  if (!tableReady) buildTable();
+  int32_t a = sinTable[angle >> 6], b = sinTable[(angle >> 6) + 1];
+  return a + (((b - a) * (int32_t)(angle & 63) + 32) >> 6);
+}
+
+static int32_t cosQ16(uint16_t angle) {
+  return sinQ16(angle + 16384);
+}
+
+BlitRect rotatedBounds(const BlitSource& src, int16_t cx, int16_t cy, uint16_t angle) {
+  int32_t s = sinQ16(angle), c = cosQ16(angle);
+  const int32_t xs[2] = { -src.pivotX, src.w - src.pivotX };
+  const int32_t ys[2] = { -src.pivotY, src.h - src.pivotY };
+
+  int32_t minX = INT32_MAX, minY = INT32_MAX, maxX = INT32_MIN, maxY = INT32_MIN;
+  for (int32_t x : xs) {
+    for (int32_t y : ys) {
+      int32_t rx = x * c - y * s;  // Forward rotation, Q16
+      int32_t ry = x * s + y * c;
+      if (rx < minX) minX = rx;
+      if (rx > maxX) maxX = rx;
+      if (ry < minY) minY = ry;
+      if (ry > maxY) maxY = ry;
+    }
+  }
+
+  BlitRect r;
+  r.x = cx + (minX >> 16) - 1;  // One pixel of slack for rounding
+  r.y = cy + (minY >> 16) - 1;
+  r.w = ((maxX + 0xFFFF) >> 16) - (minX >> 16) + 2;
+  r.h = ((maxY + 0xFFFF) >> 16) - (minY >> 16) + 2;
+  return r;
+}
+
+BlitRect unionRect(const BlitRect& a, const BlitRect& b) {
+  if (a.w <= 0 || a.h <= 0) return b;
+  if (b.w <= 0 || b.h <= 0) return a;
+  int16_t x0 = a.x < b.x ? a.x : b.x;
+  int16_t y0 = a.y < b.y ? a.y : b.y;
+  int16_t x1 = a.x + a.w > b.x + b.w ? a.x + a.w : b.x + b.w;
+  int16_t y1 = a.y + a.h > b.y + b.h ? a.y + a.h : b.y + b.h;
+  return { x0, y0, (int16_t)(x1 - x0), (int16_t)(y1 - y0) };
+}
+
+BlitRect clipRect(const BlitRect& r, int16_t w, int16_t h) {
+  int16_t x0 = r.x < 0 ? 0 : r.x;
+  int16_t y0 = r.y < 0 ? 0 : r.y;
+  int16_t x1 = r.x + r.w > w ? w : r.x + r.w;
+  int16_t y1 = r.y + r.h > h ? h : r.y + r.h;
+  if (x1 <= x0 || y1 <= y0) return { 0, 0, 0, 0 };
+  return { x0, y0, (int16_t)(x1 - x0), (int16_t)(y1 - y0) };
+}
+
+void rotateBlit(uint16_t* dst, const BlitRect& area, const BlitSource& src, int16_t cx,
+                int16_t cy, uint16_t angle) {
+  int32_t s = sinQ16(angle), c = cosQ16(angle);
+
+  // Inverse rotation of each destination pixel centre, relative to the pivot:
+  // u = X*c + Y*s, v = -X*s + Y*c, so one step right adds (c, -s)
+  int32_t x0 = area.x - cx;
+  for (int16_t row = 0; row < area.h; row++) {
+    int32_t y = area.y + row - cy;
+    int32_t u = (x0 * c + y * s) + ((c + s) >> 1) + ((int32_t)src.pivotX << 16);
+    int32_t v = (y * c - x0 * s) + ((c - s) >> 1) + ((int32_t)src.pivotY << 16);
+    uint16_t* out = dst + row * area.w;
+
+    for (int16_t col = 0; col < area.w; col++, u += c, v -= s) {
+      uint32_t iu = (uint32_t)(u >> 16), iv = (uint32_t)(v >> 16);
+      if (iu >= (uint32_t)src.w || iv >= (uint32_t)src.h) continue;
+      uint16_t px = src.pixels[iv * src.w + iu];
+      if (px != src.transparent) out[col] = px;
+    }
+  }
+}
+
+uint16_t degreesToAngle(float degrees) {
+  float turns = degrees / 360.0f;
+  turns -= floorf(turns);
+  return (uint16_t)(int32_t)lroundf(turns * 65536.0f);
+}
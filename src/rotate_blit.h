@@ -0,0 +1,33 @@
+#pragma once
+#include <stdint.h>
+
+// 🔄 Fixed-point rotated blit for small sprites (gauge needles)
+//
+// Each destination pixel is mapped back into the source with Q16 steps, so
+// a row costs two adds per pixel and no trig. Angles are binary degrees:
+// 65536 = one full turn, clockwise on screen, 0 = unrotated.
+
+struct BlitRect {
+  int16_t x, y, w, h;
+};
+
+struct BlitSource {
+  const uint16_t* pixels;  // Row-major, w * h
+  int16_t w, h;
+  int16_t pivotX, pivotY;  // Rotation centre in source pixels; may lie outside
+  uint16_t transparent;    // Pixels equal to this are skipped
+};
+
+// Destination area the rotated source can touch, pivot placed at (cx, cy)
+BlitRect rotatedBounds(const BlitSource& src, int16_t cx, int16_t cy, uint16_t angle);
+
+// Smallest rect covering both; an empty rect (w or h <= 0) is ignored
+BlitRect unionRect(const BlitRect& a, const BlitRect& b);
+BlitRect clipRect(const BlitRect& r, int16_t w, int16_t h);
+
+// Draw into dst, a buffer covering exactly `area` (stride = area.w)
+void rotateBlit(uint16_t* dst, const BlitRect& area, const BlitSource& src, int16_t cx,
+                int16_t cy, uint16_t angle);
+
+// Degrees to binary degrees
+uint16_t degreesToAngle(float degrees);
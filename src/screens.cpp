@@ -0,0 +1,153 @@
+#include "screens.h"
+#include "display.h"
+#include "sparkline.h"
+#include "text_format.h"
+#include "perf.h"
+#include "trace.h"
+#include "background2.h"
+
+// 📉 Temperature trend under the Tempest reading
+static Sparkline tempTrend;
+
+const char* screenTitle(uint8_t screen) {
+  switch (screen) {
+    case SCREEN_SAN_DIEGO: return "San Diego";
+    case SCREEN_LONDON:    return "London";
+    case SCREEN_FORECAST:  return "Forecast";
+    case SCREEN_WIND:      return "Wind";
+    default:               return "";
+  }
+}
+
+void screensBegin() {
+  sparklineBegin(tempTrend, 50, 194, 140, 22, TFT_NAVY, TFT_WHITE);
+}
+
+void drawTemperatureScreen(const char* title, float temp_f, bool stale, bool trend) {
+  tft.fillScreen(TFT_WHITE);
+  tft.setSwapBytes(true);
+  uint32_t blitStart = micros();
+  traceBegin(TRACE_PUSH_IMAGE);
+  tft.pushImage(0, 0, 240, 240, background2);
+  traceEnd(TRACE_PUSH_IMAGE);
+  perfRecord(PERF_PUSH_IMAGE, micros() - blitStart);
+
+  tft.setTextColor(TFT_NAVY);
+  tft.setFont(&fonts::Font6);  // Big temp
+  tft.setTextSize(2);
+  char tempText[16];
+  formatTemperature(tempText, sizeof(tempText), temp_f);
+  int16_t tempX = (240 - tft.textWidth(tempText)) / 2;
+  int16_t tempY = 120 - (tft.fontHeight() / 2);
+  tempX += 15;
+  tempY += 20;
+  tft.drawString(tempText, tempX, tempY);
+  tft.setTextSize(1);
+  drawScreenTitle(title);
+
+  if (stale) {
+    // 💾 Last known value, fresh data still on its way
+    tft.setFont(&fonts::Font2);
+    tft.setTextColor(TFT_DARKGREY);
+    int16_t tagX = (240 - tft.textWidth("cached")) / 2;
+    tft.drawString("cached", tagX, 54);
+  }
+
+  if (trend) sparklinePush(tempTrend);
+}
+
+void addTemperatureTrend(float temp_f, bool visible) {
+  sparklineAdd(tempTrend, temp_f);
+  if (visible) sparklinePush(tempTrend);  // 🎯 Just the strip
+}
+
+void clearTemperatureTrend() {
+  sparklineClear(tempTrend);
+}
+
+void pushTemperatureTrend() {
+  sparklinePush(tempTrend);
+}
+
+static const char* weekday(uint32_t dayStart) {
+  static const char* names[] = { "Thu", "Fri", "Sat", "Sun", "Mon", "Tue", "Wed" };
+  return names[((dayStart + 43200) / 86400) % 7];  // Midday is the same day in any zone
+}
+
+void drawForecastScreen(const Forecast& f, bool stale) {
+  tft.fillScreen(TFT_WHITE);
+  drawScreenTitle(screenTitle(SCREEN_FORECAST));
+  char text[24];
+
+  // ⏰ Hourly columns
+  const uint8_t columns = min<uint8_t>(4, f.hourCount);
+  for (uint8_t i = 0; i < columns; i++) {
+    const ForecastHour& h = f.hours[i];
+    int16_t cx = 60 + i * 40;
+
+    tft.setFont(&fonts::Font2);
+    tft.setTextColor(TFT_DARKGREY);
+    formatHour12(text, sizeof(text), h.localHour);
+    tft.drawString(text, cx - tft.textWidth(text) / 2, 58);
+
+    tft.setFont(&fonts::Font4);
+    tft.setTextColor(TFT_NAVY);
+    formatNumber(text, sizeof(text), h.temp_f, 0);
+    tft.drawString(text, cx - tft.textWidth(text) / 2, 76);
+
+    if (h.precipPct > 0) {
+      tft.setFont(&fonts::Font2);
+      tft.setTextColor(TFT_BLUE);
+      formatPercent(text, sizeof(text), h.precipPct);
+      tft.drawString(text, cx - tft.textWidth(text) / 2, 104);
+    }
+  }
+
+  tft.drawFastHLine(30, 126, 180, TFT_LIGHTGREY);
+
+  // 📅 Daily rows
+  tft.setFont(&fonts::Font2);
+  const uint8_t rows = min<uint8_t>(3, f.dayCount);
+  for (uint8_t i = 0; i < rows; i++) {
+    const ForecastDay& d = f.days[i];
+    size_t n = formatText(text, sizeof(text), weekday(d.dayStart));
+    n += formatText(text + n, sizeof(text) - n, " ");
+    n += formatNumber(text + n, sizeof(text) - n, d.high_f, 0, "/");
+    n += formatNumber(text + n, sizeof(text) - n, d.low_f, 0, " ");
+    formatText(text + n, sizeof(text) - n, forecastIconLabel(d.icon));
+    tft.setTextColor(TFT_NAVY);
+    tft.drawString(text, (240 - tft.textWidth(text)) / 2, 134 + i * 22);
+  }
+
+  if (stale) {
+    tft.setTextColor(TFT_DARKGREY);
+    tft.drawString("cached", (240 - tft.textWidth("cached")) / 2, 204);
+  }
+}
+
+void drawAlertOverlay(const TempestEvent& ev) {
+  bool strike = ev.type == EVENT_STRIKE;
+  uint16_t accent = strike ? TFT_YELLOW : TFT_CYAN;
+  tft.fillRoundRect(ALERT_X, ALERT_Y, ALERT_W, ALERT_H, 10, TFT_NAVY);
+  tft.drawRoundRect(ALERT_X, ALERT_Y, ALERT_W, ALERT_H, 10, accent);
+
+  const char* title = strike ? "Lightning!" : "Rain started";
+  tft.setFont(&fonts::Font4);
+  tft.setTextColor(accent);
+  tft.drawString(title, (240 - tft.textWidth(title)) / 2, ALERT_Y + 14);
+
+  if (strike) {
+    char detail[32];
+    size_t n = formatUnsigned(detail, sizeof(detail), ev.distanceKm, " km away, energy ");
+    formatUnsigned(detail + n, sizeof(detail) - n, ev.energy);
+    tft.setFont(&fonts::Font2);
+    tft.setTextColor(TFT_WHITE);
+    tft.drawString(detail, (240 - tft.textWidth(detail)) / 2, ALERT_Y + 52);
+  }
+}
+
+void drawErrorScreen(const char* msg) {
+  tft.setFont(&fonts::Font4);
+  tft.fillScreen(TFT_BLACK);
+  tft.drawString(msg, 10, 20);
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include <Arduino.h>
+#include "forecast.h"
+#include "tempest_udp.h"
+
+// 🧭 Screen rotation order; single-reading screens come first
+enum ScreenId : uint8_t {
+  SCREEN_SAN_DIEGO = 0,  // Tempest station
+  SCREEN_LONDON = 1,     // OpenWeather
+  SCREEN_FORECAST = 2,   // Tempest better_forecast
+  SCREEN_WIND = 3,       // Hub rapid_wind, live
+  SCREEN_COUNT
+};
+const uint8_t OBS_SCREEN_COUNT = SCREEN_FORECAST;  // Backed by one WeatherObs
+const uint8_t FETCHED_SCREEN_COUNT = SCREEN_WIND;  // Refreshed over HTTP
+
+const char* screenTitle(uint8_t screen);
+
+// Screen sprites; call after tft.init()
+void screensBegin();
+
+// 🌡️ Big temperature gauge; stale = warm-start value from flash,
+// trend = the primary Tempest station, which owns the sparkline
+void drawTemperatureScreen(const char* title, float temp_f, bool stale, bool trend);
+
+// 📉 New Tempest sample; visible = the Tempest screen is up, so push the strip
+void addTemperatureTrend(float temp_f, bool visible);
+void clearTemperatureTrend();
+void pushTemperatureTrend();
+
+// 🗓️ Next hours across the top, next days below
+void drawForecastScreen(const Forecast& f, bool stale);
+
+// ⚡ Event alert box, drawn over whatever is showing
+const int16_t ALERT_X = 30;
+const int16_t ALERT_Y = 78;
+const int16_t ALERT_W = 180;
+const int16_t ALERT_H = 84;
+void drawAlertOverlay(const TempestEvent& ev);
+
+// ❌ Full-screen error text
+void drawErrorScreen(const char* msg);
+
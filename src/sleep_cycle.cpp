@@ -0,0 +1,46 @@
+#include "sleep_cycle.h"
+
+static const uint32_t CYCLE_MAGIC = 0x534C5031;  // "SLP1"
+
+void cycleWake(SleepCycle& c, WakeReason reason) {
+  if (reason == WAKE_COLD || c.magic != CYCLE_MAGIC) {
+    c = {};
+    c.magic = CYCLE_MAGIC;
+  }
+  c.wakeCount++;
+}
+
+bool cyclePanelRetained(const SleepCycle& c) {
+  return c.panelHoldsFrame;
+}
+
+bool cycleShouldRender(const SleepCycle& c, CycleOutcome outcome) {
+  bool frameIsThisScreen = c.panelHoldsFrame && c.shownScreen == c.screen;
+
+  switch (outcome) {
+    case OUTCOME_FRESH:     return true;
+    case OUTCOME_UNCHANGED: return !frameIsThisScreen;  // 🖼️ GRAM is already right
+    case OUTCOME_FAILED:    return !frameIsThisScreen;  // Keep last good frame up
+  }
+  return true;
+}
+
+uint32_t cycleFinish(SleepCycle& c, CycleOutcome outcome, bool rendered,
+                     const SleepCycleConfig& cfg) {
+  if (rendered) {
+    c.panelHoldsFrame = true;
+    c.shownScreen = c.screen;
+  }
+
+  if (outcome == OUTCOME_FAILED) {
+    // ⏳ Exponential backoff, same screen next time
+    if (c.failStreak < 16) c.failStreak++;
+    uint32_t wait = cfg.retryMs;
+    for (uint8_t i = 1; i < c.failStreak && wait < cfg.maxBackoffMs; i++) wait *= 2;
+    return wait < cfg.maxBackoffMs ? wait : cfg.maxBackoffMs;
+  }
+
+  c.failStreak = 0;
+  if (cfg.screenCount > 0) c.screen = (c.screen + 1) % cfg.screenCount;
+  return cfg.refreshMs;
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include <stdint.h>
+
+// 🌙 Deep-sleep refresh cycle: wake → fetch → render → sleep
+//
+// Pure logic with no Arduino dependencies so it runs off-device; power.cpp
+// feeds it wake reasons and fetch outcomes and keeps the struct in RTC memory.
+
+enum WakeReason : uint8_t {
+  WAKE_COLD = 0,  // Power-on, reset or flash
+  WAKE_TIMER
+};
+
+enum CycleOutcome : uint8_t {
+  OUTCOME_FRESH = 0,   // New reading
+  OUTCOME_UNCHANGED,   // 304, cached reading still current
+  OUTCOME_FAILED       // Network, HTTP or parse failure, or timeout
+};
+
+struct SleepCycleConfig {
+  uint8_t screenCount;
+  uint32_t refreshMs;     // Sleep between good refreshes
+  uint32_t retryMs;       // First retry after a failure
+  uint32_t maxBackoffMs;  // Retry ceiling
+};
+
+struct SleepCycle {
+  uint32_t magic;         // Guards against garbage after a cold boot
+  uint32_t wakeCount;
+  uint8_t screen;         // Screen to refresh on this wake
+  uint8_t failStreak;
+  uint8_t shownScreen;    // Screen currently held in panel GRAM
+  bool panelHoldsFrame;
+};
+
+// Start of every boot; cold boots reset the whole cycle
+void cycleWake(SleepCycle& c, WakeReason reason);
+
+// Panel kept its GRAM through sleep, so skip the reset in tft init
+bool cyclePanelRetained(const SleepCycle& c);
+
+// Whether this wake needs to touch the panel at all
+bool cycleShouldRender(const SleepCycle& c, CycleOutcome outcome);
+
+// Record what happened this wake; returns how long to sleep
+uint32_t cycleFinish(SleepCycle& c, CycleOutcome outcome, bool rendered,
+                     const SleepCycleConfig& cfg);
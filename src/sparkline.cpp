@@ -0,0 +1,106 @@
+#include "sparkline.h"
+#include <math.h>
+
+static const float MIN_SPAN = 1.0f;  // Keep sensor noise from filling the strip
+
+static float valueAt(const Sparkline& s, int16_t i) {
+  return s.values[(s.head + i) % s.w];
+}
+
+static int16_t rowFor(const Sparkline& s, float v) {
+  float frac = (v - s.lo) / (s.hi - s.lo);
+  int16_t row = (s.h - 1) - (int16_t)lroundf(frac * (s.h - 1));
+  if (row < 0) return 0;
+  if (row >= s.h) return s.h - 1;
+  return row;
+}
+
+// One column: a vertical run joining the previous sample to this one
+static void drawColumn(Sparkline& s, int16_t col, int16_t i) {
+  int16_t row = rowFor(s, valueAt(s, i));
+  int16_t prev = i > 0 ? rowFor(s, valueAt(s, i - 1)) : row;
+  int16_t top = row < prev ? row : prev;
+  int16_t bottom = row < prev ? prev : row;
+  s.sprite.drawFastVLine(col, top, bottom - top + 1, s.fg);
+}
+
+static void redrawAll(Sparkline& s) {
+  s.sprite.fillSprite(s.bg);
+  for (int16_t i = 0; i < s.count; i++) drawColumn(s, s.w - s.count + i, i);
+}
+
+// 📏 New scale only when the data leaves the range or shrinks to under half
+// of it; headroom keeps a slow drift from rescaling every sample
+static bool rescaleIfNeeded(Sparkline& s) {
+  float mn = valueAt(s, 0), mx = mn;
+  for (int16_t i = 1; i < s.count; i++) {
+    float v = valueAt(s, i);
+    if (v < mn) mn = v;
+    if (v > mx) mx = v;
+  }
+
+  float span = s.hi - s.lo;
+  bool fits = s.count > 1 && mn >= s.lo && mx <= s.hi;
+  if (fits && (mx - mn) * 2 >= span - MIN_SPAN) return false;
+
+  float pad = (mx - mn) * 0.1f;
+  if ((mx - mn) + 2 * pad < MIN_SPAN) pad = (MIN_SPAN - (mx - mn)) / 2;
+  s.lo = mn - pad;
+  s.hi = mx + pad;
+  return true;
+}
+
+bool sparklineBegin(Sparkline& s, int16_t x, int16_t y, int16_t w, int16_t h,
+                    uint16_t fg, uint16_t bg) {
+  if (w > SPARKLINE_MAX_W) w = SPARKLINE_MAX_W;
+  s.x = x;
+  s.y = y;
+  s.w = w;
+  s.h = h;
+  s.fg = fg;
+  s.bg = bg;
+
+  s.sprite.setColorDepth(8);  // RGB332 halves the RAM, push converts
+  s.ready = s.sprite.createSprite(w, h) != nullptr;
+  if (!s.ready) {
+    Serial.println("❌ Sparkline sprite allocation failed");
+    return false;
+  }
+  s.sprite.setBaseColor(bg);  // scroll() fills the vacated column with this
+  sparklineClear(s);
+  return true;
+}
+
+void sparklineAdd(Sparkline& s, float v) {
+  if (!s.ready || isnan(v)) return;
+
+  if (s.count < s.w) {
+    s.values[(s.head + s.count) % s.w] = v;
+    s.count++;
+  } else {
+    s.values[s.head] = v;  // Overwrite the oldest
+    s.head = (s.head + 1) % s.w;
+  }
+
+  if (rescaleIfNeeded(s)) {
+    redrawAll(s);
+    return;
+  }
+
+  // ⏩ Common case: move everything left and draw just the new column
+  s.sprite.scroll(-1, 0);
+  drawColumn(s, s.w - 1, s.count - 1);
+}
+
+void sparklinePush(Sparkline& s) {
+  if (!s.ready) return;
+  s.sprite.pushSprite(&tft, s.x, s.y);
+}
+
+void sparklineClear(Sparkline& s) {
+  s.head = 0;
+  s.count = 0;
+  s.lo = 0;
+  s.hi = MIN_SPAN;
+  if (s.ready) s.sprite.fillSprite(s.bg);
+}
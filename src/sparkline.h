@@ -0,0 +1,34 @@
+#pragma once
+#include "display.h"
+
+// 📉 Scrolling trend strip
+//
+// The chart lives in a small 8-bit sprite. A new sample scrolls the sprite
+// one column left and draws only the rightmost column; the whole strip is
+// redrawn only when the value range has to change. Pushing the sprite is
+// the only panel traffic, w x h pixels, never the screen background.
+
+const int16_t SPARKLINE_MAX_W = 160;
+
+struct Sparkline {
+  LGFX_Sprite sprite;
+  int16_t x, y, w, h;
+  uint16_t fg, bg;
+  float values[SPARKLINE_MAX_W];  // Ring, oldest at head
+  int16_t head;
+  int16_t count;
+  float lo, hi;                   // Current vertical scale
+  bool ready;
+};
+
+// Allocates the sprite; w is clamped to SPARKLINE_MAX_W
+bool sparklineBegin(Sparkline& s, int16_t x, int16_t y, int16_t w, int16_t h,
+                    uint16_t fg, uint16_t bg);
+
+// Shift in one sample (sprite only, nothing reaches the panel)
+void sparklineAdd(Sparkline& s, float v);
+
+// Blit the strip to the panel
+void sparklinePush(Sparkline& s);
+
+void sparklineClear(Sparkline& s);
@@ -0,0 +1,277 @@
+#include "stats.h"
+#include <math.h>
+#include <string.h>
+
+static const uint8_t M = STAT_METRIC_COUNT;
+
+// Fixed-point steps per unit, matching the history columns
+static const float metricScale[M] = { 10, 10, 10, 10, 10, 100, 10 };
+
+// A reading that was missing (NaN) in the sample; quantize() stops one above
+static const int16_t MISSING = INT16_MIN;
+
+struct Bucket {
+  uint32_t seq;      // timestamp / tier width
+  uint16_t count[M]; // Readings per metric; min/max mean nothing while 0
+  int16_t min[M];
+  int16_t max[M];
+  int32_t sum[M];
+};
+
+// One resolution + window. The ring holds the closed buckets still inside
+// the window; minQ/maxQ are monotonic deques of ring positions per metric.
+struct Tier {
+  uint32_t width;    // Seconds per bucket
+  uint8_t cap;       // Buckets per window
+  Bucket* ring;
+  uint8_t* minQ;     // M deques of cap positions each
+  uint8_t* maxQ;
+
+  uint8_t head;
+  uint8_t len;
+  uint8_t minHead[M], minLen[M];
+  uint8_t maxHead[M], maxLen[M];
+
+  Bucket open;       // Bucket still filling
+  bool hasOpen;
+
+  // Running window sums per metric, since a metric can miss readings the
+  // others have; trend time t is hours since originSeq
+  uint32_t originSeq;
+  uint32_t count[M];
+  uint8_t filled[M]; // Closed buckets holding at least one reading
+  int64_t sum[M];
+  double st[M], stt[M];
+  double sty[M];
+};
+
+static Bucket ring1h[60], ring24h[144], ring7d[168];
+static uint8_t minQ1h[M * 60], maxQ1h[M * 60];
+static uint8_t minQ24h[M * 144], maxQ24h[M * 144];
+static uint8_t minQ7d[M * 168], maxQ7d[M * 168];
+
+static Tier tiers[WINDOW_COUNT] = {
+  { 60,   60,  ring1h,  minQ1h,  maxQ1h },
+  { 600,  144, ring24h, minQ24h, maxQ24h },
+  { 3600, 168, ring7d,  minQ7d,  maxQ7d },
+};
+
+static int16_t quantize(float v, uint8_t m) {
+  if (isnan(v)) return MISSING;
+  float q = roundf(v * metricScale[m]);
+  if (q > INT16_MAX) return INT16_MAX;
+  if (q <= MISSING) return MISSING + 1;
+  return (int16_t)q;
+}
+
+static double bucketHours(const Tier& t, const Bucket& b) {
+  return (double)(b.seq - t.originSeq) * t.width / 3600.0;
+}
+
+// 🪜 Monotonic deque helpers (positions into t.ring)
+static uint8_t dqAt(const Tier& t, const uint8_t* q, uint8_t head, uint8_t i) {
+  return q[(head + i) % t.cap];
+}
+
+static void dqPush(Tier& t, uint8_t* q, uint8_t& head, uint8_t& len, uint8_t pos,
+                   uint8_t m, bool isMin) {
+  const Bucket& nb = t.ring[pos];
+  while (len > 0) {
+    const Bucket& back = t.ring[dqAt(t, q, head, len - 1)];
+    bool dominated = isMin ? back.min[m] >= nb.min[m] : back.max[m] <= nb.max[m];
+    if (!dominated) break;
+    len--;
+  }
+  q[(head + len) % t.cap] = pos;
+  len++;
+}
+
+static void dqEvict(Tier& t, const uint8_t* q, uint8_t& head, uint8_t& len, uint8_t pos) {
+  if (len > 0 && q[head] == pos) {
+    head = (head + 1) % t.cap;
+    len--;
+  }
+}
+
+static void dropOldest(Tier& t) {
+  uint8_t pos = t.head;
+  const Bucket& b = t.ring[pos];
+  double h = bucketHours(t, b);
+
+  for (uint8_t m = 0; m < M; m++) {
+    if (!b.count[m]) continue;
+    t.count[m] -= b.count[m];
+    t.filled[m]--;
+    t.st[m] -= b.count[m] * h;
+    t.stt[m] -= b.count[m] * h * h;
+    t.sum[m] -= b.sum[m];
+    t.sty[m] -= h * b.sum[m];
+    dqEvict(t, t.minQ + m * t.cap, t.minHead[m], t.minLen[m], pos);
+    dqEvict(t, t.maxQ + m * t.cap, t.maxHead[m], t.maxLen[m], pos);
+  }
+
+  t.head = (t.head + 1) % t.cap;
+  t.len--;
+}
+
+// Drop closed buckets that have slid out of the window ending at nowSeq
+static void evictBefore(Tier& t, uint32_t nowSeq) {
+  while (t.len > 0 && t.ring[t.head].seq + t.cap <= nowSeq) dropOldest(t);
+}
+
+// Rebuild the running sums from the ring with the oldest bucket as t = 0.
+// Called once the origin is a full window behind, so hours stay small and
+// the add/subtract rounding of the sums doesn't pile up into the trend.
+static void rebase(Tier& t) {
+  t.originSeq = t.ring[t.head].seq;
+  memset(t.count, 0, sizeof(t.count));
+  memset(t.filled, 0, sizeof(t.filled));
+  memset(t.sum, 0, sizeof(t.sum));
+  memset(t.st, 0, sizeof(t.st));
+  memset(t.stt, 0, sizeof(t.stt));
+  memset(t.sty, 0, sizeof(t.sty));
+  for (uint8_t i = 0; i < t.len; i++) {
+    const Bucket& b = t.ring[(t.head + i) % t.cap];
+    double h = bucketHours(t, b);
+    for (uint8_t m = 0; m < M; m++) {
+      if (!b.count[m]) continue;
+      t.count[m] += b.count[m];
+      t.filled[m]++;
+      t.st[m] += b.count[m] * h;
+      t.stt[m] += b.count[m] * h * h;
+      t.sum[m] += b.sum[m];
+      t.sty[m] += h * b.sum[m];
+    }
+  }
+}
+
+static void closeOpen(Tier& t) {
+  evictBefore(t, t.open.seq);
+  if (t.len == t.cap) dropOldest(t);
+
+  uint8_t pos = (t.head + t.len) % t.cap;
+  t.ring[pos] = t.open;
+  t.len++;
+
+  const Bucket& b = t.ring[pos];
+  double h = bucketHours(t, b);
+  for (uint8_t m = 0; m < M; m++) {
+    if (!b.count[m]) continue;  // Nothing to offer the deques either
+    t.count[m] += b.count[m];
+    t.filled[m]++;
+    t.st[m] += b.count[m] * h;
+    t.stt[m] += b.count[m] * h * h;
+    t.sum[m] += b.sum[m];
+    t.sty[m] += h * b.sum[m];
+    dqPush(t, t.minQ + m * t.cap, t.minHead[m], t.minLen[m], pos, m, true);
+    dqPush(t, t.maxQ + m * t.cap, t.maxHead[m], t.maxLen[m], pos, m, false);
+  }
+  t.hasOpen = false;
+  if (t.ring[t.head].seq - t.originSeq >= t.cap) rebase(t);
+}
+
+static void addToTier(Tier& t, uint32_t timestamp, const int16_t* v) {
+  uint32_t seq = timestamp / t.width;
+
+  if (t.hasOpen && seq < t.open.seq) return;  // Late sample, bucket already moved on
+  if (t.hasOpen && seq > t.open.seq) closeOpen(t);
+
+  if (!t.hasOpen) {
+    if (t.len == 0) t.originSeq = seq;
+    t.open = {};
+    t.open.seq = seq;
+    for (uint8_t m = 0; m < M; m++) {
+      t.open.min[m] = INT16_MAX;
+      t.open.max[m] = INT16_MIN;
+    }
+    t.hasOpen = true;
+  }
+
+  Bucket& b = t.open;
+  for (uint8_t m = 0; m < M; m++) {
+    if (v[m] == MISSING) continue;
+    b.count[m]++;
+    if (v[m] < b.min[m]) b.min[m] = v[m];
+    if (v[m] > b.max[m]) b.max[m] = v[m];
+    b.sum[m] += v[m];
+  }
+}
+
+void statsAdd(const HistorySample& s) {
+  int16_t v[M];
+  v[STAT_TEMP] = quantize(s.temp_f, STAT_TEMP);
+  v[STAT_PRESSURE] = quantize(s.pressure_mb, STAT_PRESSURE);
+  v[STAT_HUMIDITY] = quantize(s.humidity, STAT_HUMIDITY);
+  v[STAT_WIND_AVG] = quantize(s.wind_avg, STAT_WIND_AVG);
+  v[STAT_WIND_GUST] = quantize(s.wind_gust, STAT_WIND_GUST);
+  v[STAT_RAIN] = quantize(s.rain_mm, STAT_RAIN);
+  v[STAT_UV] = quantize(s.uv, STAT_UV);
+
+  for (uint8_t w = 0; w < WINDOW_COUNT; w++) addToTier(tiers[w], s.timestamp, v);
+}
+
+bool statsQuery(StatMetric metric, StatWindow window, uint32_t now, StatSummary& out) {
+  if (metric >= M || window >= WINDOW_COUNT) return false;
+  Tier& t = tiers[window];
+  uint8_t m = metric;
+
+  uint32_t nowSeq = now / t.width;
+  evictBefore(t, nowSeq);
+  bool useOpen = t.hasOpen && t.open.seq + t.cap > nowSeq;
+
+  uint32_t n = t.count[m];
+  int64_t sum = t.sum[m];
+  double st = t.st[m], stt = t.stt[m], sty = t.sty[m];
+  int16_t lo = INT16_MAX, hi = INT16_MIN;
+  uint8_t buckets = t.filled[m];
+
+  if (t.minLen[m]) lo = t.ring[t.minQ[m * t.cap + t.minHead[m]]].min[m];
+  if (t.maxLen[m]) hi = t.ring[t.maxQ[m * t.cap + t.maxHead[m]]].max[m];
+
+  if (useOpen && t.open.count[m]) {
+    const Bucket& b = t.open;
+    double h = bucketHours(t, b);
+    n += b.count[m];
+    sum += b.sum[m];
+    st += b.count[m] * h;
+    stt += b.count[m] * h * h;
+    sty += h * b.sum[m];
+    if (b.min[m] < lo) lo = b.min[m];
+    if (b.max[m] > hi) hi = b.max[m];
+    buckets++;
+  }
+  if (n == 0) return false;
+
+  float scale = metricScale[m];
+  out.samples = n;
+  out.min = lo / scale;
+  out.max = hi / scale;
+  out.total = sum / scale;
+  out.mean = out.total / n;
+
+  // 📉 Least-squares slope of value against time
+  double denom = n * stt - st * st;
+  out.trendPerHour = (buckets >= 2 && fabs(denom) > 1e-9)
+                       ? (float)((n * sty - st * (double)sum) / denom / scale)
+                       : 0.0f;
+  return true;
+}
+
+void statsClear() {
+  for (uint8_t w = 0; w < WINDOW_COUNT; w++) {
+    Tier& t = tiers[w];
+    t.head = t.len = 0;
+    memset(t.minHead, 0, sizeof(t.minHead));
+    memset(t.minLen, 0, sizeof(t.minLen));
+    memset(t.maxHead, 0, sizeof(t.maxHead));
+    memset(t.maxLen, 0, sizeof(t.maxLen));
+    t.hasOpen = false;
+    t.originSeq = 0;
+    memset(t.count, 0, sizeof(t.count));
+    memset(t.filled, 0, sizeof(t.filled));
+    memset(t.sum, 0, sizeof(t.sum));
+    memset(t.st, 0, sizeof(t.st));
+    memset(t.stt, 0, sizeof(t.stt));
+    memset(t.sty, 0, sizeof(t.sty));
+  }
+}
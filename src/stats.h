@@ -0,0 +1,44 @@
+#pragma once
+#include "history.h"
+
+// 📊 Rolling min/max/mean/trend per metric over 1 h, 24 h and 7 d
+//
+// Every observation lands in the open bucket of three tiers (1-minute,
+// 10-minute, hourly). Closed buckets sit in a per-tier ring sized to the
+// window, with running sums for the mean and the least-squares trend, and
+// monotonic deques of bucket positions for min/max. Updates are amortized
+// O(1) and queries are O(1); memory is fixed at compile time.
+
+enum StatMetric : uint8_t {
+  STAT_TEMP = 0,
+  STAT_PRESSURE,
+  STAT_HUMIDITY,
+  STAT_WIND_AVG,
+  STAT_WIND_GUST,
+  STAT_RAIN,
+  STAT_UV,
+  STAT_METRIC_COUNT
+};
+
+enum StatWindow : uint8_t {
+  WINDOW_1H = 0,    // 60 x 1-minute buckets
+  WINDOW_24H,       // 144 x 10-minute buckets
+  WINDOW_7D,        // 168 x hourly buckets
+  WINDOW_COUNT
+};
+
+struct StatSummary {
+  float min;
+  float max;
+  float mean;
+  float total;         // Sum of samples (rain)
+  float trendPerHour;  // Least-squares slope, 0 with < 2 buckets
+  uint32_t samples;    // Readings of this metric; NaN ones are skipped
+};
+
+void statsAdd(const HistorySample& s);
+
+// now = current epoch seconds; false when the window holds no samples
+bool statsQuery(StatMetric metric, StatWindow window, uint32_t now, StatSummary& out);
+
+void statsClear();
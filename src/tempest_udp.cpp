@@ -0,0 +1,137 @@
+#include "tempest_udp.h"
+#include "json_stream.h"
+#include <string.h>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#include <WiFi.h>
+#include <esp_timer.h>
+#include <lwip/sockets.h>
+#include "perf.h"
+#include "trace.h"
+#endif
+
+struct UdpParse {
+  TempestEvent* out;
+  char key[12];
+  uint8_t field;
+  bool ok;
+};
+
+// {"serial_number": "...", "type": "evt_strike", "hub_sn": "...", "evt": [...]}
+// rapid_wind carries its values in "ob" instead of "evt"
+static bool onUdpToken(const JsonToken& tok, void* ctx) {
+  UdpParse& p = *(UdpParse*)ctx;
+  TempestEvent& ev = *p.out;
+
+  if (tok.event == JSON_KEY && tok.depth == 1) {
+    strncpy(p.key, tok.text, sizeof(p.key) - 1);
+    p.key[sizeof(p.key) - 1] = '\0';
+  } else if (tok.event == JSON_STRING && tok.depth == 1 && strcmp(p.key, "type") == 0) {
+    if (strcmp(tok.text, "evt_strike") == 0) {
+      ev.type = EVENT_STRIKE;
+    } else if (strcmp(tok.text, "evt_precip") == 0) {
+      ev.type = EVENT_PRECIP;
+    } else if (strcmp(tok.text, "rapid_wind") == 0) {
+      ev.type = EVENT_RAPID_WIND;
+    } else {
+      return false;  // Not one of ours, skip the rest
+    }
+  } else if (tok.event == JSON_NUMBER && tok.depth == 2 && strcmp(p.key, "evt") == 0) {
+    switch (p.field++) {
+      case 0: ev.epoch = (uint32_t)tok.number; p.ok = true; break;
+      case 1: ev.distanceKm = (uint16_t)tok.number; break;
+      case 2: ev.energy = (uint32_t)tok.number; break;
+    }
+  } else if (tok.event == JSON_NUMBER && tok.depth == 2 && strcmp(p.key, "ob") == 0) {
+    switch (p.field++) {
+      case 0: ev.epoch = (uint32_t)tok.number; break;
+      case 1: ev.windSpeed = (float)tok.number; break;
+      case 2: ev.windDir = (float)tok.number; p.ok = true; break;
+    }
+  }
+  return true;
+}
+
+bool parseTempestUdp(const uint8_t* data, size_t len, TempestEvent& out) {
+  out = {};
+  UdpParse p = {};
+  p.out = &out;
+
+  JsonStream js;
+  jsonStreamBegin(js, onUdpToken, &p);
+  jsonStreamFeed(js, data, len);
+  return jsonStreamDone(js) && out.type != EVENT_NONE && p.ok;
+}
+
+#ifdef ARDUINO
+
+static QueueHandle_t events = nullptr;
+
+static int openSocket() {
+  int fd = socket(AF_INET, SOCK_DGRAM, 0);
+  if (fd < 0) return -1;
+
+  timeval timeout = { 1, 0 };  // Wake up to notice WiFi going away
+  setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+  sockaddr_in addr = {};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(TEMPEST_UDP_PORT);
+  addr.sin_addr.s_addr = htonl(INADDR_ANY);
+  if (bind(fd, (sockaddr*)&addr, sizeof(addr)) < 0) {
+    close(fd);
+    return -1;
+  }
+  Serial.printf("📨 Listening for Tempest broadcasts on UDP %u\n", TEMPEST_UDP_PORT);
+  return fd;
+}
+
+static void udpTask(void*) {
+  int fd = -1;
+  uint8_t buf[512];
+  perfWatchTask("udp");
+
+  for (;;) {
+    if (WiFi.status() != WL_CONNECTED) {
+      if (fd >= 0) close(fd);
+      fd = -1;
+      vTaskDelay(pdMS_TO_TICKS(1000));
+      continue;
+    }
+    if (fd < 0 && (fd = openSocket()) < 0) {
+      vTaskDelay(pdMS_TO_TICKS(1000));
+      continue;
+    }
+
+    int n = recv(fd, buf, sizeof(buf), 0);
+    int64_t at = esp_timer_get_time();
+    if (n <= 0) continue;  // Timeout
+
+    TempestEvent ev;
+    if (!parseTempestUdp(buf, n, ev)) continue;
+    ev.receivedUs = at;
+    traceInstant(TRACE_HUB_EVENT, ev.type);
+    xQueueSend(events, &ev, 0);
+  }
+}
+
+void startEventListener() {
+  if (events) return;
+  events = xQueueCreate(8, sizeof(TempestEvent));
+  xTaskCreate(udpTask, "udp", 4096, nullptr, 2, nullptr);  // Above the fetch task
+}
+
+bool eventListenerRunning() {
+  return events != nullptr;
+}
+
+bool pollTempestEvent(TempestEvent& out, uint32_t waitMs) {
+  if (!events) {
+    delay(waitMs);
+    return false;
+  }
+  return xQueueReceive(events, &out, pdMS_TO_TICKS(waitMs)) == pdTRUE;
+}
+
+#endif
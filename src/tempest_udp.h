@@ -0,0 +1,49 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+// 📨 Tempest hub UDP broadcasts (port 50222)
+//
+// The hub pushes events on the LAN the moment the sensor reports them,
+// long before the REST observation catches up. A small task listens,
+// decodes each datagram with the streaming tokenizer and queues the events
+// we act on, stamped with the receive time for latency accounting.
+
+enum TempestEventType : uint8_t {
+  EVENT_NONE = 0,
+  EVENT_STRIKE,     // evt_strike: [epoch, distance km, energy]
+  EVENT_PRECIP,     // evt_precip: [epoch], rain started
+  EVENT_RAPID_WIND  // rapid_wind: [epoch, speed m/s, direction], every 3 s
+};
+
+struct TempestEvent {
+  uint8_t type;          // TempestEventType
+  uint32_t epoch;
+  uint16_t distanceKm;
+  uint32_t energy;
+  float windSpeed;       // m/s
+  float windDir;         // Degrees
+  int64_t receivedUs;    // esp_timer time the datagram arrived
+};
+
+const uint16_t TEMPEST_UDP_PORT = 50222;
+
+// 📡 Off unless built with TEMPEST_HUB_EVENTS (the xiao_esp32c3_hub env).
+// Live alerts cost the radio's idle savings: broadcasts only arrive while
+// it is associated and awake, so with the listener running the radio is
+// never powered down or put in modem sleep between fetches (see idleRadio()
+// in api.cpp). Without it, events show up with the next REST refresh.
+#ifdef TEMPEST_HUB_EVENTS
+const bool hubEventsEnabled = true;
+#else
+const bool hubEventsEnabled = false;
+#endif
+
+// false for message types we ignore or malformed datagrams
+bool parseTempestUdp(const uint8_t* data, size_t len, TempestEvent& out);
+
+void startEventListener();
+bool eventListenerRunning();
+
+// Blocks up to waitMs for the next event
+bool pollTempestEvent(TempestEvent& out, uint32_t waitMs);
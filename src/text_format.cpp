@@ -0,0 +1,118 @@
+#include "text_format.h"
+#include <math.h>
+
+static const int32_t pow10s[] = { 1, 10, 100, 1000 };
+
+// Bounded writer; drops what doesn't fit and keeps the terminator slot
+struct TextOut {
+  char* p;
+  size_t cap;
+  size_t len;
+};
+
+static void put(TextOut& o, char c) {
+  if (o.len + 1 < o.cap) o.p[o.len++] = c;
+}
+
+static void putText(TextOut& o, const char* s) {
+  while (*s) put(o, *s++);
+}
+
+static void putDigits(TextOut& o, uint32_t v, uint8_t minDigits) {
+  char digits[10];
+  uint8_t n = 0;
+  do {
+    digits[n++] = '0' + v % 10;
+    v /= 10;
+  } while (v || n < minDigits);
+  while (n) put(o, digits[--n]);
+}
+
+static size_t done(TextOut& o) {
+  if (o.cap) o.p[o.len] = '\0';
+  return o.len;
+}
+
+size_t formatText(char* out, size_t cap, const char* text) {
+  TextOut o = { out, cap, 0 };
+  putText(o, text);
+  return done(o);
+}
+
+size_t formatNumber(char* out, size_t cap, float v, uint8_t decimals, const char* unit) {
+  TextOut o = { out, cap, 0 };
+  if (decimals > 3) decimals = 3;
+  int32_t scale = pow10s[decimals];
+  float scaled = v * scale;
+
+  if (isnan(scaled) || fabsf(scaled) >= 2.1e9f) {
+    putText(o, "--");
+  } else {
+    int32_t q = lroundf(scaled);  // Half away from zero; -0.04 → "0.0", not "-0.0"
+    uint32_t mag = q < 0 ? -(uint32_t)q : (uint32_t)q;
+    if (q < 0) put(o, '-');
+    putDigits(o, mag / scale, 1);
+    if (decimals) {
+      put(o, '.');
+      putDigits(o, mag % scale, decimals);
+    }
+  }
+  putText(o, unit);
+  return done(o);
+}
+
+size_t formatUnsigned(char* out, size_t cap, uint32_t v, const char* unit) {
+  TextOut o = { out, cap, 0 };
+  putDigits(o, v, 1);
+  putText(o, unit);
+  return done(o);
+}
+
+size_t formatTemperature(char* out, size_t cap, float temp_f) {
+  return formatNumber(out, cap, temp_f, 1, " F");
+}
+
+size_t formatSpeed(char* out, size_t cap, float mps) {
+  return formatNumber(out, cap, mps, 1, " m/s");
+}
+
+size_t formatPressure(char* out, size_t cap, float mb) {
+  return formatNumber(out, cap, mb, 1, " mb");
+}
+
+size_t formatPercent(char* out, size_t cap, float pct) {
+  return formatNumber(out, cap, pct, 0, "%");
+}
+
+const char* windDirFromDegrees(float deg) {
+  static const char* const directions[] = {
+    "N", "NNE", "NE", "ENE",
+    "E", "ESE", "SE", "SSE",
+    "S", "SSW", "SW", "WSW",
+    "W", "WNW", "NW", "NNW"
+  };
+  if (isnan(deg)) return "--";
+  float wrapped = fmodf(deg, 360.0f);
+  if (wrapped < 0) wrapped += 360.0f;
+  return directions[(int)((wrapped + 11.25f) / 22.5f) % 16];
+}
+
+size_t formatHour12(char* out, size_t cap, uint8_t hour) {
+  TextOut o = { out, cap, 0 };
+  hour %= 24;
+  putDigits(o, hour % 12 ? hour % 12 : 12, 1);
+  put(o, hour < 12 ? 'a' : 'p');
+  return done(o);
+}
+
+size_t formatClock(char* out, size_t cap, uint32_t epoch, int32_t utcOffsetSec) {
+  TextOut o = { out, cap, 0 };
+  int64_t local = (int64_t)epoch + utcOffsetSec;
+  uint32_t secOfDay = (uint32_t)(((local % 86400) + 86400) % 86400);
+  uint8_t hour = secOfDay / 3600;
+  putDigits(o, hour % 12 ? hour % 12 : 12, 1);
+  put(o, ':');
+  putDigits(o, secOfDay / 60 % 60, 2);
+  put(o, hour < 12 ? 'a' : 'p');
+  return done(o);
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+// 🔤 Display strings written into caller buffers, no heap
+//
+// Every formatter writes at most cap - 1 characters plus a terminator and
+// returns the length it wrote, so pieces chain as
+// n += formatX(buf + n, sizeof(buf) - n, ...) without overflowing. Values
+// round half away from zero to the stated places; NaN prints as "--".
+// Units follow the number after a space ("72.4 F", "3.2 m/s").
+
+size_t formatText(char* out, size_t cap, const char* text);
+
+// v rounded to decimals (0-3) places, then unit verbatim
+size_t formatNumber(char* out, size_t cap, float v, uint8_t decimals, const char* unit = "");
+size_t formatUnsigned(char* out, size_t cap, uint32_t v, const char* unit = "");
+
+size_t formatTemperature(char* out, size_t cap, float temp_f);   // "72.4 F"
+size_t formatSpeed(char* out, size_t cap, float mps);            // "3.2 m/s"
+size_t formatPressure(char* out, size_t cap, float mb);          // "1013.2 mb"
+size_t formatPercent(char* out, size_t cap, float pct);          // "45%"
+
+// 🧭 16-point compass name; a constant, nothing to free
+const char* windDirFromDegrees(float deg);
+
+// ⏰ 12-hour clock: hour 0-23 → "3p"; epoch + UTC offset → "3:05p"
+size_t formatHour12(char* out, size_t cap, uint8_t hour);
+size_t formatClock(char* out, size_t cap, uint32_t epoch, int32_t utcOffsetSec);
@@ -0,0 +1,234 @@
+#include "trace.h"
+#include <Arduino.h>
+#include <string.h>
+#include <stdio.h>
+
+#ifdef ARDUINO
+static portMUX_TYPE traceMux = portMUX_INITIALIZER_UNLOCKED;
+#define TRACE_LOCK() portENTER_CRITICAL(&traceMux)
+#define TRACE_UNLOCK() portEXIT_CRITICAL(&traceMux)
+#else
+#define TRACE_LOCK()
+#define TRACE_UNLOCK()
+#endif
+
+struct TraceEvent {
+  uint32_t us;
+  uint8_t phase;
+  uint8_t task;
+  uint8_t name;
+  uint8_t id;
+};
+
+static TraceEvent ring[TRACE_EVENTS];
+static uint16_t head = 0;        // Next slot to write
+static uint16_t held = 0;
+static uint32_t dropped = 0;
+static uint8_t dumping = 0;      // Dumps in progress; recording waits
+
+static const char* const names[TRACE_NAME_COUNT] = {
+  "http", "dns", "connect", "tls", "wait", "transfer", "parse", "forecast", "render",
+  "push_image", "frame", "hub_event", "fetch_queued"
+};
+
+// 🧵 Task ids in order of first appearance
+#ifdef ARDUINO
+static TaskHandle_t taskHandles[TRACE_TASKS_MAX];
+#endif
+static const char* taskNames[TRACE_TASKS_MAX];
+static uint8_t taskCount = 0;
+
+// Under the lock; tasks past the table share its last id
+static uint8_t currentTask() {
+#ifdef ARDUINO
+  TaskHandle_t self = xTaskGetCurrentTaskHandle();
+  for (uint8_t i = 0; i < taskCount; i++) {
+    if (taskHandles[i] == self) return i;
+  }
+  if (taskCount == TRACE_TASKS_MAX) return TRACE_TASKS_MAX - 1;
+  taskHandles[taskCount] = self;
+  taskNames[taskCount] = pcTaskGetName(self);
+  return taskCount++;
+#else
+  if (!taskCount) taskNames[taskCount++] = "main";
+  return 0;
+#endif
+}
+
+void traceRecord(uint8_t phase, uint8_t name, uint8_t id) {
+  TRACE_LOCK();
+  if (dumping) {
+    dropped++;
+  } else {
+    TraceEvent& e = ring[head];
+    e.us = micros();
+    e.phase = phase;
+    e.task = currentTask();
+    e.name = name;
+    e.id = id;
+    head = (head + 1) % TRACE_EVENTS;
+    if (held < TRACE_EVENTS) held++;
+    else dropped++;
+  }
+  TRACE_UNLOCK();
+}
+
+const char* traceName(uint8_t name) {
+  return name < TRACE_NAME_COUNT ? names[name] : "";
+}
+
+uint32_t traceCount() {
+  return held;
+}
+
+uint32_t traceDropped() {
+  return dropped;
+}
+
+void traceClear() {
+  TRACE_LOCK();
+  head = held = 0;
+  dropped = 0;
+  TRACE_UNLOCK();
+}
+
+// 📤 Dump
+
+enum DumpSection : uint8_t {
+  DUMP_HEADER = 0,
+  DUMP_TASKS,
+  DUMP_NAMES,
+  DUMP_EVENTS,
+  DUMP_FOOTER,
+  DUMP_DONE
+};
+
+static const uint8_t EVENTS_PER_LINE = 8;
+
+void traceDumpBegin(TraceCursor& c) {
+  memset(&c, 0, sizeof(c));
+  TRACE_LOCK();
+  dumping++;
+  c.count = held;
+  c.first = (head + TRACE_EVENTS - held) % TRACE_EVENTS;
+  TRACE_UNLOCK();
+  c.active = true;
+}
+
+void traceDumpEnd(TraceCursor& c) {
+  if (!c.active) return;
+  c.active = false;
+  c.section = DUMP_DONE;
+  TRACE_LOCK();
+  dumping--;
+  TRACE_UNLOCK();
+}
+
+// Little-endian whatever the host, so the converter needn't care
+static int writeEvent(char* out, const TraceEvent& e) {
+  static const char hex[] = "0123456789abcdef";
+  uint8_t bytes[8] = {
+    (uint8_t)e.us, (uint8_t)(e.us >> 8), (uint8_t)(e.us >> 16), (uint8_t)(e.us >> 24),
+    e.phase, e.task, e.name, e.id
+  };
+  for (uint8_t i = 0; i < 8; i++) {
+    out[i * 2] = hex[bytes[i] >> 4];
+    out[i * 2 + 1] = hex[bytes[i] & 15];
+  }
+  return 16;
+}
+
+// The ring isn't written while the dump holds the pause, so no lock here
+static int writeLine(TraceCursor& c, char* out) {
+  switch (c.section) {
+    case DUMP_HEADER:
+      c.section = DUMP_TASKS;
+      return snprintf(out, TRACE_LINE_MAX, "=== TRACE v1 events=%u dropped=%lu now=%lu ===\n",
+                      c.count, (unsigned long)dropped, (unsigned long)micros());
+    case DUMP_TASKS:
+      if (c.index < taskCount) {
+        c.index++;
+        return snprintf(out, TRACE_LINE_MAX, "T %u %s\n", c.index - 1, taskNames[c.index - 1]);
+      }
+      c.section = DUMP_NAMES;
+      c.index = 0;
+      return writeLine(c, out);
+    case DUMP_NAMES:
+      if (c.index < TRACE_NAME_COUNT) {
+        c.index++;
+        return snprintf(out, TRACE_LINE_MAX, "N %u %s\n", c.index - 1, names[c.index - 1]);
+      }
+      c.section = DUMP_EVENTS;
+      return writeLine(c, out);
+    case DUMP_EVENTS: {
+      if (c.next >= c.count) {
+        c.section = DUMP_FOOTER;
+        return writeLine(c, out);
+      }
+      int n = snprintf(out, TRACE_LINE_MAX, "E ");
+      for (uint8_t i = 0; i < EVENTS_PER_LINE && c.next < c.count; i++, c.next++) {
+        n += writeEvent(out + n, ring[(c.first + c.next) % TRACE_EVENTS]);
+      }
+      out[n++] = '\n';
+      return n;
+    }
+    case DUMP_FOOTER:
+      c.section = DUMP_DONE;
+      return snprintf(out, TRACE_LINE_MAX, "=== TRACE END ===\n");
+  }
+  return 0;
+}
+
+size_t traceDump(TraceCursor& c, char* buf, size_t cap) {
+  size_t len = 0;
+  while (c.active && cap - len >= TRACE_LINE_MAX) {
+    int n = writeLine(c, buf + len);
+    if (n <= 0) {
+      traceDumpEnd(c);
+      break;
+    }
+    len += n;
+  }
+  return len;
+}
+
+// ⌨️ Serial console
+
+#ifdef ARDUINO
+
+static const uint32_t SERIAL_STALL_MS = 5000;   // Console went away mid-dump
+
+static char command[16];
+static uint8_t commandLen = 0;
+static TraceCursor serialDump;
+static uint32_t lastWriteMs = 0;
+
+void traceSerialTick() {
+  while (Serial.available()) {
+    char ch = Serial.read();
+    if (ch != '\n' && ch != '\r') {
+      if (commandLen < sizeof(command) - 1) command[commandLen++] = ch;
+      continue;
+    }
+    command[commandLen] = '\0';
+    if (!strcmp(command, "trace") && !serialDump.active) {
+      traceDumpBegin(serialDump);
+      lastWriteMs = millis();
+    }
+    commandLen = 0;
+  }
+
+  char line[TRACE_LINE_MAX];
+  while (serialDump.active && Serial.availableForWrite() >= (int)TRACE_LINE_MAX) {
+    size_t n = traceDump(serialDump, line, sizeof(line));
+    if (n) Serial.write((const uint8_t*)line, n);
+    lastWriteMs = millis();
+  }
+  if (serialDump.active && millis() - lastWriteMs > SERIAL_STALL_MS) traceDumpEnd(serialDump);
+}
+
+#else
+
+void traceSerialTick() {}
+
+#endif
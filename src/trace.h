@@ -0,0 +1,87 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+// 🧵 Timeline trace: begin/end events in a fixed ring
+//
+// Where perf.h says a stage is slow, this shows how the tasks, network
+// waits and SPI pushes of a refresh interleave. Each event is 8 bytes
+// (micros, phase, task, name, id) in a ring that overwrites the oldest;
+// recording takes the same kind of critical section as perf and never
+// allocates. Work that stays on one task is a begin/end pair. A request's
+// network stages are async spans keyed by its async_http slot, since
+// concurrent requests interleave on the net task.
+//
+// The dump is text so it survives a serial log: a header line, the task
+// and name tables, then the events in hex, oldest first. Recording pauses
+// while a dump is in progress, so the dump is one consistent window.
+// native/trace/trace2chrome.py turns it into Chrome trace JSON
+// (chrome://tracing, ui.perfetto.dev).
+//
+//   === TRACE v1 events=812 dropped=0 now=91234567 ===
+//   T 1 net
+//   N 3 tls
+//   E 5fa7b70562010300...   up to 8 events, 16 hex digits each
+//   === TRACE END ===
+
+enum TraceName : uint8_t {
+  TRACE_HTTP = 0,        // async: a whole request, id = slot
+  TRACE_DNS,             // async
+  TRACE_CONNECT,         // async
+  TRACE_TLS,             // async: TCP connect + handshake
+  TRACE_WAIT,            // async: request sent → first byte
+  TRACE_TRANSFER,        // async: first byte → done
+  TRACE_PARSE,
+  TRACE_FORECAST,        // One streamed chunk of the forecast
+  TRACE_RENDER,
+  TRACE_PUSH_IMAGE,      // SPI: the 240x240 background
+  TRACE_FRAME,           // Wind needle frame, SPI push included
+  TRACE_HUB_EVENT,       // instant: a hub broadcast decoded
+  TRACE_FETCH_QUEUED,    // instant: requestFetch()
+  TRACE_NAME_COUNT
+};
+
+enum TracePhase : uint8_t {
+  TRACE_BEGIN = 'B',
+  TRACE_END = 'E',
+  TRACE_INSTANT = 'i',
+  TRACE_ASYNC_BEGIN = 'b',
+  TRACE_ASYNC_END = 'e'
+};
+
+const uint16_t TRACE_EVENTS = 1024;   // 8 KB, a few refreshes with the needle moving
+const uint8_t TRACE_TASKS_MAX = 8;
+const size_t TRACE_LINE_MAX = 160;    // Longest line the dump writes
+
+void traceRecord(uint8_t phase, uint8_t name, uint8_t id = 0);
+
+inline void traceBegin(uint8_t name) { traceRecord(TRACE_BEGIN, name); }
+inline void traceEnd(uint8_t name) { traceRecord(TRACE_END, name); }
+inline void traceInstant(uint8_t name, uint8_t id = 0) { traceRecord(TRACE_INSTANT, name, id); }
+inline void traceAsyncBegin(uint8_t name, uint8_t id) { traceRecord(TRACE_ASYNC_BEGIN, name, id); }
+inline void traceAsyncEnd(uint8_t name, uint8_t id) { traceRecord(TRACE_ASYNC_END, name, id); }
+
+const char* traceName(uint8_t name);
+uint32_t traceCount();     // Events held, up to TRACE_EVENTS
+uint32_t traceDropped();   // Overwritten or refused while a dump ran
+void traceClear();
+
+struct TraceCursor {
+  uint8_t section;
+  uint8_t index;       // Task or name within its table
+  uint16_t next;       // Events written so far
+  uint16_t count;      // Events in the window
+  uint16_t first;      // Ring index of the oldest
+  bool active;         // Holding the recording pause
+};
+
+// Pauses recording until the dump finishes or traceDumpEnd()
+void traceDumpBegin(TraceCursor& c);
+
+// Whole lines only, cap >= TRACE_LINE_MAX; 0 once everything is out
+size_t traceDump(TraceCursor& c, char* buf, size_t cap);
+void traceDumpEnd(TraceCursor& c);
+
+// ⌨️ "trace" + Enter on the serial console dumps the ring, a few lines per
+// call as the TX buffer drains
+void traceSerialTick();
@@ -0,0 +1,55 @@
+#include "weather_parse.h"
+#include "json_arena.h"
+
+void readTempest(JsonVariantConst root, WeatherObs& out) {
+  JsonVariantConst obs = root["obs"][0];
+  float temp_c = obs["air_temperature"].as<float>();
+  out.temp_f = (temp_c * 9.0 / 5.0) + 32.0;
+  out.timestamp = obs["timestamp"].as<uint32_t>();
+  // NaN when missing: the backfill's sea-level offset must not treat it as 0 mb
+  out.pressure_mb = obs["sea_level_pressure"] | NAN;
+  out.station_pressure_mb = obs["station_pressure"] | NAN;
+  out.humidity = obs["relative_humidity"].as<float>();
+  out.wind_avg = obs["wind_avg"].as<float>();
+  out.wind_gust = obs["wind_gust"].as<float>();
+  out.wind_dir = obs["wind_direction"].as<float>();
+  out.rain_mm = obs["precip"].as<float>();
+  out.uv = obs["uv"].as<float>();
+  out.status = FETCH_OK;
+}
+
+void readLondon(JsonVariantConst root, WeatherObs& out) {
+  out.temp_f = root["main"]["temp"].as<float>();
+  out.timestamp = root["dt"].as<uint32_t>();
+  out.pressure_mb = root["main"]["pressure"].as<float>();
+  out.humidity = root["main"]["humidity"].as<float>();
+  out.wind_avg = root["wind"]["speed"].as<float>() * 0.44704f;  // Imperial units: mph
+  out.wind_gust = root["wind"]["gust"].as<float>() * 0.44704f;
+  out.wind_dir = root["wind"]["deg"].as<float>();
+  out.rain_mm = root["rain"]["1h"].as<float>();
+  out.status = FETCH_OK;
+}
+
+bool parseTempest(const char* json, size_t len, WeatherObs& out) {
+  JsonDocument doc(jsonArenaBegin());
+  DeserializationError error = deserializeJson(doc, json, len);
+  jsonArenaEnd(JSON_TEMPEST);
+  if (error) {
+    out.status = FETCH_JSON_ERROR;
+    return false;
+  }
+  readTempest(doc.as<JsonVariantConst>(), out);
+  return true;
+}
+
+bool parseLondon(const char* json, size_t len, WeatherObs& out) {
+  JsonDocument doc(jsonArenaBegin());
+  DeserializationError error = deserializeJson(doc, json, len);
+  jsonArenaEnd(JSON_OPENWEATHER);
+  if (error) {
+    out.status = FETCH_JSON_ERROR;
+    return false;
+  }
+  readLondon(doc.as<JsonVariantConst>(), out);
+  return true;
+}
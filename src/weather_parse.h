@@ -0,0 +1,12 @@
+#pragma once
+#include <ArduinoJson.h>
+#include "api.h"
+
+// 🧩 Provider payload decoders (no I/O, run on the network task)
+bool parseTempest(const char* json, size_t len, WeatherObs& out);
+bool parseLondon(const char* json, size_t len, WeatherObs& out);
+
+// Field mapping from an already-parsed document (also used by the parse
+// benchmarks, so every strategy is scored on the same fields)
+void readTempest(JsonVariantConst root, WeatherObs& out);
+void readLondon(JsonVariantConst root, WeatherObs& out);
@@ -0,0 +1,185 @@
+#include "wind_gauge.h"
+#include "display.h"
+#include "text_format.h"
+#include "rotate_blit.h"
+#include "perf.h"
+#include "trace.h"
+#include <esp_timer.h>
+
+static const int16_t CX = 120;
+static const int16_t CY = 120;
+static const int16_t READOUT_R = 38;      // Speed + direction text inside this
+static const uint16_t NEEDLE_KEY = 0xF81F;
+
+static const int64_t FRAME_US = 25000;    // 40 fps target, 30 fps floor with slack
+static const int64_t REPORT_US = 10000000;
+static const float EASE_MS = 200.0f;      // Needle time constant
+
+// 🪟 Dirty-rect scratch: the dial is re-rendered here, then pushed
+static const int16_t TILE = 96;
+static uint16_t tileBuf[TILE * TILE];
+static LGFX_Sprite tile;
+
+static LGFX_Sprite needle;
+static BlitSource needleSrc;
+static BlitRect needleBox = { 0, 0, 0, 0 };  // Where the needle is on the panel
+
+static int16_t tickX0[16], tickY0[16], tickX1[16], tickY1[16];
+
+static float targetDeg = 0;
+static float shownDeg = 0;
+static uint16_t shownAngle = 0;
+static char speedText[8] = "--";
+static char dirText[16] = "m/s";
+
+struct FrameStats {
+  uint32_t frames;
+  uint32_t drawn;
+  uint32_t dropped;
+  uint64_t totalUs;
+  uint32_t maxUs;
+  int64_t since;
+};
+static FrameStats stats;
+static int64_t nextFrameUs = 0;
+static int64_t lastFrameUs = 0;
+
+// Dial, ticks, letters and readout, shifted so (ox, oy) lands on the
+// target's origin: the same call paints the panel or one tile
+static void drawDial(lgfx::LovyanGFX& g, int16_t ox, int16_t oy) {
+  int16_t cx = CX - ox, cy = CY - oy;
+  g.fillRect(0, 0, g.width(), g.height(), TFT_WHITE);
+  g.drawCircle(cx, cy, 114, TFT_NAVY);
+  g.drawCircle(cx, cy, 113, TFT_NAVY);
+  for (uint8_t i = 0; i < 16; i++) {
+    g.drawLine(tickX0[i] - ox, tickY0[i] - oy, tickX1[i] - ox, tickY1[i] - oy,
+               i % 4 ? TFT_LIGHTGREY : TFT_NAVY);
+  }
+
+  g.setTextDatum(textdatum_t::middle_center);
+  g.setTextColor(TFT_NAVY);
+  g.setFont(&fonts::Font4);
+  g.drawString("N", cx, cy - 88);
+  g.drawString("E", cx + 88, cy);
+  g.drawString("S", cx, cy + 88);
+  g.drawString("W", cx - 88, cy);
+
+  g.drawString(speedText, cx, cy - 8);
+  g.setFont(&fonts::Font2);
+  g.setTextColor(TFT_DARKGREY);
+  g.drawString(dirText, cx, cy + 16);
+  g.setTextDatum(textdatum_t::top_left);
+}
+
+// Re-render a panel rect in tiles: dial first, needle on top
+static void renderRegion(const BlitRect& region) {
+  BlitRect r = clipRect(region, 240, 240);
+  for (int16_t y = r.y; y < r.y + r.h; y += TILE) {
+    for (int16_t x = r.x; x < r.x + r.w; x += TILE) {
+      BlitRect t = { x, y, (int16_t)min<int16_t>(TILE, r.x + r.w - x),
+                     (int16_t)min<int16_t>(TILE, r.y + r.h - y) };
+      tile.setBuffer(tileBuf, t.w, t.h);
+      drawDial(tile, t.x, t.y);
+      rotateBlit(tileBuf, t, needleSrc, CX, CY, shownAngle);
+      tile.pushSprite(&tft, t.x, t.y);
+    }
+  }
+}
+
+void windGaugeBegin() {
+  // Needle points up, tip 100 px from the pivot, tail clear of the readout
+  needle.setColorDepth(16);
+  needle.createSprite(16, 58);
+  needle.fillSprite(NEEDLE_KEY);
+  needle.fillTriangle(8, 0, 1, 57, 14, 57, TFT_RED);
+  needle.drawLine(8, 2, 8, 57, TFT_MAROON);
+  needleSrc.pixels = (const uint16_t*)needle.getBuffer();
+  needleSrc.w = 16;
+  needleSrc.h = 58;
+  needleSrc.pivotX = 8;
+  needleSrc.pivotY = 100;
+  needleSrc.transparent = needleSrc.pixels ? needleSrc.pixels[0] : 0;  // Sprite byte order
+
+  for (uint8_t i = 0; i < 16; i++) {
+    float a = i * 22.5f * DEG_TO_RAD;
+    int16_t inner = i % 4 ? 104 : 98;
+    tickX0[i] = CX + lroundf(sinf(a) * inner);
+    tickY0[i] = CY - lroundf(cosf(a) * inner);
+    tickX1[i] = CX + lroundf(sinf(a) * 111);
+    tickY1[i] = CY - lroundf(cosf(a) * 111);
+  }
+}
+
+void drawWindScreen() {
+  needleBox = clipRect(rotatedBounds(needleSrc, CX, CY, shownAngle), 240, 240);
+  renderRegion({ 0, 0, 240, 240 });
+
+  int64_t now = esp_timer_get_time();
+  stats = {};
+  stats.since = now;
+  nextFrameUs = now + FRAME_US;
+  lastFrameUs = now;
+}
+
+void windGaugeUpdate(float speed, float dirDeg, bool visible) {
+  targetDeg = dirDeg;
+  formatNumber(speedText, sizeof(speedText), speed, 1);
+  size_t n = formatText(dirText, sizeof(dirText), "m/s ");
+  formatText(dirText + n, sizeof(dirText) - n, windDirFromDegrees(dirDeg));
+  if (visible) renderRegion({ CX - READOUT_R, CY - READOUT_R, 2 * READOUT_R, 2 * READOUT_R });
+}
+
+// 🎯 Ease toward the target along the short way round
+static void stepNeedle(float dtMs) {
+  float diff = fmodf(targetDeg - shownDeg + 540.0f, 360.0f) - 180.0f;
+  shownDeg += fabsf(diff) < 0.2f ? diff : diff * (1.0f - expf(-dtMs / EASE_MS));
+  shownDeg = fmodf(shownDeg + 360.0f, 360.0f);
+}
+
+static void reportFrames(int64_t now) {
+  float secs = (now - stats.since) / 1e6f;
+  Serial.printf("🧭 Wind gauge: %.1f fps (%lu drawn), avg %lu us, max %lu us, %lu dropped\n",
+                stats.frames / secs, (unsigned long)stats.drawn,
+                (unsigned long)(stats.drawn ? stats.totalUs / stats.drawn : 0),
+                (unsigned long)stats.maxUs, (unsigned long)stats.dropped);
+  stats = {};
+  stats.since = now;
+}
+
+uint32_t windGaugeTick() {
+  int64_t now = esp_timer_get_time();
+  if (now < nextFrameUs) return (nextFrameUs - now) / 1000;
+
+  // ⏱️ A whole period late means frames never made it to the panel
+  int64_t late = now - nextFrameUs;
+  if (late >= FRAME_US) {
+    stats.dropped += late / FRAME_US;
+    perfCount(PERF_COUNT_FRAMES_DROPPED, late / FRAME_US);
+    nextFrameUs = now;
+  }
+  nextFrameUs += FRAME_US;
+
+  stepNeedle((now - lastFrameUs) / 1000.0f);
+  lastFrameUs = now;
+  stats.frames++;
+
+  uint16_t angle = degreesToAngle(shownDeg);
+  if (angle != shownAngle) {
+    shownAngle = angle;
+    BlitRect box = clipRect(rotatedBounds(needleSrc, CX, CY, angle), 240, 240);
+    traceBegin(TRACE_FRAME);
+    renderRegion(unionRect(needleBox, box));
+    traceEnd(TRACE_FRAME);
+    needleBox = box;
+
+    uint32_t took = esp_timer_get_time() - now;
+    stats.drawn++;
+    stats.totalUs += took;
+    if (took > stats.maxUs) stats.maxUs = took;
+    perfRecord(PERF_FRAME, took);
+  }
+
+  if (now - stats.since >= REPORT_US) reportFrames(now);
+  int64_t wait = nextFrameUs - esp_timer_get_time();
+  return wait > 0 ? wait / 1000 : 0;
+}
@@ -0,0 +1,19 @@
+#pragma once
+#include <Arduino.h>
+
+// 🧭 Live wind dial driven by the hub's rapid_wind broadcasts (every 3 s)
+//
+// The needle eases toward each new direction at ~40 fps. A frame renders
+// only the dial under the union of the old and new needle bounds into a
+// small buffer, blits the needle into it with the fixed-point rotator and
+// pushes that rect alone. Frame time and missed deadlines are logged.
+
+void windGaugeBegin();
+
+void drawWindScreen();  // Whole dial, speed and needle
+
+// visible = the wind screen is up, so repaint the readout now
+void windGaugeUpdate(float speed, float dirDeg, bool visible);
+
+// Draw a frame if one is due; returns ms until the next one
+uint32_t windGaugeTick();
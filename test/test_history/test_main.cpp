@@ -0,0 +1,160 @@
+#include <unity.h>
+#include <math.h>
+#include <stdlib.h>
+#include <vector>
+#include "history.h"
+
+// 📈 The RAM history: exact round trips (missing readings included) and
+// whole-block eviction once the ring is full
+
+static const uint32_t T0 = 1700000000;
+
+void setUp() {
+  historyClear();
+  srand(7);
+}
+
+void tearDown() {}
+
+static float uniform(float lo, float hi) {
+  return lo + (hi - lo) * (rand() / (float)RAND_MAX);
+}
+
+// Noisy weather: every sensor column moves every minute
+static HistorySample step(HistorySample s) {
+  s.timestamp += 60;
+  s.temp_f += uniform(-0.3f, 0.3f);
+  s.pressure_mb += uniform(-0.15f, 0.15f);
+  s.humidity = fminf(100, fmaxf(0, s.humidity + uniform(-1, 1)));
+  s.wind_avg = fabsf(s.wind_avg + uniform(-0.5f, 0.5f));
+  s.wind_gust = s.wind_avg + uniform(0, 3);
+  s.wind_dir = fmodf(s.wind_dir + uniform(-25, 25) + 360, 360);
+  s.rain_mm = rand() % 20 ? 0 : uniform(0, 1);
+  s.uv = fabsf(s.uv + uniform(-0.2f, 0.2f));
+  return s;
+}
+
+static HistorySample start() {
+  HistorySample s = { T0 - 60, 60, 1013, 50, 3, 5, 180, 0, 3 };
+  return step(s);
+}
+
+// What a column reads back as: its fixed-point step, or NaN
+static void assertColumn(float want, float got, float scale) {
+  if (isnan(want)) {
+    TEST_ASSERT_TRUE(isnan(got));
+  } else {
+    TEST_ASSERT_EQUAL_FLOAT(lroundf(want * scale) / scale, got);
+  }
+}
+
+static void assertSame(const HistorySample& want, const HistorySample& got) {
+  TEST_ASSERT_EQUAL_UINT32(want.timestamp, got.timestamp);
+  assertColumn(want.temp_f, got.temp_f, 10);
+  assertColumn(want.pressure_mb, got.pressure_mb, 10);
+  assertColumn(want.humidity, got.humidity, 1);
+  assertColumn(want.wind_avg, got.wind_avg, 10);
+  assertColumn(want.wind_gust, got.wind_gust, 10);
+  assertColumn(want.wind_dir, got.wind_dir, 1);
+  assertColumn(want.rain_mm, got.rain_mm, 100);
+  assertColumn(want.uv, got.uv, 10);
+}
+
+static bool collect(const HistorySample& s, void* ctx) {
+  ((std::vector<HistorySample>*)ctx)->push_back(s);
+  return true;
+}
+
+static std::vector<HistorySample> since(uint32_t ts) {
+  std::vector<HistorySample> out;
+  historyForEach(ts, collect, &out);
+  return out;
+}
+
+void test_round_trip_keeps_missing_readings() {
+  std::vector<HistorySample> fed;
+  HistorySample s = start();
+  for (uint32_t i = 0; i < 600; i++) {
+    HistorySample in = s;
+    if (rand() % 5 == 0) in.temp_f = NAN;
+    if (rand() % 9 == 0) in.pressure_mb = NAN;
+    if (i >= 100 && i < 160) in.uv = NAN;    // A sensor out for an hour
+    if (rand() % 3 == 0) in.rain_mm = NAN;
+    TEST_ASSERT_TRUE(historyAppend(in));
+    fed.push_back(in);
+    s = step(s);
+  }
+  std::vector<HistorySample> got = since(0);
+  TEST_ASSERT_EQUAL_UINT32(fed.size(), got.size());
+  for (size_t i = 0; i < fed.size(); i++) assertSame(fed[i], got[i]);
+
+  HistorySample latest;
+  TEST_ASSERT_TRUE(historyLatest(latest));
+  assertSame(fed.back(), latest);
+}
+
+void test_zero_is_not_a_missing_reading() {
+  HistorySample s = start();
+  s.temp_f = 0;
+  s.uv = NAN;
+  historyAppend(s);
+  s.timestamp += 60;
+  s.temp_f = NAN;
+  s.uv = 0;
+  historyAppend(s);
+  std::vector<HistorySample> got = since(0);
+  TEST_ASSERT_EQUAL_UINT32(2, got.size());
+  TEST_ASSERT_EQUAL_FLOAT(0, got[0].temp_f);
+  TEST_ASSERT_TRUE(isnan(got[0].uv));
+  TEST_ASSERT_TRUE(isnan(got[1].temp_f));
+  TEST_ASSERT_EQUAL_FLOAT(0, got[1].uv);
+}
+
+void test_noisy_day_fits_the_backfill_window() {
+  HistorySample s = start();
+  for (uint32_t i = 0; i < 36 * 60; i++) {
+    historyAppend(s);
+    s = step(s);
+  }
+  HistorySample latest;
+  historyLatest(latest);
+  std::vector<HistorySample> day = since(latest.timestamp - 24 * 3600UL);
+  TEST_ASSERT_EQUAL_UINT32(24 * 60 + 1, day.size());   // main.cpp backfills 24 h
+}
+
+void test_full_ring_drops_the_oldest_block_whole() {
+  HistorySample s = start();
+  size_t fed = 0;
+  size_t peak = 0;
+  bool dropped = false;
+  while (fed < 5000) {
+    historyAppend(s);
+    fed++;
+    s = step(s);
+    if (historyCount() < fed && !dropped) {
+      dropped = true;
+      TEST_ASSERT_GREATER_THAN_UINT32(1, fed - historyCount());  // A block, not a sample
+    }
+    if (historyCount() > peak) peak = historyCount();
+  }
+  TEST_ASSERT_TRUE(dropped);
+
+  // What's left is the newest stretch, contiguous and in order
+  std::vector<HistorySample> kept = since(0);
+  TEST_ASSERT_EQUAL_UINT32(historyCount(), kept.size());
+  TEST_ASSERT_LESS_OR_EQUAL_UINT32(peak, kept.size());
+  for (size_t i = 1; i < kept.size(); i++) {
+    TEST_ASSERT_EQUAL_UINT32(kept[i - 1].timestamp + 60, kept[i].timestamp);
+  }
+  TEST_ASSERT_EQUAL_UINT32(s.timestamp - 60, kept.back().timestamp);
+  TEST_ASSERT_EQUAL_UINT32(s.timestamp - 60 * kept.size(), kept.front().timestamp);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_round_trip_keeps_missing_readings);
+  RUN_TEST(test_zero_is_not_a_missing_reading);
+  RUN_TEST(test_noisy_day_fits_the_backfill_window);
+  RUN_TEST(test_full_ring_drops_the_oldest_block_whole);
+  return UNITY_END();
+}
@@ -0,0 +1,145 @@
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include "json_stream.h"
+
+// 🌊 The streaming JSON tokenizer: events, depths, splits, errors, stopping
+
+void setUp() {}
+void tearDown() {}
+
+// Every token as "depth:event[text]" separated by spaces
+struct EventLog {
+  char text[1024];
+  size_t len;
+  uint32_t tokens;
+  uint32_t stopAfter;  // Stop the stream after this many tokens, 0 = never
+};
+
+static bool logToken(const JsonToken& tok, void* ctx) {
+  static const char* const names[] = { "{", "}", "[", "]", "key", "str", "num", "bool", "null" };
+  EventLog& log = *(EventLog*)ctx;
+  int n;
+  if (tok.event == JSON_NUMBER) {
+    n = snprintf(log.text + log.len, sizeof(log.text) - log.len, "%u:num=%g ", tok.depth, tok.number);
+  } else if (tok.event == JSON_BOOL) {
+    n = snprintf(log.text + log.len, sizeof(log.text) - log.len, "%u:%s ", tok.depth, tok.boolean ? "true" : "false");
+  } else if (tok.event == JSON_KEY || tok.event == JSON_STRING) {
+    n = snprintf(log.text + log.len, sizeof(log.text) - log.len, "%u:%s=%s ", tok.depth, names[tok.event], tok.text);
+  } else {
+    n = snprintf(log.text + log.len, sizeof(log.text) - log.len, "%u:%s ", tok.depth, names[tok.event]);
+  }
+  if (n > 0 && log.len + n < sizeof(log.text)) log.len += n;
+  log.tokens++;
+  return !log.stopAfter || log.tokens < log.stopAfter;
+}
+
+static JsonStream js;
+static EventLog events;
+
+static bool parse(const char* json, uint32_t stopAfter = 0) {
+  memset(&events, 0, sizeof(events));
+  events.stopAfter = stopAfter;
+  jsonStreamBegin(js, logToken, &events);
+  return jsonStreamFeed(js, (const uint8_t*)json, strlen(json));
+}
+
+static const char* DOC =
+  "{\"obs\": [{\"temp\": 21.5, \"ok\": true, \"uv\": null, \"n\": -3e2}],\n"
+  " \"name\": \"Mission \\\"Bay\\\"\\n\", \"empty\": {}, \"list\": []}";
+
+static const char* DOC_EVENTS =
+  "0:{ 1:key=obs 1:[ 2:{ 3:key=temp 3:num=21.5 3:key=ok 3:true 3:key=uv 3:null 3:key=n 3:num=-300 "
+  "2:} 1:] 1:key=name 1:str=Mission \"Bay\"\n 1:key=empty 1:{ 1:} 1:key=list 1:[ 1:] 0:} ";
+
+void test_events_and_depths() {
+  TEST_ASSERT_TRUE(parse(DOC));
+  TEST_ASSERT_EQUAL_STRING(DOC_EVENTS, events.text);
+  TEST_ASSERT_TRUE(jsonStreamDone(js));
+  TEST_ASSERT_FALSE(jsonStreamFailed(js));
+}
+
+void test_split_at_every_byte() {
+  size_t len = strlen(DOC);
+  for (size_t split = 0; split <= len; split++) {
+    memset(&events, 0, sizeof(events));
+    jsonStreamBegin(js, logToken, &events);
+    TEST_ASSERT_TRUE(jsonStreamFeed(js, (const uint8_t*)DOC, split));
+    TEST_ASSERT_TRUE(jsonStreamFeed(js, (const uint8_t*)DOC + split, len - split));
+    TEST_ASSERT_EQUAL_STRING_MESSAGE(DOC_EVENTS, events.text, "split");
+    TEST_ASSERT_TRUE(jsonStreamDone(js));
+  }
+}
+
+void test_byte_at_a_time() {
+  memset(&events, 0, sizeof(events));
+  jsonStreamBegin(js, logToken, &events);
+  for (const char* p = DOC; *p; p++) TEST_ASSERT_TRUE(jsonStreamFeed(js, (const uint8_t*)p, 1));
+  TEST_ASSERT_EQUAL_STRING(DOC_EVENTS, events.text);
+}
+
+void test_unicode_escapes_become_a_placeholder() {
+  TEST_ASSERT_TRUE(parse("[\"Caf\\u00e9 \\u2014 \\/\\\\\"]"));
+  TEST_ASSERT_EQUAL_STRING("0:[ 1:str=Caf? ? /\\ 0:] ", events.text);
+}
+
+void test_long_strings_truncate() {
+  char json[160] = "[\"";
+  for (int i = 0; i < 100; i++) strcat(json, "x");
+  strcat(json, "\", 1]");
+  TEST_ASSERT_TRUE(parse(json));
+  char want[128] = "0:[ 1:str=";
+  for (size_t i = 0; i < JSON_TOKEN_MAX - 1; i++) strcat(want, "x");
+  strcat(want, " 1:num=1 0:] ");
+  TEST_ASSERT_EQUAL_STRING(want, events.text);
+}
+
+void test_malformed_input_fails() {
+  static const char* const bad[] = {
+    "{\"a\" 1}", "{\"a\":}", "[1,,2]", "{\"a\":1,}", "[1 2]", "{1:2}", "[}", "{]",
+    "[tru]", "[nul]", "[1.2.3]", "[-]", "{} x", "]", "[@]",
+  };
+  for (const char* json : bad) {
+    parse(json);
+    TEST_ASSERT_TRUE_MESSAGE(jsonStreamFailed(js), json);
+    TEST_ASSERT_FALSE(jsonStreamDone(js));
+  }
+}
+
+void test_incomplete_input_is_neither_done_nor_failed() {
+  TEST_ASSERT_TRUE(parse("{\"obs\": [1, 2"));
+  TEST_ASSERT_FALSE(jsonStreamDone(js));
+  TEST_ASSERT_FALSE(jsonStreamFailed(js));
+}
+
+void test_handler_can_stop_the_stream() {
+  TEST_ASSERT_FALSE(parse(DOC, 3));
+  TEST_ASSERT_EQUAL_UINT32(3, events.tokens);
+  TEST_ASSERT_FALSE(jsonStreamFailed(js));  // Stopped, not malformed
+  TEST_ASSERT_FALSE(jsonStreamFeed(js, (const uint8_t*)"]", 1));
+  TEST_ASSERT_EQUAL_UINT32(3, events.tokens);
+}
+
+void test_nesting_limit() {
+  char deep[JSON_MAX_DEPTH + 2];
+  memset(deep, '[', JSON_MAX_DEPTH);
+  deep[JSON_MAX_DEPTH] = '\0';
+  TEST_ASSERT_TRUE(parse(deep));
+  strcat(deep, "[");
+  TEST_ASSERT_FALSE(parse(deep));
+  TEST_ASSERT_TRUE(jsonStreamFailed(js));
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_events_and_depths);
+  RUN_TEST(test_split_at_every_byte);
+  RUN_TEST(test_byte_at_a_time);
+  RUN_TEST(test_unicode_escapes_become_a_placeholder);
+  RUN_TEST(test_long_strings_truncate);
+  RUN_TEST(test_malformed_input_fails);
+  RUN_TEST(test_incomplete_input_is_neither_done_nor_failed);
+  RUN_TEST(test_handler_can_stop_the_stream);
+  RUN_TEST(test_nesting_limit);
+  return UNITY_END();
+}
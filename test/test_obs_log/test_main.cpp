@@ -0,0 +1,130 @@
+#include <unity.h>
+#include <LittleFS.h>
+#include "obs_log.h"
+
+// 📜 The observation log when flash misbehaves (no mount, refused writes)
+// and across deep sleep
+
+void setUp() {
+  nativeFsFaults = {};
+}
+
+void tearDown() {}
+
+static uint32_t nextTs = 1700000000;
+
+static void appendMinutes(uint32_t n) {
+  for (uint32_t i = 0; i < n; i++) {
+    WeatherObs obs = {};
+    obs.status = FETCH_OK;
+    obs.timestamp = nextTs;
+    obs.temp_f = 60.0f;
+    obsLogAppend(obs);
+    nextTs += 60;
+  }
+}
+
+struct Seen {
+  uint32_t count;
+  uint32_t first;
+  uint32_t last;
+};
+
+static bool collect(const ObsRecord& rec, void* ctx) {
+  Seen& seen = *(Seen*)ctx;
+  if (seen.count++ == 0) seen.first = rec.timestamp;
+  seen.last = rec.timestamp;
+  return true;
+}
+
+static Seen everything() {
+  Seen seen = {};
+  obsLogRange(0, UINT32_MAX, -1, collect, &seen);
+  return seen;
+}
+
+void test_mount_failure_disables_logging() {
+  nativeFsFaults.mountFails = true;
+  TEST_ASSERT_FALSE(obsLogBegin());
+  appendMinutes(100);  // Far more than one batch
+  obsLogFlush();
+  obsLogTick();
+  TEST_ASSERT_EQUAL_UINT32(0, everything().count);
+  ObsRecord rec;
+  TEST_ASSERT_FALSE(obsLogLatest(0, rec));
+}
+
+void test_refused_writes_keep_the_newest_batch() {
+  TEST_ASSERT_TRUE(obsLogBegin());
+  nativeFsFaults.writesFail = true;
+  uint32_t start = nextTs;
+  appendMinutes(40);
+  Seen seen = everything();
+  TEST_ASSERT_EQUAL_UINT32(16, seen.count);                 // One batch, still in RAM
+  TEST_ASSERT_EQUAL_UINT32(start + 24 * 60, seen.first);    // The oldest 24 went
+  TEST_ASSERT_EQUAL_UINT32(start + 39 * 60, seen.last);
+}
+
+void test_batch_reaches_flash_once_writes_work() {
+  nativeFsFaults.writesFail = true;
+  uint32_t last = nextTs + 3 * 60;
+  appendMinutes(4);
+  nativeFsFaults.writesFail = false;
+  obsLogFlush();
+  TEST_ASSERT_TRUE(obsLogBegin());  // Rescan: only what's on flash
+  Seen seen = everything();
+  TEST_ASSERT_EQUAL_UINT32(16, seen.count);
+  TEST_ASSERT_EQUAL_UINT32(last, seen.last);
+}
+
+void test_sleep_keeps_a_young_batch_in_rtc() {
+  obsLogFlush();
+  uint32_t onFlash = everything().count;
+  appendMinutes(5);
+  ObsLogRtc saved;
+  obsLogSuspend(saved);
+  TEST_ASSERT_EQUAL_UINT8(5, saved.batchLen);  // Not written for one wake's reading
+
+  ObsLogRtc lost = {};
+  obsLogResume(lost);                          // RTC memory gone: flash only
+  TEST_ASSERT_TRUE(obsLogBegin());
+  TEST_ASSERT_EQUAL_UINT32(onFlash, everything().count);
+
+  obsLogResume(saved);
+  TEST_ASSERT_TRUE(obsLogBegin());
+  TEST_ASSERT_EQUAL_UINT32(onFlash + 5, everything().count);
+}
+
+void test_sleep_flushes_an_old_batch() {
+  appendMinutes(7);  // Twelve pending readings, eleven minutes apart end to end
+  uint32_t pending = everything().count;
+  ObsLogRtc saved;
+  obsLogSuspend(saved);
+  TEST_ASSERT_EQUAL_UINT8(0, saved.batchLen);
+
+  ObsLogRtc lost = {};
+  obsLogResume(lost);
+  TEST_ASSERT_TRUE(obsLogBegin());
+  TEST_ASSERT_EQUAL_UINT32(pending, everything().count);
+}
+
+void test_resume_rescans_when_the_index_is_stale() {
+  ObsLogRtc saved;
+  obsLogSuspend(saved);
+  uint32_t onFlash = everything().count;
+  saved.segs[saved.segCount - 1].seq += 100;   // A segment that isn't there
+  obsLogResume(saved);
+  TEST_ASSERT_TRUE(obsLogBegin());
+  TEST_ASSERT_EQUAL_UINT32(onFlash, everything().count);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_mount_failure_disables_logging);
+  RUN_TEST(test_refused_writes_keep_the_newest_batch);
+  RUN_TEST(test_batch_reaches_flash_once_writes_work);
+  RUN_TEST(test_sleep_keeps_a_young_batch_in_rtc);
+  RUN_TEST(test_sleep_flushes_an_old_batch);
+  RUN_TEST(test_resume_rescans_when_the_index_is_stale);
+  return UNITY_END();
+}
@@ -0,0 +1,131 @@
+#include <unity.h>
+#include <string.h>
+#include "sleep_cycle.h"
+
+// 🌙 The deep-sleep schedule: screen rotation, backoff and panel reuse
+
+static const SleepCycleConfig CFG = { 3, 60000, 15000, 15 * 60000 };
+static SleepCycle c;
+
+void setUp() {
+  c = {};
+  cycleWake(c, WAKE_COLD);
+}
+
+void tearDown() {}
+
+// One wake: outcome in, sleep length out
+static uint32_t wake(CycleOutcome outcome) {
+  cycleWake(c, WAKE_TIMER);
+  return cycleFinish(c, outcome, cycleShouldRender(c, outcome), CFG);
+}
+
+void test_cold_boot_resets_everything() {
+  c.screen = 2;
+  c.failStreak = 5;
+  c.panelHoldsFrame = true;
+  cycleWake(c, WAKE_COLD);
+  TEST_ASSERT_EQUAL_UINT8(0, c.screen);
+  TEST_ASSERT_EQUAL_UINT8(0, c.failStreak);
+  TEST_ASSERT_FALSE(cyclePanelRetained(c));
+  TEST_ASSERT_EQUAL_UINT32(1, c.wakeCount);
+}
+
+void test_timer_wake_with_garbage_rtc_resets() {
+  SleepCycle junk;
+  memset(&junk, 0xA5, sizeof(junk));
+  cycleWake(junk, WAKE_TIMER);
+  TEST_ASSERT_EQUAL_UINT8(0, junk.screen);
+  TEST_ASSERT_FALSE(cyclePanelRetained(junk));
+  TEST_ASSERT_EQUAL_UINT32(1, junk.wakeCount);
+}
+
+void test_good_refreshes_rotate_screens() {
+  TEST_ASSERT_EQUAL_UINT8(0, c.screen);
+  TEST_ASSERT_EQUAL_UINT32(60000, cycleFinish(c, OUTCOME_FRESH, true, CFG));
+  TEST_ASSERT_EQUAL_UINT8(1, c.screen);
+  TEST_ASSERT_EQUAL_UINT32(60000, wake(OUTCOME_UNCHANGED));
+  TEST_ASSERT_EQUAL_UINT8(2, c.screen);
+  wake(OUTCOME_FRESH);
+  TEST_ASSERT_EQUAL_UINT8(0, c.screen);
+  TEST_ASSERT_EQUAL_UINT32(3, c.wakeCount);  // The cold boot plus two timer wakes
+}
+
+void test_failures_back_off_and_hold_the_screen() {
+  cycleFinish(c, OUTCOME_FRESH, true, CFG);
+  static const uint32_t expect[] = { 15000, 30000, 60000, 120000, 240000, 480000, 900000, 900000 };
+  for (uint8_t i = 0; i < sizeof(expect) / sizeof(expect[0]); i++) {
+    TEST_ASSERT_EQUAL_UINT32(expect[i], wake(OUTCOME_FAILED));
+    TEST_ASSERT_EQUAL_UINT8(1, c.screen);
+  }
+}
+
+void test_backoff_stays_capped_on_long_outages() {
+  for (int i = 0; i < 100; i++) TEST_ASSERT_TRUE(wake(OUTCOME_FAILED) <= CFG.maxBackoffMs);
+  TEST_ASSERT_EQUAL_UINT8(16, c.failStreak);
+  TEST_ASSERT_EQUAL_UINT32(CFG.maxBackoffMs, wake(OUTCOME_FAILED));
+}
+
+void test_success_clears_the_backoff() {
+  wake(OUTCOME_FAILED);
+  wake(OUTCOME_FAILED);
+  TEST_ASSERT_EQUAL_UINT32(60000, wake(OUTCOME_FRESH));
+  TEST_ASSERT_EQUAL_UINT8(0, c.failStreak);
+  TEST_ASSERT_EQUAL_UINT32(15000, wake(OUTCOME_FAILED));
+}
+
+void test_fresh_readings_always_render() {
+  TEST_ASSERT_TRUE(cycleShouldRender(c, OUTCOME_FRESH));
+  cycleFinish(c, OUTCOME_FRESH, true, CFG);
+  c.screen = 0;  // Same screen as the frame in GRAM
+  TEST_ASSERT_TRUE(cycleShouldRender(c, OUTCOME_FRESH));
+}
+
+void test_unchanged_or_failed_skip_the_panel_when_it_shows_this_screen() {
+  TEST_ASSERT_TRUE(cycleShouldRender(c, OUTCOME_UNCHANGED));  // Nothing in GRAM yet
+  TEST_ASSERT_TRUE(cycleShouldRender(c, OUTCOME_FAILED));
+
+  SleepCycleConfig one = CFG;
+  one.screenCount = 1;
+  cycleFinish(c, OUTCOME_FRESH, true, one);
+  TEST_ASSERT_TRUE(cyclePanelRetained(c));
+  TEST_ASSERT_FALSE(cycleShouldRender(c, OUTCOME_UNCHANGED));
+  TEST_ASSERT_FALSE(cycleShouldRender(c, OUTCOME_FAILED));
+}
+
+void test_other_screen_in_gram_needs_a_render() {
+  cycleFinish(c, OUTCOME_FRESH, true, CFG);  // Screen 0 drawn, next is 1
+  TEST_ASSERT_TRUE(cycleShouldRender(c, OUTCOME_UNCHANGED));
+  TEST_ASSERT_TRUE(cycleShouldRender(c, OUTCOME_FAILED));
+}
+
+void test_skipped_render_keeps_the_old_frame() {
+  cycleFinish(c, OUTCOME_FRESH, true, CFG);
+  cycleWake(c, WAKE_TIMER);
+  cycleFinish(c, OUTCOME_FAILED, false, CFG);
+  TEST_ASSERT_TRUE(cyclePanelRetained(c));
+  TEST_ASSERT_EQUAL_UINT8(0, c.shownScreen);
+}
+
+void test_zero_screens_does_not_divide_by_zero() {
+  SleepCycleConfig none = CFG;
+  none.screenCount = 0;
+  TEST_ASSERT_EQUAL_UINT32(60000, cycleFinish(c, OUTCOME_FRESH, true, none));
+  TEST_ASSERT_EQUAL_UINT8(0, c.screen);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_cold_boot_resets_everything);
+  RUN_TEST(test_timer_wake_with_garbage_rtc_resets);
+  RUN_TEST(test_good_refreshes_rotate_screens);
+  RUN_TEST(test_failures_back_off_and_hold_the_screen);
+  RUN_TEST(test_backoff_stays_capped_on_long_outages);
+  RUN_TEST(test_success_clears_the_backoff);
+  RUN_TEST(test_fresh_readings_always_render);
+  RUN_TEST(test_unchanged_or_failed_skip_the_panel_when_it_shows_this_screen);
+  RUN_TEST(test_other_screen_in_gram_needs_a_render);
+  RUN_TEST(test_skipped_render_keeps_the_old_frame);
+  RUN_TEST(test_zero_screens_does_not_divide_by_zero);
+  return UNITY_END();
+}
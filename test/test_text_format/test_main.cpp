@@ -0,0 +1,136 @@
+#include <unity.h>
+#include <math.h>
+#include <string.h>
+#include "text_format.h"
+
+// 🔤 text_format: rounding, NaN, units, truncation and the compass names
+
+void setUp() {}
+void tearDown() {}
+
+static char buf[32];
+
+static const char* number(float v, uint8_t decimals, const char* unit = "") {
+  formatNumber(buf, sizeof(buf), v, decimals, unit);
+  return buf;
+}
+
+void test_number_rounds_half_away_from_zero() {
+  TEST_ASSERT_EQUAL_STRING("0.3", number(0.25f, 1));   // Exact halves in binary
+  TEST_ASSERT_EQUAL_STRING("-0.3", number(-0.25f, 1));
+  TEST_ASSERT_EQUAL_STRING("3", number(2.5f, 0));
+  TEST_ASSERT_EQUAL_STRING("-3", number(-2.5f, 0));
+  TEST_ASSERT_EQUAL_STRING("0.125", number(0.125f, 3));
+  TEST_ASSERT_EQUAL_STRING("1013", number(1012.5f, 0));
+  TEST_ASSERT_EQUAL_STRING("10.00", number(9.999f, 2));
+}
+
+void test_number_pads_decimals() {
+  TEST_ASSERT_EQUAL_STRING("5.0", number(5, 1));
+  TEST_ASSERT_EQUAL_STRING("0.05", number(0.05f, 2));
+  TEST_ASSERT_EQUAL_STRING("-0.5", number(-0.5f, 1));
+  TEST_ASSERT_EQUAL_STRING("7.000", number(7, 9));  // Capped at 3 places
+}
+
+void test_number_never_prints_negative_zero() {
+  TEST_ASSERT_EQUAL_STRING("0.0", number(-0.04f, 1));
+  TEST_ASSERT_EQUAL_STRING("0", number(-0.4f, 0));
+}
+
+void test_number_nan_and_out_of_range() {
+  TEST_ASSERT_EQUAL_STRING("-- F", number(NAN, 1, " F"));
+  TEST_ASSERT_EQUAL_STRING("--", number(INFINITY, 0));
+  TEST_ASSERT_EQUAL_STRING("--", number(3e9f, 0));
+  TEST_ASSERT_EQUAL_STRING("--", number(3e8f, 1));  // Scaled past int32
+}
+
+void test_units_follow_the_number() {
+  formatTemperature(buf, sizeof(buf), 72.44f);
+  TEST_ASSERT_EQUAL_STRING("72.4 F", buf);
+  formatSpeed(buf, sizeof(buf), 3.25f);
+  TEST_ASSERT_EQUAL_STRING("3.3 m/s", buf);
+  formatPressure(buf, sizeof(buf), 1013.18f);
+  TEST_ASSERT_EQUAL_STRING("1013.2 mb", buf);
+  formatPercent(buf, sizeof(buf), 44.6f);
+  TEST_ASSERT_EQUAL_STRING("45%", buf);
+  formatUnsigned(buf, sizeof(buf), 4294967295u, " B");
+  TEST_ASSERT_EQUAL_STRING("4294967295 B", buf);
+}
+
+void test_truncates_to_cap_and_returns_written_length() {
+  char small[5];
+  TEST_ASSERT_EQUAL_size_t(4, formatTemperature(small, sizeof(small), 72.4f));
+  TEST_ASSERT_EQUAL_STRING("72.4", small);
+  TEST_ASSERT_EQUAL_size_t(0, formatText(small, 1, "abc"));
+  TEST_ASSERT_EQUAL_STRING("", small);
+  TEST_ASSERT_EQUAL_size_t(0, formatText(small, 0, "abc"));  // No terminator slot, nothing written
+}
+
+void test_pieces_chain() {
+  size_t n = formatText(buf, sizeof(buf), "Hi ");
+  n += formatTemperature(buf + n, sizeof(buf) - n, 80.04f);
+  n += formatText(buf + n, sizeof(buf) - n, " / Lo ");
+  n += formatTemperature(buf + n, sizeof(buf) - n, 61.96f);
+  TEST_ASSERT_EQUAL_STRING("Hi 80.0 F / Lo 62.0 F", buf);
+  TEST_ASSERT_EQUAL_size_t(strlen(buf), n);
+}
+
+void test_wind_dir_sector_edges() {
+  TEST_ASSERT_EQUAL_STRING("N", windDirFromDegrees(0));
+  TEST_ASSERT_EQUAL_STRING("N", windDirFromDegrees(11.24f));
+  TEST_ASSERT_EQUAL_STRING("NNE", windDirFromDegrees(11.25f));
+  TEST_ASSERT_EQUAL_STRING("NE", windDirFromDegrees(45));
+  TEST_ASSERT_EQUAL_STRING("E", windDirFromDegrees(90));
+  TEST_ASSERT_EQUAL_STRING("S", windDirFromDegrees(180));
+  TEST_ASSERT_EQUAL_STRING("W", windDirFromDegrees(265));
+  TEST_ASSERT_EQUAL_STRING("NNW", windDirFromDegrees(348.74f));
+  TEST_ASSERT_EQUAL_STRING("N", windDirFromDegrees(348.75f));
+  TEST_ASSERT_EQUAL_STRING("N", windDirFromDegrees(359.9f));
+}
+
+void test_wind_dir_every_sector_center() {
+  static const char* const names[] = { "N", "NNE", "NE", "ENE", "E", "ESE", "SE", "SSE",
+                                       "S", "SSW", "SW", "WSW", "W", "WNW", "NW", "NNW" };
+  for (int i = 0; i < 16; i++) TEST_ASSERT_EQUAL_STRING(names[i], windDirFromDegrees(i * 22.5f));
+}
+
+void test_wind_dir_wraps_and_nan() {
+  TEST_ASSERT_EQUAL_STRING("N", windDirFromDegrees(360));
+  TEST_ASSERT_EQUAL_STRING("E", windDirFromDegrees(450));
+  TEST_ASSERT_EQUAL_STRING("W", windDirFromDegrees(-90));
+  TEST_ASSERT_EQUAL_STRING("NNW", windDirFromDegrees(-20));
+  TEST_ASSERT_EQUAL_STRING("--", windDirFromDegrees(NAN));
+}
+
+void test_clock_formats() {
+  formatHour12(buf, sizeof(buf), 0);
+  TEST_ASSERT_EQUAL_STRING("12a", buf);
+  formatHour12(buf, sizeof(buf), 12);
+  TEST_ASSERT_EQUAL_STRING("12p", buf);
+  formatHour12(buf, sizeof(buf), 15);
+  TEST_ASSERT_EQUAL_STRING("3p", buf);
+  formatClock(buf, sizeof(buf), 1700000000, 0);  // 22:13:20 UTC
+  TEST_ASSERT_EQUAL_STRING("10:13p", buf);
+  formatClock(buf, sizeof(buf), 1700000000, -8 * 3600);
+  TEST_ASSERT_EQUAL_STRING("2:13p", buf);
+  formatClock(buf, sizeof(buf), 1699920000 + 300, -8 * 3600);  // Previous local day, 4:05p
+  TEST_ASSERT_EQUAL_STRING("4:05p", buf);
+  formatClock(buf, sizeof(buf), 0, -3600);  // Before the epoch in local time
+  TEST_ASSERT_EQUAL_STRING("11:00p", buf);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_number_rounds_half_away_from_zero);
+  RUN_TEST(test_number_pads_decimals);
+  RUN_TEST(test_number_never_prints_negative_zero);
+  RUN_TEST(test_number_nan_and_out_of_range);
+  RUN_TEST(test_units_follow_the_number);
+  RUN_TEST(test_truncates_to_cap_and_returns_written_length);
+  RUN_TEST(test_pieces_chain);
+  RUN_TEST(test_wind_dir_sector_edges);
+  RUN_TEST(test_wind_dir_every_sector_center);
+  RUN_TEST(test_wind_dir_wraps_and_nan);
+  RUN_TEST(test_clock_formats);
+  return UNITY_END();
+}